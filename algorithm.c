@@ -1,12 +1,17 @@
 #include "algorithm.h"
-#include "dary_heap.h"
-#include "distance_map.h"
+#include "compressed_graph.h"
+#include "distance_bound.h"
+#include "frozen_graph.h"
 #include "graph.h"
-#include "parent_map.h"
+#include "index_heap.h"
+#include "radix_heap.h"
+#include "search_context.h"
 #include "util.h"
+#include "vertex_bitset.h"
 #include "vertex_list.h"
-#include "vertex_set.h"
+#include "weight_map.h"
 #include <float.h>
+#include <math.h>
 #include <stdlib.h>
 
 #define TRY_REPORT_RETURN_STATUS(RETURN_STATUS) \
@@ -14,280 +19,510 @@ if (p_return_status) {                          \
     *p_return_status = RETURN_STATUS;           \
 }
 
-#define CLEAN_SEARCH_STATE   search_state_free(&search_state_)
-#define CLEAN_SEARCH_STATE_2 search_state_2_free(&search_state_2_)
+/* The best vertex found so far at which the two search frontiers meet: */
+typedef struct meeting_point {
+    double best_path_length;
+    size_t touch_index;
+    int    touched;
+} meeting_point;
+
+/* Expands 'current_index' in the search space 'p_space'. 'forward' tells
+whether the children or the parents of 'current_index' are generated.
+'p_opposite_space' is NULL in unidirectional search: */
+typedef int (*expand_function)(search_context* p_search_context,
+                               void* p_graph,
+                               search_space* p_space,
+                               search_space* p_opposite_space,
+                               meeting_point* p_meeting_point,
+                               size_t current_index,
+                               int forward);
+
+/*******************************************************************************
+* The potential a goal-directed query adds to the priorities of one search     *
+* direction. With the lower bounds h(v, t) to the target and h(s, v) from the  *
+* source, the forward potential of 'v' is (h(v, t) - h(s, v)) / 2 and the      *
+* backward potential is its negation. These average potentials are consistent  *
+* in both directions at once, so the two searches run on the same reduced arc  *
+* weights and the usual stopping condition of the bidirectional search holds.  *
+*******************************************************************************/
+struct search_potential {
+    const distance_bound* p_bound;
+    size_t                source_index;
+    size_t                target_index;
+    double                factor; /* 0.5 forward, -0.5 backward. */
+};
+
+/* The number of compressed arcs decoded at a time: */
+#define COMPRESSED_ARC_BATCH 64
+
+/* Keys of the radix heap must stay below this value to be convertible: */
+static const double RADIX_KEY_LIMIT = (double) (((size_t) -1) >> 1);
+
+/* Converts 'priority' to a radix heap key. Returns FALSE if 'priority' is not
+a non-negative integer: */
+static int get_radix_key(double priority, size_t* p_key) {
+    if (!(priority >= 0.0 && priority < RADIX_KEY_LIMIT)) {
+        return FALSE;
+    }
+
+    *p_key = (size_t) priority;
+    return (double) *p_key == priority;
+}
 
-static const size_t INITIAL_MAP_CAPACITY = 1024;
-static const float LOAD_FACTOR = 1.3f;
-static const size_t DARY_HEAP_DEGREE = 4;
+/* Begin: open set operations, dispatched on the queue kind of the context. */
+static int open_add(search_context* p_search_context,
+                    search_space* p_space,
+                    size_t index,
+                    double priority) {
+    size_t key;
 
-typedef struct search_state {
-    dary_heap*     p_open_forward;
-    dary_heap*     p_open_backward;
-    vertex_set*    p_closed_forward;
-    vertex_set*    p_closed_backward;
-    distance_map*  p_distance_forward;
-    distance_map*  p_distance_backward;
-    parent_map*    p_parent_forward;
-    parent_map*    p_parent_backward;
-} search_state;
+    if (p_search_context->queue_kind == SEARCH_QUEUE_RADIX_HEAP) {
+        if (!get_radix_key(priority, &key)) {
+            return RETURN_STATUS_NON_INTEGER_WEIGHT;
+        }
 
-static void search_state_init(search_state* p_state) {
-    p_state->p_open_forward =
-            dary_heap_alloc(
-                    DARY_HEAP_DEGREE,
-                    INITIAL_MAP_CAPACITY,
-                    LOAD_FACTOR);
+        return radix_heap_add(p_space->p_radix_open, index, key);
+    }
 
-    p_state->p_open_backward =
-            dary_heap_alloc(
-                    DARY_HEAP_DEGREE,
-                    INITIAL_MAP_CAPACITY,
-                    LOAD_FACTOR);
+    return index_heap_add(p_space->p_open, index, priority);
+}
 
-    p_state->p_closed_forward =
-            vertex_set_alloc(
-                    INITIAL_MAP_CAPACITY,
-                    LOAD_FACTOR);
+static int open_decrease_key(search_context* p_search_context,
+                             search_space* p_space,
+                             size_t index,
+                             double priority) {
+    size_t key;
 
-    p_state->p_closed_backward =
-            vertex_set_alloc(
-                    INITIAL_MAP_CAPACITY,
-                    LOAD_FACTOR);
+    if (p_search_context->queue_kind == SEARCH_QUEUE_RADIX_HEAP) {
+        if (!get_radix_key(priority, &key)) {
+            return RETURN_STATUS_NON_INTEGER_WEIGHT;
+        }
 
-    p_state->p_distance_forward =
-            distance_map_alloc(
-                    INITIAL_MAP_CAPACITY,
-                    LOAD_FACTOR);
+        radix_heap_decrease_key(p_space->p_radix_open, index, key);
+        return RETURN_STATUS_OK;
+    }
 
-    p_state->p_distance_backward =
-            distance_map_alloc(
-                    INITIAL_MAP_CAPACITY,
-                    LOAD_FACTOR);
+    index_heap_decrease_key(p_space->p_open, index, priority);
+    return RETURN_STATUS_OK;
+}
 
-    p_state->p_parent_forward =
-            parent_map_alloc(
-                    INITIAL_MAP_CAPACITY,
-                    LOAD_FACTOR);
+static size_t open_extract_min(search_context* p_search_context,
+                               search_space* p_space) {
+    if (p_search_context->queue_kind == SEARCH_QUEUE_RADIX_HEAP) {
+        return radix_heap_extract_min(p_space->p_radix_open);
+    }
 
-    p_state->p_parent_backward =
-            parent_map_alloc(
-                    INITIAL_MAP_CAPACITY,
-                    LOAD_FACTOR);
+    return index_heap_extract_min(p_space->p_open);
 }
 
-static int search_state_ok(search_state* p_search_state) {
-    return p_search_state->p_open_forward &&
-           p_search_state->p_open_backward &&
-           p_search_state->p_closed_forward &&
-           p_search_state->p_closed_backward &&
-           p_search_state->p_distance_forward &&
-           p_search_state->p_distance_backward &&
-           p_search_state->p_parent_forward &&
-           p_search_state->p_parent_backward;
+static size_t open_min(search_context* p_search_context,
+                       search_space* p_space) {
+    if (p_search_context->queue_kind == SEARCH_QUEUE_RADIX_HEAP) {
+        return radix_heap_min(p_space->p_radix_open);
+    }
+
+    return index_heap_min(p_space->p_open);
 }
 
-static void search_state_free(search_state* p_search_state) {
-    if (p_search_state->p_open_forward) {
-        dary_heap_free(p_search_state->p_open_forward);
+static double open_min_priority(search_context* p_search_context,
+                                search_space* p_space) {
+    if (p_search_context->queue_kind == SEARCH_QUEUE_RADIX_HEAP) {
+        return (double) radix_heap_min_key(p_space->p_radix_open);
     }
 
-    if (p_search_state->p_open_backward) {
-        dary_heap_free(p_search_state->p_open_backward);
+    return index_heap_min_priority(p_space->p_open);
+}
+
+static size_t open_size(search_context* p_search_context,
+                        search_space* p_space) {
+    if (p_search_context->queue_kind == SEARCH_QUEUE_RADIX_HEAP) {
+        return radix_heap_size(p_space->p_radix_open);
     }
 
-    if (p_search_state->p_closed_forward) {
-        vertex_set_free(p_search_state->p_closed_forward);
+    return index_heap_size(p_space->p_open);
+}
+
+/* In lazy deletion mode, the open set may contain outdated entries of settled
+vertices. Drops such entries from the top of the open set, so that the
+minimum is a vertex that is still open: */
+static void open_skip_settled(search_context* p_search_context,
+                              search_space* p_space) {
+    if (!p_search_context->lazy_deletion) {
+        return;
     }
 
-    if (p_search_state->p_closed_backward) {
-        vertex_set_free(p_search_state->p_closed_backward);
+    while (open_size(p_search_context, p_space) > 0 &&
+           VERTEX_BITSET_CONTAINS(&p_space->settled,
+                                  open_min(p_search_context, p_space))) {
+        open_extract_min(p_search_context, p_space);
     }
+}
+/* End: open set operations. */
+
+/* Returns the potential of 'index' in the direction of 'p_potential': */
+static double get_potential(const struct search_potential* p_potential,
+                            size_t index) {
+    const distance_bound* p_bound = p_potential->p_bound;
+
+    return p_potential->factor *
+           (p_bound->function(p_bound->p_data,
+                              index,
+                              p_potential->target_index) -
+            p_bound->function(p_bound->p_data,
+                              p_potential->source_index,
+                              index));
+}
 
-    if (p_search_state->p_distance_forward) {
-        distance_map_free(p_search_state->p_distance_forward);
+/* Returns the open set priority of 'index' at the distance 'distance': */
+static double get_priority(search_space* p_space,
+                           size_t index,
+                           distance_t distance) {
+    if (!p_space->p_potential) {
+        return distance;
     }
 
-    if (p_search_state->p_distance_backward) {
-        distance_map_free(p_search_state->p_distance_backward);
+    return distance + get_potential(p_space->p_potential, index);
+}
+
+/* Puts the first vertex of a search into the search space: */
+static int open_initial_vertex(search_context* p_search_context,
+                               search_space* p_space,
+                               size_t index) {
+    int rs; /* return status */
+
+    if ((rs = open_add(p_search_context,
+                       p_space,
+                       index,
+                       get_priority(p_space, index, 0.0)))
+        != RETURN_STATUS_OK) {
+        return rs;
     }
 
-    if (p_search_state->p_parent_forward) {
-        parent_map_free(p_search_state->p_parent_forward);
+    p_space->records[index].distance = 0.0;
+    p_space->records[index].parent = index;
+    vertex_bitset_add(&p_space->reached, index);
+    return RETURN_STATUS_OK;
+}
+
+/* Marks that we know the shortest path to 'index': */
+static void close_vertex(search_space* p_space, size_t index) {
+    vertex_bitset_add(&p_space->settled, index);
+    p_space->settled_count++;
+}
+
+/* Relaxes the arc from 'current_index' to 'neighbor_index', whose tentative
+shortest path estimate via 'current_index' is 'tentative_length': */
+static int relax_arc(search_context* p_search_context,
+                     search_space* p_space,
+                     search_space* p_opposite_space,
+                     meeting_point* p_meeting_point,
+                     size_t current_index,
+                     size_t neighbor_index,
+                     distance_t tentative_length) {
+    search_record* p_record;
+    search_record* p_opposite_record;
+    double temporary_path_length;
+    double priority;
+    int rs; /* return status */
+
+    if (VERTEX_BITSET_CONTAINS(&p_space->settled, neighbor_index)) {
+        /* Once here, the shortest path to 'neighbor_index' is already known.
+        Omit it: */
+        return RETURN_STATUS_OK;
     }
 
-    if (p_search_state->p_parent_backward) {
-        parent_map_free(p_search_state->p_parent_backward);
+    p_record = &p_space->records[neighbor_index];
+
+    if (!VERTEX_BITSET_CONTAINS(&p_space->reached, neighbor_index)) {
+        /* Once here, we reached 'neighbor_index' for the first time! */
+        if ((rs = open_add(p_search_context,
+                           p_space,
+                           neighbor_index,
+                           get_priority(p_space,
+                                        neighbor_index,
+                                        tentative_length)))
+            != RETURN_STATUS_OK) {
+            return rs;
+        }
+
+        vertex_bitset_add(&p_space->reached, neighbor_index);
+    }
+    else if (p_record->distance > tentative_length) {
+        /* Once here, we can lower the shortest path estimate of
+        'neighbor_index'. In lazy deletion mode, the old entry stays in the
+        open set and is skipped once it surfaces: */
+        priority = get_priority(p_space, neighbor_index, tentative_length);
+
+        if ((rs = p_search_context->lazy_deletion ?
+                  open_add(p_search_context,
+                           p_space,
+                           neighbor_index,
+                           priority) :
+                  open_decrease_key(p_search_context,
+                                    p_space,
+                                    neighbor_index,
+                                    priority)) != RETURN_STATUS_OK) {
+            return rs;
+        }
+    }
+    else {
+        return RETURN_STATUS_OK;
     }
-}
-typedef struct search_state_2 {
-    dary_heap*     p_open;
-    vertex_set*    p_closed;
-    distance_map*  p_distance;
-    parent_map*    p_parent;
-} search_state_2;
 
-static void search_state_2_init(search_state_2* p_state) {
-    p_state->p_open =
-            dary_heap_alloc(
-                    DARY_HEAP_DEGREE,
-                    INITIAL_MAP_CAPACITY,
-                    LOAD_FACTOR);
+    p_record->distance = tentative_length;
+    p_record->parent = current_index;
 
-    p_state->p_closed =
-            vertex_set_alloc(
-                    INITIAL_MAP_CAPACITY,
-                    LOAD_FACTOR);
+    /* Checks whether we can find the meeting vertex: */
+    if (!p_opposite_space) {
+        return RETURN_STATUS_OK;
+    }
 
-    p_state->p_distance =
-            distance_map_alloc(
-                    INITIAL_MAP_CAPACITY,
-                    LOAD_FACTOR);
+    if (VERTEX_BITSET_CONTAINS(&p_opposite_space->settled, neighbor_index)) {
+        p_opposite_record = &p_opposite_space->records[neighbor_index];
+        temporary_path_length = tentative_length +
+                                p_opposite_record->distance;
+
+        /* Can we improve the cost of a shortest path via the meeting
+        point? */
+        if (p_meeting_point->best_path_length > temporary_path_length) {
+            p_meeting_point->best_path_length = temporary_path_length;
+            p_meeting_point->touch_index = neighbor_index;
+            p_meeting_point->touched = TRUE;
+        }
+    }
 
-    p_state->p_parent =
-            parent_map_alloc(
-                    INITIAL_MAP_CAPACITY,
-                    LOAD_FACTOR);
+    return RETURN_STATUS_OK;
 }
 
-static int search_state_2_ok(search_state_2* p_search_state) {
-    return p_search_state->p_open &&
-           p_search_state->p_closed &&
-           p_search_state->p_distance &&
-           p_search_state->p_parent;
+/* Expands 'current_index' over the weight maps of a 'Graph': */
+static int expand_graph_vertex(search_context* p_search_context,
+                               void* p_graph,
+                               search_space* p_space,
+                               search_space* p_opposite_space,
+                               meeting_point* p_meeting_point,
+                               size_t current_index,
+                               int forward) {
+    GraphVertex* p_graph_vertex =
+            ((Graph*) p_graph)->p_vertex_table[current_index];
+
+    distance_t current_distance = p_space->records[current_index].distance;
+    weight_t weight;
+    vertex_id_t neighbor_index;
+    int rs; /* return status */
+    weight_map_iterator iterator;
+
+    weight_map_iterator_init(&iterator,
+                             forward ? p_graph_vertex->p_children :
+                                       p_graph_vertex->p_parents);
+
+    while (weight_map_iterator_has_next(&iterator)) {
+        weight_map_iterator_visit(&iterator, &neighbor_index, &weight);
+        weight_map_iterator_next(&iterator);
+
+        if ((rs = relax_arc(p_search_context,
+                            p_space,
+                            p_opposite_space,
+                            p_meeting_point,
+                            current_index,
+                            neighbor_index,
+                            current_distance + weight))
+            != RETURN_STATUS_OK) {
+            return rs;
+        }
+    }
+
+    return RETURN_STATUS_OK;
 }
 
-void search_state_2_free(search_state_2* p_search_state) {
-    if (p_search_state->p_open) {
-        dary_heap_free(p_search_state->p_open);
-    }
+/* Expands 'current_index' over one of the CSR adjacency arrays of a frozen
+graph. Arcs are scanned contiguously, so no pointer chasing is involved: */
+static int expand_frozen_vertex(search_context* p_search_context,
+                                void* p_graph,
+                                search_space* p_space,
+                                search_space* p_opposite_space,
+                                meeting_point* p_meeting_point,
+                                size_t current_index,
+                                int forward) {
+    frozen_graph* p_frozen_graph = p_graph;
+    size_t*      offsets = forward ? p_frozen_graph->forward_offsets :
+                                     p_frozen_graph->backward_offsets;
+    vertex_id_t* heads   = forward ? p_frozen_graph->forward_heads :
+                                     p_frozen_graph->backward_heads;
+    weight_t*    weights = forward ? p_frozen_graph->forward_weights :
+                                     p_frozen_graph->backward_weights;
+
+    distance_t current_distance = p_space->records[current_index].distance;
+    size_t arc;
+    int rs; /* return status */
 
-    if (p_search_state->p_closed) {
-        vertex_set_free(p_search_state->p_closed);
+    for (arc = offsets[current_index];
+         arc < offsets[current_index + 1];
+         ++arc) {
+
+        if ((rs = relax_arc(p_search_context,
+                            p_space,
+                            p_opposite_space,
+                            p_meeting_point,
+                            current_index,
+                            heads[arc],
+                            current_distance + weights[arc]))
+            != RETURN_STATUS_OK) {
+            return rs;
+        }
     }
 
-    if (p_search_state->p_distance) {
-        distance_map_free(p_search_state->p_distance);
-    }
+    return RETURN_STATUS_OK;
+}
 
-    if (p_search_state->p_parent) {
-        parent_map_free(p_search_state->p_parent);
+/* Expands 'current_index' over the compressed adjacency of a compressed graph.
+The arcs are decoded in batches on the stack and relaxed from there: */
+static int expand_compressed_vertex(search_context* p_search_context,
+                                    void* p_graph,
+                                    search_space* p_space,
+                                    search_space* p_opposite_space,
+                                    meeting_point* p_meeting_point,
+                                    size_t current_index,
+                                    int forward) {
+    vertex_id_t heads[COMPRESSED_ARC_BATCH];
+    weight_t weights[COMPRESSED_ARC_BATCH];
+    distance_t current_distance = p_space->records[current_index].distance;
+    compressed_arc_iterator iterator;
+    size_t arc_count;
+    size_t arc;
+    int rs; /* return status */
+
+    compressed_arc_iterator_init(&iterator, p_graph, current_index, forward);
+
+    while ((arc_count = compressed_arc_iterator_decode(&iterator,
+                                                       heads,
+                                                       weights,
+                                                       COMPRESSED_ARC_BATCH))
+           > 0) {
+
+        for (arc = 0; arc < arc_count; ++arc) {
+            if ((rs = relax_arc(p_search_context,
+                                p_space,
+                                p_opposite_space,
+                                p_meeting_point,
+                                current_index,
+                                heads[arc],
+                                current_distance + weights[arc]))
+                != RETURN_STATUS_OK) {
+                return rs;
+            }
+        }
     }
+
+    return RETURN_STATUS_OK;
 }
 
 /* Constructs a shortest path after bidirectional search: */
-static vertex_list* traceback_path(size_t touch_vertex_id,
-                                   parent_map * parent_forward,
-                                   parent_map * parent_backward) {
+static vertex_list* traceback_path(size_t touch_index,
+                                   search_space* p_forward_space,
+                                   search_space* p_backward_space) {
 
     vertex_list* path = vertex_list_alloc(100);
     int rs; /* result status */
-    size_t vertex_id = touch_vertex_id;
-    size_t previous_vertex_id =
-            parent_map_get(parent_forward,
-                           touch_vertex_id);
+    size_t index = touch_index;
+    size_t previous_index;
+
+    if (!path) {
+        return NULL;
+    }
 
     do {
-        rs = vertex_list_push_front(path, vertex_id);
+        rs = vertex_list_push_front(path, index);
 
         if (rs != RETURN_STATUS_OK) {
             vertex_list_free(path);
             return NULL;
         }
 
-        previous_vertex_id = vertex_id;
-        vertex_id = parent_map_get(parent_forward, vertex_id);
-    } while (vertex_id != previous_vertex_id);
+        previous_index = index;
+        index = p_forward_space->records[index].parent;
+    } while (index != previous_index);
 
-    vertex_id = parent_map_get(parent_backward, touch_vertex_id);
-    previous_vertex_id = touch_vertex_id;
+    index = p_backward_space->records[touch_index].parent;
+    previous_index = touch_index;
 
-    while (vertex_id != previous_vertex_id) {
-        rs = vertex_list_push_back(path, vertex_id);
+    while (index != previous_index) {
+        rs = vertex_list_push_back(path, index);
 
         if (rs != RETURN_STATUS_OK) {
             vertex_list_free(path);
             return NULL;
         }
 
-        previous_vertex_id = vertex_id;
-        vertex_id = parent_map_get(parent_backward, vertex_id);
+        previous_index = index;
+        index = p_backward_space->records[index].parent;
     }
 
     return path;
 }
 
-/* Runs the bidirectional Dijkstra's algorithm: */
-vertex_list* find_shortest_path(Graph * p_graph,
-                                size_t source_vertex_id,
-                                size_t target_vertex_id,
-                                int* p_return_status) {
+/* Constructs the shortest path after unidirectional search: */
+static vertex_list* traceback_path_2(size_t target_index,
+                                     search_space* p_space) {
 
-    search_state search_state_;
-    double best_path_length = DBL_MAX;
-    double temporary_path_length;
-    double tentative_length;
-    double weight;
-    size_t* p_touch_vertex_id = NULL;
-    int rs; /* return status */
-    int updated;
-    size_t current_vertex_id;
-    size_t child_vertex_id;
-    size_t parent_vertex_id;
-    GraphVertex* p_graph_vertex;
-
-    vertex_list*    p_path;
-    dary_heap*      p_open_forward;
-    dary_heap*      p_open_backward;
-    vertex_set*     p_closed_forward;
-    vertex_set*     p_closed_backward;
-    distance_map*   p_distance_forward;
-    distance_map*   p_distance_backward;
-    parent_map*     p_parent_forward;
-    parent_map*     p_parent_backward;
-
-    weight_map_iterator* p_weight_map_children_iterator;
-    weight_map_iterator* p_weight_map_parents_iterator;
-
-    /* Begin: routine checks. */
-    if (!p_graph) {
-        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_GRAPH);
+    vertex_list* path = vertex_list_alloc(100);
+    int rs; /* result status */
+    size_t index = target_index;
+    size_t previous_index;
+
+    if (!path) {
         return NULL;
     }
 
-    rs = 0;
+    do {
+        rs = vertex_list_push_front(path, index);
 
-    if (!hasVertex(p_graph, source_vertex_id)) {
-        rs |= RETURN_STATUS_NO_SOURCE_VERTEX;
-    }
+        if (rs != RETURN_STATUS_OK) {
+            vertex_list_free(path);
+            return NULL;
+        }
 
-    if (!hasVertex(p_graph, target_vertex_id)) {
-        rs |= RETURN_STATUS_NO_TARGET_VERTEX;
-    }
+        previous_index = index;
+        index = p_space->records[index].parent;
+    } while (index != previous_index);
 
-    if (rs) {
-        CLEAN_SEARCH_STATE;
-        TRY_REPORT_RETURN_STATUS(rs);
-        return NULL;
-    }
-    /* End: routine checks. */
+    return path;
+}
+
+/* Runs the bidirectional Dijkstra's algorithm on dense vertex indices. The
+returned path consists of vertex indices: */
+static vertex_list* run_bidirectional_search(search_context* p_search_context,
+                                             void* p_graph,
+                                             expand_function expand,
+                                             size_t source_index,
+                                             size_t target_index,
+                                             int* p_return_status) {
+
+    search_space* p_forward_space = &p_search_context->forward;
+    search_space* p_backward_space = &p_search_context->backward;
+    search_space* p_space;
+    search_space* p_opposite_space;
+    meeting_point meeting;
+    double temporary_path_length;
+    size_t current_index;
+    int forward;
+    int rs; /* return status */
+    vertex_list* p_path;
 
     /*
     Handle a case where the source and target vertices are the same.
     Otherwise, the algorithm may return a cycle containing the
     source/target vertex.
      */
-    if (source_vertex_id == target_vertex_id) {
+    if (source_index == target_index) {
         p_path = vertex_list_alloc(1);
 
-        if (p_path) {
-            TRY_REPORT_RETURN_STATUS(RETURN_STATUS_OK);
-        } else {
+        if (!p_path) {
             TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
             return NULL;
         }
 
-        if ((rs = vertex_list_push_back(p_path, source_vertex_id)) != RETURN_STATUS_OK) {
+        if ((rs = vertex_list_push_back(p_path, source_index))
+            != RETURN_STATUS_OK) {
             vertex_list_free(p_path);
             TRY_REPORT_RETURN_STATUS(rs);
             return NULL;
@@ -297,643 +532,904 @@ vertex_list* find_shortest_path(Graph * p_graph,
         return p_path;
     }
 
-    /* Begin: create data structures. */
-    search_state_init(&search_state_);
+    meeting.best_path_length = DBL_MAX;
+    meeting.touch_index = 0;
+    meeting.touched = FALSE;
 
-    if (!search_state_ok(&search_state_)) {
-        CLEAN_SEARCH_STATE;
+    /* Begin: initialize the state: */
+    if (open_initial_vertex(p_search_context,
+                            p_forward_space,
+                            source_index) != RETURN_STATUS_OK ||
+        open_initial_vertex(p_search_context,
+                            p_backward_space,
+                            target_index) != RETURN_STATUS_OK) {
         TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
         return NULL;
     }
+    /* End: initialize the state. */
 
-    p_open_forward      = search_state_.p_open_forward;
-    p_open_backward     = search_state_.p_open_backward;
-    p_closed_forward    = search_state_.p_closed_forward;
-    p_closed_backward   = search_state_.p_closed_backward;
-    p_distance_forward  = search_state_.p_distance_forward;
-    p_distance_backward = search_state_.p_distance_backward;
-    p_parent_forward    = search_state_.p_parent_forward;
-    p_parent_backward   = search_state_.p_parent_backward;
+    /* Main loop: */
+    for (;;) {
+        open_skip_settled(p_search_context, p_forward_space);
+        open_skip_settled(p_search_context, p_backward_space);
 
-    /* Begin: initialize the state: */
-    if (dary_heap_add(p_open_forward,
-                      source_vertex_id,
-                      0.0) != RETURN_STATUS_OK) {
-        CLEAN_SEARCH_STATE;
-        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
-        return NULL;
-    }
+        if (open_size(p_search_context, p_forward_space) == 0 ||
+            open_size(p_search_context, p_backward_space) == 0) {
+            break;
+        }
 
-    if (dary_heap_add(p_open_backward,
-                      target_vertex_id,
-                      0.0) != RETURN_STATUS_OK) {
-        CLEAN_SEARCH_STATE;
-        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
-        return NULL;
-    }
+        if (meeting.touched) {
+            /* There is somewhere a vertex at which both the search
+            frontiers are meeting: */
+            temporary_path_length =
+                    open_min_priority(p_search_context, p_forward_space) +
+                    open_min_priority(p_search_context, p_backward_space);
 
-    if (distance_map_put(p_distance_forward,
-                         source_vertex_id,
-                         0.0) != RETURN_STATUS_OK) {
-        CLEAN_SEARCH_STATE;
-        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
-        return NULL;
+            /* In a goal-directed search, the potentials of the two
+            directions cancel out in this sum, so the condition holds as
+            is: */
+            if (temporary_path_length > meeting.best_path_length) {
+                /* Once here, we have a shortest path passing through
+                'meeting.touch_index'. */
+                break;
+            }
+        }
+
+        /* Choose the expansion direction. The smaller of the two search
+        frontiers will be selected:
+        */
+        forward = open_size(p_search_context, p_forward_space) +
+                  p_forward_space->settled_count
+                  <=
+                  open_size(p_search_context, p_backward_space) +
+                  p_backward_space->settled_count;
+
+        p_space          = forward ? p_forward_space : p_backward_space;
+        p_opposite_space = forward ? p_backward_space : p_forward_space;
+
+        current_index = open_extract_min(p_search_context, p_space);
+        close_vertex(p_space, current_index);
+
+        if ((rs = expand(p_search_context,
+                         p_graph,
+                         p_space,
+                         p_opposite_space,
+                         &meeting,
+                         current_index,
+                         forward)) != RETURN_STATUS_OK) {
+            TRY_REPORT_RETURN_STATUS(rs);
+            return NULL;
+        }
     }
 
-    if (distance_map_put(p_distance_backward,
-                         target_vertex_id,
-                         0.0) != RETURN_STATUS_OK) {
-        CLEAN_SEARCH_STATE;
-        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+    if (!meeting.touched) {
+        /* Once here, there is no path from the source vertex to
+        the target vertex: */
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_PATH);
         return NULL;
     }
 
-    if (parent_map_put(p_parent_forward,
-                       source_vertex_id,
-                       source_vertex_id) != RETURN_STATUS_OK) {
+    /* Once here, either the stopping condition holds or one of the search
+    frontiers is exhausted after the frontiers have met. In both cases the
+    best meeting vertex found so far is the optimal one: */
+    p_path = traceback_path(meeting.touch_index,
+                            p_forward_space,
+                            p_backward_space);
 
-        CLEAN_SEARCH_STATE;
+    if (p_path) {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_OK);
+    } else {
         TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
-        return NULL;
     }
 
-    if (parent_map_put(p_parent_backward,
-                       target_vertex_id,
-                       target_vertex_id) != RETURN_STATUS_OK) {
+    /* The path may be NULL, which implies that there were no sufficient
+    memory available for the path. */
+    return p_path;
+}
 
-        CLEAN_SEARCH_STATE;
-        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+/* Runs the traditional (unidirectional) Dijkstra's algorithm on dense vertex
+indices. The returned path consists of vertex indices: */
+static vertex_list* run_unidirectional_search(search_context* p_search_context,
+                                              void* p_graph,
+                                              expand_function expand,
+                                              size_t source_index,
+                                              size_t target_index,
+                                              int* p_return_status) {
+
+    search_space* p_space = &p_search_context->forward;
+    size_t current_index;
+    int rs; /* return status */
+    vertex_list* p_path;
+
+    if ((rs = open_initial_vertex(p_search_context,
+                                  p_space,
+                                  source_index)) != RETURN_STATUS_OK) {
+        TRY_REPORT_RETURN_STATUS(rs);
         return NULL;
     }
-    /* End: initialize the state. */
 
     /* Main loop: */
-    while (dary_heap_size(p_open_forward) > 0 &&
-           dary_heap_size(p_open_backward) > 0) {
+    while (open_size(p_search_context, p_space) > 0) {
+        current_index = open_extract_min(p_search_context, p_space);
 
-        if (p_touch_vertex_id) {
-            /* There is somewhere a vertex at which both the search
-            frontiers are meeting: */
-            temporary_path_length =
-                    distance_map_get(
-                            p_distance_forward,
-                            dary_heap_min(p_open_forward))
-                    +
-                    distance_map_get(
-                            p_distance_backward,
-                            dary_heap_min(p_open_backward));
-
-            if (temporary_path_length > best_path_length) {
-                /* Once here, we have a shortest path passing through
-                '*p_touch_vertex_id'.
-                '*/
-                p_path = traceback_path(*p_touch_vertex_id,
-                                        p_parent_forward,
-                                        p_parent_backward);
-
-                if (p_path) {
-                    TRY_REPORT_RETURN_STATUS(RETURN_STATUS_OK);
-                } else {
-                    TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
-                }
-
-                /* Clean up and return the path. The path may be NULL, which
-                implies that there were no sufficient memory available for
-                the path. */
-                CLEAN_SEARCH_STATE;
-                free(p_touch_vertex_id);
-                return p_path;
-            }
+        if (VERTEX_BITSET_CONTAINS(&p_space->settled, current_index)) {
+            /* Once here, 'current_index' is an outdated entry of a settled
+            vertex, which happens only in lazy deletion mode. Omit it: */
+            continue;
         }
 
-        /* Choose the expansion direction. The smaller of the two search
-        frontiers will be selected:
-        */
-        if (dary_heap_size(p_open_forward) +
-            vertex_set_size(p_closed_forward)
-            <=
-            dary_heap_size(p_open_backward) +
-            vertex_set_size(p_closed_backward)) {
-            /* Once here, we expanding the forward search frontier generating
-            the child vertices of the selected vertex: */
-
-            current_vertex_id = dary_heap_extract_min(p_open_forward);
-
-            /*  Mark that we know the shortest path to 'current_vertex_id': */
-            if ((rs = vertex_set_add(p_closed_forward, current_vertex_id)) !=
-                RETURN_STATUS_OK) {
-                CLEAN_SEARCH_STATE;
-                TRY_REPORT_RETURN_STATUS(rs);
-                return NULL;
-            }
-
-            p_graph_vertex =
-                    graph_vertex_map_get(p_graph->p_nodes,
-                                         current_vertex_id);
-
-            p_weight_map_children_iterator =
-                    weight_map_iterator_alloc(
-                            p_graph_vertex->p_children);
+        if (current_index == target_index) {
+            /* Once here, the search has reached the target vertex. */
+            p_path = traceback_path_2(target_index, p_space);
 
-            if (!p_weight_map_children_iterator) {
-                CLEAN_SEARCH_STATE;
+            if (p_path) {
+                TRY_REPORT_RETURN_STATUS(RETURN_STATUS_OK);
+            }
+            else {
                 TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
-
-                if (p_touch_vertex_id) {
-                    free(p_touch_vertex_id);
-                }
-
-                return NULL;
             }
 
-            /* Expand the 'current_vertex_id'. In other words,
-            iterate over all child nodes of 'current_vertex_id': */
-            while (weight_map_iterator_has_next(
-                    p_weight_map_children_iterator)) {
-
-                updated = 0;
-
-                weight_map_iterator_visit(p_weight_map_children_iterator,
-                                          &child_vertex_id,
-                                          &weight);
-
-                weight_map_iterator_next(p_weight_map_children_iterator);
-
-                if (vertex_set_contains(p_closed_forward, child_vertex_id)) {
-                    /* Once here, the shortest path to 'child_vertex_id' is already known.
-                    Omit it: */
-                    continue;
-                }
-
-                tentative_length = distance_map_get(p_distance_forward,
-                                                    current_vertex_id) +
-                                   weight;
-
-                if (!distance_map_contains_vertex_id(p_distance_forward,
-                                                     child_vertex_id)) {
-                    /* Once here, we reached 'child_vertex_id' for the first time! */
-                    /* Add to the forward priority queue: */
-                    if ((rs = dary_heap_add(
-                            p_open_forward,
-                            child_vertex_id,
-                            tentative_length)) != RETURN_STATUS_OK) {
-
-                        CLEAN_SEARCH_STATE;
-                        TRY_REPORT_RETURN_STATUS(rs);
-
-                        if (p_touch_vertex_id) {
-                            free(p_touch_vertex_id);
-                        }
-
-                        return NULL;
-                    }
-
-                    /* Mark that the distance and the parent maps should
-                    be updated: */
-                    updated = 1;
-                }
-                else if (distance_map_get(p_distance_forward, child_vertex_id) >
-                         tentative_length) {
-                    /* Once here, we are reaching the 'child_vertex_id' for not the first time,
-                    byt we can lower its shortest path estimate. For that reason, we lower
-                    that estimate: */
-                    dary_heap_decrease_key(
-                            p_open_forward,
-                            child_vertex_id,
-                            tentative_length);
-
-                    /* Mark that the distance and the parent maps should
-                    be updated: */
-                    updated = 1;
-                }
-
-                if (updated) {
-                    /* Once here, we need to update the shortest path estimate
-                    and the parent of the 'child_vertex_id':
-                    */
-                    if ((rs = distance_map_put(
-                            p_distance_forward,
-                            child_vertex_id,
-                            tentative_length)) != RETURN_STATUS_OK) {
-
-                        CLEAN_SEARCH_STATE;
-                        TRY_REPORT_RETURN_STATUS(rs);
-                        free(NULL);
-                        free(p_touch_vertex_id);
-                        return NULL;
-                    }
-
-                    if ((rs = parent_map_put(
-                            p_parent_forward,
-                            child_vertex_id,
-                            current_vertex_id)) != RETURN_STATUS_OK) {
-
-                        CLEAN_SEARCH_STATE;
-                        TRY_REPORT_RETURN_STATUS(rs);
-                        free(p_touch_vertex_id);
-                        return NULL;
-                    }
-
-                    /* Checks whether we can find the meeting vertex: */
-                    if (vertex_set_contains(p_closed_backward,
-                                            child_vertex_id)) {
-
-                        temporary_path_length =
-                                tentative_length +
-                                distance_map_get(p_distance_backward,
-                                                 child_vertex_id);
-
-                        /* Can we improve the cost of a shortest path via the
-                        meeting point?
-                        */
-                        if (best_path_length > temporary_path_length) {
-                            best_path_length = temporary_path_length;
-
-                            if (!p_touch_vertex_id) {
-                                p_touch_vertex_id = malloc(sizeof(size_t));
-                            }
-
-                            *p_touch_vertex_id = child_vertex_id;
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            /* Once here, we expand the backward search frontier generating
-            all the parents of the selected of the selected vertex:
-            */
-            current_vertex_id = dary_heap_extract_min(p_open_backward);
-            vertex_set_add(p_closed_backward, current_vertex_id);
-
-            p_graph_vertex =
-                    graph_vertex_map_get(p_graph->p_nodes,
-                                         current_vertex_id);
-
-            p_weight_map_parents_iterator =
-                    weight_map_iterator_alloc(
-                            p_graph_vertex->p_parents);
-
-            /* Expand the 'current_vertex_id' in backward direction generating
-            its parents: */
-            while (weight_map_iterator_has_next(
-                    p_weight_map_parents_iterator)) {
-
-                updated = 0;
-
-                weight_map_iterator_visit(
-                        p_weight_map_parents_iterator,
-                        &parent_vertex_id,
-                        &weight);
-
-                weight_map_iterator_next(p_weight_map_parents_iterator);
-
-                if (vertex_set_contains(p_closed_backward,
-                                        parent_vertex_id)) {
-                    /* Once here, the shortest distance to 'parent_vertex_id'
-                    is already known. Omit it!*/
-                    continue;
-                }
-
-                tentative_length = distance_map_get(p_distance_backward,
-                                                    current_vertex_id)
-                                   + weight;
-
-                if (!distance_map_contains_vertex_id(p_distance_backward,
-                                                     parent_vertex_id)) {
-                    /* Once here, 'parent_vertex_id' is reached for the
-                    first time. Add it to the backward search frontier: */
-                    if ((rs = dary_heap_add(
-                            p_open_backward,
-                            parent_vertex_id,
-                            tentative_length)) != RETURN_STATUS_OK) {
-
-                        CLEAN_SEARCH_STATE;
-                        TRY_REPORT_RETURN_STATUS(rs);
-                        free(p_touch_vertex_id);
-                        return NULL;
-                    }
-
-                    updated = 1;
-                }
-                else if (distance_map_get(p_distance_backward,
-                                          parent_vertex_id)
-                         >
-                         tentative_length) {
-                    /* Once here, we can improve the distance to
-                    'parent_vertex_id: */
-                    dary_heap_decrease_key(
-                            p_open_backward,
-                            parent_vertex_id,
-                            tentative_length);
-
-                    updated = 1;
-                }
-
-                if (updated) {
-                    /* Once here, we need to update the
-                    auxiliary info: */
-                    if ((rs = distance_map_put(
-                            p_distance_backward,
-                            parent_vertex_id,
-                            tentative_length)) != RETURN_STATUS_OK) {
-
-                        CLEAN_SEARCH_STATE;
-                        TRY_REPORT_RETURN_STATUS(rs);
-                        free(p_touch_vertex_id);
-                        return NULL;
-                    }
-
-                    if ((rs = parent_map_put(
-                            p_parent_backward,
-                            parent_vertex_id,
-                            current_vertex_id)) != RETURN_STATUS_OK) {
-
-                        CLEAN_SEARCH_STATE;
-                        TRY_REPORT_RETURN_STATUS(rs);
-                        free(p_touch_vertex_id);
-                        return NULL;
-                    }
-
-                    if (vertex_set_contains(p_closed_forward,
-                                            parent_vertex_id)) {
-                        /* Once here, there is a meeting vertex: */
-                        temporary_path_length =
-                                tentative_length +
-                                distance_map_get(p_distance_forward,
-                                                 parent_vertex_id);
-
-                        /* Possibly update the meeting vertex and the cost of the
-                        path passing through it: */
-                        if (best_path_length > temporary_path_length) {
-                            best_path_length = temporary_path_length;
-
-                            if (!p_touch_vertex_id) {
-                                p_touch_vertex_id = malloc(sizeof(size_t));
-                            }
-
-                            *p_touch_vertex_id = parent_vertex_id;
-                        }
-                    }
-                }
-            }
+            return p_path;
         }
-    }
 
-    if (p_touch_vertex_id) {
-        free(p_touch_vertex_id);
+        close_vertex(p_space, current_index);
+
+        if ((rs = expand(p_search_context,
+                         p_graph,
+                         p_space,
+                         NULL,
+                         NULL,
+                         current_index,
+                         TRUE)) != RETURN_STATUS_OK) {
+            TRY_REPORT_RETURN_STATUS(rs);
+            return NULL;
+        }
     }
 
-    /* Once here, there is no path from the source vertex to
-    the target vertex: */
-    CLEAN_SEARCH_STATE;
+    /* Once here, there is no path from the source vertex
+    to the target vertex:
+    */
     TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_PATH);
     return NULL;
 }
 
-/* Constructs the shortest path after unidirectional search: */
-static vertex_list* traceback_path_2(size_t target_vertex_id,
-                                     parent_map* parent) {
-
-    vertex_list* path = vertex_list_alloc(100);
-    int rs; /* result status */
-    size_t vertex_id = target_vertex_id;
-    size_t previous_vertex_id =
-            parent_map_get(parent,
-                           target_vertex_id);
-
-    do {
-        rs = vertex_list_push_front(path, vertex_id);
-
-        if (rs != RETURN_STATUS_OK) {
-            vertex_list_free(path);
+/* Runs the bidirectional A* search with the average potentials of 'p_bound'
+on dense vertex indices. A NULL 'p_bound' runs plain bidirectional Dijkstra.
+The returned path consists of vertex indices: */
+static vertex_list* run_goal_directed_search(search_context* p_search_context,
+                                             void* p_graph,
+                                             expand_function expand,
+                                             const distance_bound* p_bound,
+                                             size_t source_index,
+                                             size_t target_index,
+                                             int* p_return_status) {
+    struct search_potential forward_potential;
+    struct search_potential backward_potential;
+    int queue_kind = p_search_context->queue_kind;
+    vertex_list* p_path;
+
+    if (p_bound) {
+        if (p_bound->function(p_bound->p_data,
+                              source_index,
+                              target_index) >= HUGE_VAL) {
+            /* Once here, the bound itself proves there is no path: */
+            TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_PATH);
             return NULL;
         }
 
-        previous_vertex_id = vertex_id;
-        vertex_id = parent_map_get(parent, vertex_id);
-    } while (vertex_id != previous_vertex_id);
+        forward_potential.p_bound = p_bound;
+        forward_potential.source_index = source_index;
+        forward_potential.target_index = target_index;
+        forward_potential.factor = 0.5;
+        backward_potential = forward_potential;
+        backward_potential.factor = -0.5;
 
-    return path;
+        p_search_context->forward.p_potential = &forward_potential;
+        p_search_context->backward.p_potential = &backward_potential;
+
+        /* The potentials make the priorities fractional and possibly
+        negative, which only the d-ary heap accepts: */
+        p_search_context->queue_kind = SEARCH_QUEUE_DARY_HEAP;
+    }
+
+    p_path = run_bidirectional_search(p_search_context,
+                                      p_graph,
+                                      expand,
+                                      source_index,
+                                      target_index,
+                                      p_return_status);
+
+    p_search_context->forward.p_potential = NULL;
+    p_search_context->backward.p_potential = NULL;
+    p_search_context->queue_kind = queue_kind;
+    return p_path;
 }
 
-/* Runs the traditional (unidirectional) Dijkstra's algorithm: */
-vertex_list* find_shortest_path_2(Graph* p_graph,
-                                  size_t source_vertex_id,
-                                  size_t target_vertex_id,
-                                  int* p_return_status) {
+/* Replaces the vertex indices in 'p_path' with the actual vertex IDs: */
+static void map_graph_path_to_vertex_ids(vertex_list* p_path,
+                                         Graph* p_graph) {
+    size_t i;
 
-    search_state_2 search_state_2_;
-    size_t current_vertex_id;
-    size_t child_vertex_id;
-    double weight;
-    double tentative_length;
-    GraphVertex* p_graph_vertex;
-    int rs; /* return status */
-    int updated;
+    for (i = 0; i < vertex_list_size(p_path); ++i) {
+        vertex_list_set(p_path,
+                        i,
+                        p_graph->p_vertex_table[
+                                vertex_list_get(p_path, i)]->id);
+    }
+}
 
-    vertex_list*  p_path;
-    dary_heap*    p_open;
-    vertex_set*   p_closed;
-    distance_map* p_distance;
-    parent_map*   p_parent;
+/* Replaces the vertex indices in 'p_path' with the actual vertex IDs: */
+static void map_path_to_vertex_ids(vertex_list* p_path,
+                                   frozen_graph* p_frozen_graph) {
+    size_t i;
+
+    for (i = 0; i < vertex_list_size(p_path); ++i) {
+        vertex_list_set(p_path,
+                        i,
+                        frozen_graph_get_vertex_id(
+                                p_frozen_graph,
+                                vertex_list_get(p_path, i)));
+    }
+}
 
-    weight_map_iterator* p_weight_map_children_iterator;
+/* Replaces the vertex indices in 'p_path' with the IDs of a compressed
+graph: */
+static void map_compressed_path_to_vertex_ids(
+        vertex_list* p_path,
+        compressed_graph* p_compressed_graph) {
+    size_t i;
+
+    for (i = 0; i < vertex_list_size(p_path); ++i) {
+        vertex_list_set(p_path,
+                        i,
+                        compressed_graph_get_vertex_id(
+                                p_compressed_graph,
+                                vertex_list_get(p_path, i)));
+    }
+}
+
+/* Looks up the dense indices of the terminal vertices of a 'Graph' query and
+prepares the search context. Returns a nonzero status on failure: */
+static int prepare_graph_query(search_context* p_search_context,
+                               Graph* p_graph,
+                               vertex_id_t source_vertex_id,
+                               vertex_id_t target_vertex_id,
+                               size_t* p_source_index,
+                               size_t* p_target_index) {
+    GraphVertex* p_source_vertex;
+    GraphVertex* p_target_vertex;
+    int rs = 0; /* return status */
 
-    /* Begin: routing checks. */
     if (!p_graph) {
-        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_GRAPH);
-        return NULL;
+        return RETURN_STATUS_NO_GRAPH;
     }
 
-    rs = 0;
+    p_source_vertex = getVertex(p_graph, source_vertex_id);
+    p_target_vertex = getVertex(p_graph, target_vertex_id);
 
-    if (!hasVertex(p_graph, source_vertex_id)) {
+    if (!p_source_vertex) {
         rs |= RETURN_STATUS_NO_SOURCE_VERTEX;
     }
 
-    if (!hasVertex(p_graph, target_vertex_id)) {
+    if (!p_target_vertex) {
         rs |= RETURN_STATUS_NO_TARGET_VERTEX;
     }
 
     if (rs) {
-        CLEAN_SEARCH_STATE_2;
+        return rs;
+    }
+
+    *p_source_index = p_source_vertex->index;
+    *p_target_index = p_target_vertex->index;
+
+    return search_context_prepare(p_search_context,
+                                  p_graph->vertex_table_size);
+}
+
+/* Same as 'prepare_graph_query', but for frozen graphs: */
+static int prepare_frozen_query(search_context* p_search_context,
+                                frozen_graph* p_frozen_graph,
+                                vertex_id_t source_vertex_id,
+                                vertex_id_t target_vertex_id,
+                                size_t* p_source_index,
+                                size_t* p_target_index) {
+    int rs = 0; /* return status */
+
+    if (!p_frozen_graph) {
+        return RETURN_STATUS_NO_GRAPH;
+    }
+
+    if (!frozen_graph_get_index(p_frozen_graph,
+                                source_vertex_id,
+                                p_source_index)) {
+        rs |= RETURN_STATUS_NO_SOURCE_VERTEX;
+    }
+
+    if (!frozen_graph_get_index(p_frozen_graph,
+                                target_vertex_id,
+                                p_target_index)) {
+        rs |= RETURN_STATUS_NO_TARGET_VERTEX;
+    }
+
+    if (rs) {
+        return rs;
+    }
+
+    return search_context_prepare(p_search_context,
+                                  p_frozen_graph->vertex_count);
+}
+
+/* Same as 'prepare_graph_query', but for compressed graphs: */
+static int prepare_compressed_query(search_context* p_search_context,
+                                    compressed_graph* p_compressed_graph,
+                                    vertex_id_t source_vertex_id,
+                                    vertex_id_t target_vertex_id,
+                                    size_t* p_source_index,
+                                    size_t* p_target_index) {
+    int rs = 0; /* return status */
+
+    if (!p_compressed_graph) {
+        return RETURN_STATUS_NO_GRAPH;
+    }
+
+    if (!compressed_graph_get_index(p_compressed_graph,
+                                    source_vertex_id,
+                                    p_source_index)) {
+        rs |= RETURN_STATUS_NO_SOURCE_VERTEX;
+    }
+
+    if (!compressed_graph_get_index(p_compressed_graph,
+                                    target_vertex_id,
+                                    p_target_index)) {
+        rs |= RETURN_STATUS_NO_TARGET_VERTEX;
+    }
+
+    if (rs) {
+        return rs;
+    }
+
+    return search_context_prepare(p_search_context,
+                                  p_compressed_graph->vertex_count);
+}
+
+/* Runs the bidirectional Dijkstra's algorithm: */
+vertex_list* find_shortest_path_with_context(
+        search_context* p_search_context,
+        Graph* p_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+
+    size_t source_index = 0;
+    size_t target_index = 0;
+    int rs; /* return status */
+    vertex_list* p_path;
+
+    if ((rs = prepare_graph_query(p_search_context,
+                                  p_graph,
+                                  source_vertex_id,
+                                  target_vertex_id,
+                                  &source_index,
+                                  &target_index)) != RETURN_STATUS_OK) {
         TRY_REPORT_RETURN_STATUS(rs);
         return NULL;
     }
-    /* End: routine checks. */
 
-    search_state_2_init(&search_state_2_);
+    p_path = run_bidirectional_search(p_search_context,
+                                      p_graph,
+                                      expand_graph_vertex,
+                                      source_index,
+                                      target_index,
+                                      p_return_status);
+    if (p_path) {
+        map_graph_path_to_vertex_ids(p_path, p_graph);
+    }
 
-    if (!search_state_2_ok(&search_state_2_)) {
-        CLEAN_SEARCH_STATE_2;
-        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+    return p_path;
+}
+
+/* Runs the traditional (unidirectional) Dijkstra's algorithm: */
+vertex_list* find_shortest_path_2_with_context(
+        search_context* p_search_context,
+        Graph* p_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+
+    size_t source_index = 0;
+    size_t target_index = 0;
+    int rs; /* return status */
+    vertex_list* p_path;
+
+    if ((rs = prepare_graph_query(p_search_context,
+                                  p_graph,
+                                  source_vertex_id,
+                                  target_vertex_id,
+                                  &source_index,
+                                  &target_index)) != RETURN_STATUS_OK) {
+        TRY_REPORT_RETURN_STATUS(rs);
         return NULL;
     }
 
-    p_open     = search_state_2_.p_open;
-    p_closed   = search_state_2_.p_closed;
-    p_distance = search_state_2_.p_distance;
-    p_parent   = search_state_2_.p_parent;
+    p_path = run_unidirectional_search(p_search_context,
+                                       p_graph,
+                                       expand_graph_vertex,
+                                       source_index,
+                                       target_index,
+                                       p_return_status);
+    if (p_path) {
+        map_graph_path_to_vertex_ids(p_path, p_graph);
+    }
 
-    /* Begin: initialize the state: */
-    if ((rs = dary_heap_add(p_open,
-                            source_vertex_id,
-                            0.0)) != RETURN_STATUS_OK) {
-        CLEAN_SEARCH_STATE_2;
+    return p_path;
+}
+
+/* Runs the bidirectional Dijkstra's algorithm on a frozen graph: */
+vertex_list* find_shortest_path_frozen_with_context(
+        search_context* p_search_context,
+        frozen_graph* p_frozen_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+
+    size_t source_index = 0;
+    size_t target_index = 0;
+    int rs; /* return status */
+    vertex_list* p_path;
+
+    if ((rs = prepare_frozen_query(p_search_context,
+                                   p_frozen_graph,
+                                   source_vertex_id,
+                                   target_vertex_id,
+                                   &source_index,
+                                   &target_index)) != RETURN_STATUS_OK) {
         TRY_REPORT_RETURN_STATUS(rs);
         return NULL;
     }
 
-    if ((rs = distance_map_put(p_distance,
-                               source_vertex_id,
-                               0.0)) != RETURN_STATUS_OK) {
-        CLEAN_SEARCH_STATE_2;
+    p_path = run_bidirectional_search(p_search_context,
+                                      p_frozen_graph,
+                                      expand_frozen_vertex,
+                                      source_index,
+                                      target_index,
+                                      p_return_status);
+    if (p_path) {
+        map_path_to_vertex_ids(p_path, p_frozen_graph);
+    }
+
+    return p_path;
+}
+
+/* Runs the traditional (unidirectional) Dijkstra's algorithm on a frozen
+graph: */
+vertex_list* find_shortest_path_2_frozen_with_context(
+        search_context* p_search_context,
+        frozen_graph* p_frozen_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+
+    size_t source_index = 0;
+    size_t target_index = 0;
+    int rs; /* return status */
+    vertex_list* p_path;
+
+    if ((rs = prepare_frozen_query(p_search_context,
+                                   p_frozen_graph,
+                                   source_vertex_id,
+                                   target_vertex_id,
+                                   &source_index,
+                                   &target_index)) != RETURN_STATUS_OK) {
         TRY_REPORT_RETURN_STATUS(rs);
         return NULL;
     }
 
-    if ((rs = parent_map_put(p_parent,
-                             source_vertex_id,
-                             source_vertex_id)) != RETURN_STATUS_OK) {
+    p_path = run_unidirectional_search(p_search_context,
+                                       p_frozen_graph,
+                                       expand_frozen_vertex,
+                                       source_index,
+                                       target_index,
+                                       p_return_status);
+    if (p_path) {
+        map_path_to_vertex_ids(p_path, p_frozen_graph);
+    }
 
-        CLEAN_SEARCH_STATE_2;
+    return p_path;
+}
+
+/* Runs the bidirectional Dijkstra's algorithm on a compressed graph: */
+vertex_list* find_shortest_path_compressed_with_context(
+        search_context* p_search_context,
+        compressed_graph* p_compressed_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+
+    size_t source_index = 0;
+    size_t target_index = 0;
+    int rs; /* return status */
+    vertex_list* p_path;
+
+    if ((rs = prepare_compressed_query(p_search_context,
+                                       p_compressed_graph,
+                                       source_vertex_id,
+                                       target_vertex_id,
+                                       &source_index,
+                                       &target_index)) != RETURN_STATUS_OK) {
         TRY_REPORT_RETURN_STATUS(rs);
         return NULL;
     }
-    /* End: intitialize the state. */
 
-    /* Main loop: */
-    while (dary_heap_size(p_open) > 0) {
-        current_vertex_id = dary_heap_extract_min(p_open);
+    p_path = run_bidirectional_search(p_search_context,
+                                      p_compressed_graph,
+                                      expand_compressed_vertex,
+                                      source_index,
+                                      target_index,
+                                      p_return_status);
+    if (p_path) {
+        map_compressed_path_to_vertex_ids(p_path, p_compressed_graph);
+    }
 
-        if (current_vertex_id == target_vertex_id) {
-            /* Once here, the search has reached the target vertex. */
-            p_path = traceback_path_2(target_vertex_id, p_parent);
+    return p_path;
+}
 
-            CLEAN_SEARCH_STATE_2;
+/* Runs the traditional (unidirectional) Dijkstra's algorithm on a compressed
+graph: */
+vertex_list* find_shortest_path_2_compressed_with_context(
+        search_context* p_search_context,
+        compressed_graph* p_compressed_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+
+    size_t source_index = 0;
+    size_t target_index = 0;
+    int rs; /* return status */
+    vertex_list* p_path;
+
+    if ((rs = prepare_compressed_query(p_search_context,
+                                       p_compressed_graph,
+                                       source_vertex_id,
+                                       target_vertex_id,
+                                       &source_index,
+                                       &target_index)) != RETURN_STATUS_OK) {
+        TRY_REPORT_RETURN_STATUS(rs);
+        return NULL;
+    }
 
-            if (p_path) {
-                TRY_REPORT_RETURN_STATUS(RETURN_STATUS_OK);
-            }
-            else {
-                TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
-            }
+    p_path = run_unidirectional_search(p_search_context,
+                                       p_compressed_graph,
+                                       expand_compressed_vertex,
+                                       source_index,
+                                       target_index,
+                                       p_return_status);
+    if (p_path) {
+        map_compressed_path_to_vertex_ids(p_path, p_compressed_graph);
+    }
 
-            return p_path;
-        }
+    return p_path;
+}
 
-        if (vertex_set_contains(p_closed, current_vertex_id)) {
-            /* Once here, the shortest path distance to 'current_vertex_id'
-            is already known. Omit it.*/
-            continue;
-        }
+/* Runs the bidirectional A* search: */
+vertex_list* find_shortest_path_astar_with_context(
+        search_context* p_search_context,
+        Graph* p_graph,
+        const distance_bound* p_bound,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+
+    size_t source_index = 0;
+    size_t target_index = 0;
+    int rs; /* return status */
+    vertex_list* p_path;
+
+    if ((rs = prepare_graph_query(p_search_context,
+                                  p_graph,
+                                  source_vertex_id,
+                                  target_vertex_id,
+                                  &source_index,
+                                  &target_index)) != RETURN_STATUS_OK) {
+        TRY_REPORT_RETURN_STATUS(rs);
+        return NULL;
+    }
 
-        if ((rs = vertex_set_add(p_closed, current_vertex_id))
-            != RETURN_STATUS_OK) {
-            /* Mark 'current_vertex_id' as settled. */
-            CLEAN_SEARCH_STATE_2;
-            TRY_REPORT_RETURN_STATUS(rs);
-            return NULL;
-        }
+    p_path = run_goal_directed_search(p_search_context,
+                                      p_graph,
+                                      expand_graph_vertex,
+                                      p_bound,
+                                      source_index,
+                                      target_index,
+                                      p_return_status);
+    if (p_path) {
+        map_graph_path_to_vertex_ids(p_path, p_graph);
+    }
+
+    return p_path;
+}
+
+/* Runs the bidirectional A* search on a frozen graph: */
+vertex_list* find_shortest_path_astar_frozen_with_context(
+        search_context* p_search_context,
+        frozen_graph* p_frozen_graph,
+        const distance_bound* p_bound,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+
+    size_t source_index = 0;
+    size_t target_index = 0;
+    int rs; /* return status */
+    vertex_list* p_path;
+
+    if ((rs = prepare_frozen_query(p_search_context,
+                                   p_frozen_graph,
+                                   source_vertex_id,
+                                   target_vertex_id,
+                                   &source_index,
+                                   &target_index)) != RETURN_STATUS_OK) {
+        TRY_REPORT_RETURN_STATUS(rs);
+        return NULL;
+    }
 
-        p_graph_vertex =
-                graph_vertex_map_get(p_graph->p_nodes,
-                                     current_vertex_id);
+    p_path = run_goal_directed_search(p_search_context,
+                                      p_frozen_graph,
+                                      expand_frozen_vertex,
+                                      p_bound,
+                                      source_index,
+                                      target_index,
+                                      p_return_status);
+    if (p_path) {
+        map_path_to_vertex_ids(p_path, p_frozen_graph);
+    }
 
-        p_weight_map_children_iterator =
-                weight_map_iterator_alloc(
-                        p_graph_vertex->p_children);
+    return p_path;
+}
 
-        if (!p_weight_map_children_iterator) {
-            CLEAN_SEARCH_STATE_2;
-            TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
-            return NULL;
-        }
+/* Runs the bidirectional A* search on a compressed graph: */
+vertex_list* find_shortest_path_astar_compressed_with_context(
+        search_context* p_search_context,
+        compressed_graph* p_compressed_graph,
+        const distance_bound* p_bound,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+
+    size_t source_index = 0;
+    size_t target_index = 0;
+    int rs; /* return status */
+    vertex_list* p_path;
+
+    if ((rs = prepare_compressed_query(p_search_context,
+                                       p_compressed_graph,
+                                       source_vertex_id,
+                                       target_vertex_id,
+                                       &source_index,
+                                       &target_index)) != RETURN_STATUS_OK) {
+        TRY_REPORT_RETURN_STATUS(rs);
+        return NULL;
+    }
 
-        /* Iterate over all child vertices of the 'current_vertex_id': */
-        while (weight_map_iterator_has_next(
-                p_weight_map_children_iterator)) {
+    p_path = run_goal_directed_search(p_search_context,
+                                      p_compressed_graph,
+                                      expand_compressed_vertex,
+                                      p_bound,
+                                      source_index,
+                                      target_index,
+                                      p_return_status);
+    if (p_path) {
+        map_compressed_path_to_vertex_ids(p_path, p_compressed_graph);
+    }
 
-            updated = FALSE;
+    return p_path;
+}
 
-            weight_map_iterator_visit(p_weight_map_children_iterator,
-                                      &child_vertex_id,
-                                      &weight);
+vertex_list* find_shortest_path(Graph* p_graph,
+                                vertex_id_t source_vertex_id,
+                                vertex_id_t target_vertex_id,
+                                int* p_return_status) {
+    vertex_list* p_path;
+    search_context* p_search_context = search_context_alloc();
 
-            weight_map_iterator_next(p_weight_map_children_iterator);
+    if (!p_search_context) {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
 
-            if (vertex_set_contains(p_closed, child_vertex_id)) {
-                /* The shortest path distance to 'child_vertex_id' is already
-                known. Omit it. */
-                continue;
-            }
+    p_path = find_shortest_path_with_context(p_search_context,
+                                             p_graph,
+                                             source_vertex_id,
+                                             target_vertex_id,
+                                             p_return_status);
 
-            tentative_length = distance_map_get(p_distance,
-                                                current_vertex_id) +
-                               weight;
-
-            if (!distance_map_contains_vertex_id(p_distance,
-                                                 child_vertex_id)) {
-                /* Once here, 'child_vertex_id' is reached for the first
-                time. Add it to the search frontier: */
-                updated = TRUE;
-
-                if ((rs = dary_heap_add(
-                        p_open,
-                        child_vertex_id,
-                        tentative_length))
-                    != RETURN_STATUS_OK) {
-
-                    CLEAN_SEARCH_STATE_2;
-                    TRY_REPORT_RETURN_STATUS(rs);
-                    return NULL;
-                }
-            } else if (distance_map_get(p_distance, child_vertex_id) >
-                       tentative_length) {
-                /* Once here, we can improve the shortest path estimate to
-                'child_vertex_id':
-                */
-                updated = TRUE;
-
-                dary_heap_decrease_key(
-                        p_open,
-                        child_vertex_id,
-                        tentative_length);
-            }
+    search_context_free(p_search_context);
+    return p_path;
+}
 
-            if (updated) {
-                /* Once here, we need to update the state for the
-                'child_vertex_id':
-                */
-                if ((rs = distance_map_put(
-                        p_distance,
-                        child_vertex_id,
-                        tentative_length))
-                    != RETURN_STATUS_OK) {
-
-                    CLEAN_SEARCH_STATE_2;
-                    TRY_REPORT_RETURN_STATUS(rs);
-                    return NULL;
-                }
-
-                if ((rs = parent_map_put(
-                        p_parent,
-                        child_vertex_id,
-                        current_vertex_id))
-                    != RETURN_STATUS_OK) {
-                    CLEAN_SEARCH_STATE_2;
-                    TRY_REPORT_RETURN_STATUS(rs);
-                    return NULL;
-                }
-            }
-        }
+vertex_list* find_shortest_path_2(Graph* p_graph,
+                                  vertex_id_t source_vertex_id,
+                                  vertex_id_t target_vertex_id,
+                                  int* p_return_status) {
+    vertex_list* p_path;
+    search_context* p_search_context = search_context_alloc();
+
+    if (!p_search_context) {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
     }
 
-    /* Once here, there is no path from the source vertex
-    to the target vertex:
-    */
-    CLEAN_SEARCH_STATE_2;
-    TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_PATH);
-    return NULL;
+    p_path = find_shortest_path_2_with_context(p_search_context,
+                                               p_graph,
+                                               source_vertex_id,
+                                               target_vertex_id,
+                                               p_return_status);
+
+    search_context_free(p_search_context);
+    return p_path;
+}
+
+vertex_list* find_shortest_path_frozen(frozen_graph* p_frozen_graph,
+                                       vertex_id_t source_vertex_id,
+                                       vertex_id_t target_vertex_id,
+                                       int* p_return_status) {
+    vertex_list* p_path;
+    search_context* p_search_context = search_context_alloc();
+
+    if (!p_search_context) {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    p_path = find_shortest_path_frozen_with_context(p_search_context,
+                                                    p_frozen_graph,
+                                                    source_vertex_id,
+                                                    target_vertex_id,
+                                                    p_return_status);
+
+    search_context_free(p_search_context);
+    return p_path;
+}
+
+vertex_list* find_shortest_path_2_frozen(frozen_graph* p_frozen_graph,
+                                         vertex_id_t source_vertex_id,
+                                         vertex_id_t target_vertex_id,
+                                         int* p_return_status) {
+    vertex_list* p_path;
+    search_context* p_search_context = search_context_alloc();
+
+    if (!p_search_context) {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    p_path = find_shortest_path_2_frozen_with_context(p_search_context,
+                                                      p_frozen_graph,
+                                                      source_vertex_id,
+                                                      target_vertex_id,
+                                                      p_return_status);
+
+    search_context_free(p_search_context);
+    return p_path;
+}
+
+vertex_list* find_shortest_path_compressed(
+        compressed_graph* p_compressed_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+    vertex_list* p_path;
+    search_context* p_search_context = search_context_alloc();
+
+    if (!p_search_context) {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    p_path = find_shortest_path_compressed_with_context(p_search_context,
+                                                        p_compressed_graph,
+                                                        source_vertex_id,
+                                                        target_vertex_id,
+                                                        p_return_status);
+
+    search_context_free(p_search_context);
+    return p_path;
+}
+
+vertex_list* find_shortest_path_2_compressed(
+        compressed_graph* p_compressed_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+    vertex_list* p_path;
+    search_context* p_search_context = search_context_alloc();
+
+    if (!p_search_context) {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    p_path = find_shortest_path_2_compressed_with_context(p_search_context,
+                                                          p_compressed_graph,
+                                                          source_vertex_id,
+                                                          target_vertex_id,
+                                                          p_return_status);
+
+    search_context_free(p_search_context);
+    return p_path;
+}
+
+vertex_list* find_shortest_path_astar(
+        Graph* p_graph,
+        const distance_bound* p_bound,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+    vertex_list* p_path;
+    search_context* p_search_context = search_context_alloc();
+
+    if (!p_search_context) {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    p_path = find_shortest_path_astar_with_context(p_search_context,
+                                                   p_graph,
+                                                   p_bound,
+                                                   source_vertex_id,
+                                                   target_vertex_id,
+                                                   p_return_status);
+
+    search_context_free(p_search_context);
+    return p_path;
+}
+
+vertex_list* find_shortest_path_astar_frozen(
+        frozen_graph* p_frozen_graph,
+        const distance_bound* p_bound,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+    vertex_list* p_path;
+    search_context* p_search_context = search_context_alloc();
+
+    if (!p_search_context) {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    p_path = find_shortest_path_astar_frozen_with_context(p_search_context,
+                                                          p_frozen_graph,
+                                                          p_bound,
+                                                          source_vertex_id,
+                                                          target_vertex_id,
+                                                          p_return_status);
+
+    search_context_free(p_search_context);
+    return p_path;
+}
+
+vertex_list* find_shortest_path_astar_compressed(
+        compressed_graph* p_compressed_graph,
+        const distance_bound* p_bound,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status) {
+    vertex_list* p_path;
+    search_context* p_search_context = search_context_alloc();
+
+    if (!p_search_context) {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    p_path = find_shortest_path_astar_compressed_with_context(
+            p_search_context,
+            p_compressed_graph,
+            p_bound,
+            source_vertex_id,
+            target_vertex_id,
+            p_return_status);
+
+    search_context_free(p_search_context);
+    return p_path;
 }
@@ -1,17 +1,142 @@
 #ifndef COM_GITHUB_CODERODDE_PERL_ALGORITHM_H
 #define COM_GITHUB_CODERODDE_PERL_ALGORITHM_H
 
+#include "compressed_graph.h"
+#include "distance_bound.h"
+#include "frozen_graph.h"
 #include "graph.h"
+#include "search_context.h"
 #include "vertex_list.h"
 
 vertex_list* find_shortest_path(Graph* p_graph,
-                                size_t source_vertex_id,
-                                size_t target_vertex_id,
+                                vertex_id_t source_vertex_id,
+                                vertex_id_t target_vertex_id,
                                 int* p_return_status);
 
 vertex_list* find_shortest_path_2(Graph* p_graph,
-                                  size_t source_vertex_id,
-                                  size_t target_vertex_id,
+                                  vertex_id_t source_vertex_id,
+                                  vertex_id_t target_vertex_id,
                                   int* p_return_status);
 
+vertex_list* find_shortest_path_frozen(frozen_graph* p_frozen_graph,
+                                       vertex_id_t source_vertex_id,
+                                       vertex_id_t target_vertex_id,
+                                       int* p_return_status);
+
+vertex_list* find_shortest_path_2_frozen(frozen_graph* p_frozen_graph,
+                                         vertex_id_t source_vertex_id,
+                                         vertex_id_t target_vertex_id,
+                                         int* p_return_status);
+
+vertex_list* find_shortest_path_compressed(
+        compressed_graph* p_compressed_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status);
+
+vertex_list* find_shortest_path_2_compressed(
+        compressed_graph* p_compressed_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status);
+
+/*******************************************************************************
+* The '_with_context' variants run in a caller-owned search context, which may *
+* be reused across queries. The variants above allocate a context per query.   *
+*******************************************************************************/
+vertex_list* find_shortest_path_with_context(
+        search_context* p_search_context,
+        Graph* p_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status);
+
+vertex_list* find_shortest_path_2_with_context(
+        search_context* p_search_context,
+        Graph* p_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status);
+
+vertex_list* find_shortest_path_frozen_with_context(
+        search_context* p_search_context,
+        frozen_graph* p_frozen_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status);
+
+vertex_list* find_shortest_path_2_frozen_with_context(
+        search_context* p_search_context,
+        frozen_graph* p_frozen_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status);
+
+vertex_list* find_shortest_path_compressed_with_context(
+        search_context* p_search_context,
+        compressed_graph* p_compressed_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status);
+
+vertex_list* find_shortest_path_2_compressed_with_context(
+        search_context* p_search_context,
+        compressed_graph* p_compressed_graph,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status);
+
+/*******************************************************************************
+* The '_astar' variants run a goal-directed bidirectional A* search, which     *
+* offsets the priority of each vertex by an average potential computed from    *
+* the consistent lower bound 'p_bound', so that both searches head for each    *
+* other and settle far fewer vertices than bidirectional Dijkstra. The bound   *
+* takes the dense indices of the graph searched; see 'coordinate_bound' for    *
+* the geometric ones. A NULL bound runs plain bidirectional Dijkstra. These    *
+* searches always use the d-ary heap, whatever the queue kind of the context.  *
+*******************************************************************************/
+vertex_list* find_shortest_path_astar(Graph* p_graph,
+                                      const distance_bound* p_bound,
+                                      vertex_id_t source_vertex_id,
+                                      vertex_id_t target_vertex_id,
+                                      int* p_return_status);
+
+vertex_list* find_shortest_path_astar_frozen(
+        frozen_graph* p_frozen_graph,
+        const distance_bound* p_bound,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status);
+
+vertex_list* find_shortest_path_astar_compressed(
+        compressed_graph* p_compressed_graph,
+        const distance_bound* p_bound,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status);
+
+vertex_list* find_shortest_path_astar_with_context(
+        search_context* p_search_context,
+        Graph* p_graph,
+        const distance_bound* p_bound,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status);
+
+vertex_list* find_shortest_path_astar_frozen_with_context(
+        search_context* p_search_context,
+        frozen_graph* p_frozen_graph,
+        const distance_bound* p_bound,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status);
+
+vertex_list* find_shortest_path_astar_compressed_with_context(
+        search_context* p_search_context,
+        compressed_graph* p_compressed_graph,
+        const distance_bound* p_bound,
+        vertex_id_t source_vertex_id,
+        vertex_id_t target_vertex_id,
+        int* p_return_status);
+
 #endif /* COM_GITHUB_CODERODDE_PERL_ALGORITHM_H */
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "allocator.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* NULL while the standard library allocates: */
+static allocator* p_current_allocator = NULL;
+static allocator  current_allocator;
+
+void allocator_set(const allocator* p_allocator)
+{
+    if (!p_allocator)
+    {
+        p_current_allocator = NULL;
+        return;
+    }
+
+    current_allocator = *p_allocator;
+    p_current_allocator = &current_allocator;
+}
+
+void* allocator_malloc(size_t size)
+{
+    if (!p_current_allocator)
+    {
+        return malloc(size);
+    }
+
+    return p_current_allocator->malloc_function(
+            p_current_allocator->p_context,
+            size);
+}
+
+void* allocator_calloc(size_t count, size_t size)
+{
+    void* p_block;
+
+    /* The standard 'calloc' may skip clearing fresh pages: */
+    if (!p_current_allocator)
+    {
+        return calloc(count, size);
+    }
+
+    if (size != 0 && count > (size_t) -1 / size)
+    {
+        return NULL;
+    }
+
+    p_block = allocator_malloc(count * size);
+
+    if (p_block)
+    {
+        memset(p_block, 0, count * size);
+    }
+
+    return p_block;
+}
+
+void* allocator_realloc(void* p_block, size_t size)
+{
+    if (!p_current_allocator)
+    {
+        return realloc(p_block, size);
+    }
+
+    return p_current_allocator->realloc_function(
+            p_current_allocator->p_context,
+            p_block,
+            size);
+}
+
+void allocator_free(void* p_block)
+{
+    if (!p_current_allocator)
+    {
+        free(p_block);
+        return;
+    }
+
+    p_current_allocator->free_function(p_current_allocator->p_context,
+                                       p_block);
+}
@@ -0,0 +1,38 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_ALLOCATOR_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_ALLOCATOR_H
+
+#include <stdlib.h>
+
+/*******************************************************************************
+* The memory functions used by every module of the library. Each one gets the  *
+* 'p_context' of the allocator first, so that an embedding host can pass its   *
+* own heap, or a function that picks a pool per thread to avoid contention on  *
+* a shared heap. 'realloc_function' must behave like 'realloc', also when its  *
+* block is NULL, and 'free_function' must accept NULL. The library asks for    *
+* zeroed memory with 'malloc_function' followed by clearing the block.         *
+*******************************************************************************/
+typedef struct allocator {
+    void* (*malloc_function) (void* p_context, size_t size);
+    void* (*realloc_function)(void* p_context, void* p_block, size_t size);
+    void  (*free_function)   (void* p_context, void* p_block);
+    void*   p_context;
+} allocator;
+
+/*******************************************************************************
+* Makes the library allocate through 'p_allocator', which is copied, or        *
+* through the standard library again if 'p_allocator' is NULL. The allocator   *
+* may be changed only while the library holds no memory: a block must be       *
+* released by the allocator that handed it out. The setting is global and not  *
+* synchronized, so make it before any other thread uses the library.           *
+*******************************************************************************/
+void allocator_set(const allocator* p_allocator);
+
+void* allocator_malloc(size_t size);
+
+void* allocator_calloc(size_t count, size_t size);
+
+void* allocator_realloc(void* p_block, size_t size);
+
+void allocator_free(void* p_block);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_ALLOCATOR_H */
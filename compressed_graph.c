@@ -0,0 +1,486 @@
+#include "compressed_graph.h"
+#include "allocator.h"
+#include "frozen_graph.h"
+#include "types.h"
+#include "util.h"
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRY_REPORT_RETURN_STATUS(RETURN_STATUS) \
+if (p_return_status) {                          \
+    *p_return_status = RETURN_STATUS;           \
+}
+
+/* The most bytes a varint of a 'size_t' takes: */
+#define MAX_VARINT_SIZE ((sizeof(size_t) * CHAR_BIT + 6) / 7)
+
+/* The most bytes an arc takes, a gap followed by a weight: */
+#define MAX_ARC_SIZE (2 * MAX_VARINT_SIZE)
+
+typedef struct compressed_arc {
+    vertex_id_t head;
+    weight_t    weight;
+} compressed_arc;
+
+static int compare_arcs(const void* p_a, const void* p_b)
+{
+    vertex_id_t a = ((const compressed_arc*) p_a)->head;
+    vertex_id_t b = ((const compressed_arc*) p_b)->head;
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+static size_t put_varint(unsigned char* p_bytes, size_t value)
+{
+    size_t size = 0;
+
+    while (value >= 0x80)
+    {
+        p_bytes[size++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+
+    p_bytes[size++] = (unsigned char) value;
+    return size;
+}
+
+static size_t get_varint(const unsigned char** p_p_bytes)
+{
+    const unsigned char* p_bytes = *p_p_bytes;
+    size_t value = 0;
+    unsigned shift = 0;
+    unsigned char byte;
+
+    /* Most gaps fit in a byte: */
+    if (*p_bytes < 0x80)
+    {
+        *p_p_bytes = p_bytes + 1;
+        return *p_bytes;
+    }
+
+    do
+    {
+        byte = *p_bytes++;
+        value |= (size_t)(byte & 0x7F) << shift;
+        shift += 7;
+    }
+    while (byte & 0x80);
+
+    *p_p_bytes = p_bytes;
+    return value;
+}
+
+static size_t put_weight(unsigned char* p_bytes,
+                         weight_t weight,
+                         double weight_quantum)
+{
+    size_t quanta;
+
+    if (weight_quantum > 0.0)
+    {
+        /* Round up, so that a bound consistent for the exact weights stays
+        consistent for the stored ones, also if the division rounded down: */
+        quanta = (size_t) ceil(weight / weight_quantum);
+
+        if (quanta * weight_quantum < weight)
+        {
+            ++quanta;
+        }
+
+        return put_varint(p_bytes, quanta);
+    }
+
+#ifdef BIDIR_SEARCH_WEIGHT_UINT32
+    return put_varint(p_bytes, weight);
+#else
+    memcpy(p_bytes, &weight, sizeof(weight));
+    return sizeof(weight);
+#endif
+}
+
+static weight_t get_weight(const unsigned char** p_p_bytes,
+                           double weight_quantum)
+{
+#ifndef BIDIR_SEARCH_WEIGHT_UINT32
+    weight_t weight;
+#endif
+
+    if (weight_quantum > 0.0)
+    {
+        return (weight_t)(get_varint(p_p_bytes) * weight_quantum);
+    }
+
+#ifdef BIDIR_SEARCH_WEIGHT_UINT32
+    return (weight_t) get_varint(p_p_bytes);
+#else
+    /* The weights are not aligned in the byte stream: */
+    memcpy(&weight, *p_p_bytes, sizeof(weight));
+    *p_p_bytes += sizeof(weight);
+    return weight;
+#endif
+}
+
+/*******************************************************************************
+* Encodes the 'arc_count' arcs of the vertex 'index', sorted by head, into     *
+* 'p_bytes'. The first gap is zigzag-encoded, so that heads just below 'index' *
+* also get small codes. Returns the number of bytes written.                   *
+*******************************************************************************/
+static size_t encode_arcs(unsigned char* p_bytes,
+                          const compressed_arc* arcs,
+                          size_t arc_count,
+                          size_t index,
+                          double weight_quantum)
+{
+    size_t size = 0;
+    size_t previous_head = index;
+    size_t head;
+    size_t gap;
+    size_t i;
+
+    for (i = 0; i < arc_count; ++i)
+    {
+        head = arcs[i].head;
+
+        if (i > 0)
+        {
+            gap = head - previous_head;
+        }
+        else if (head >= index)
+        {
+            gap = (head - index) << 1;
+        }
+        else
+        {
+            gap = ((index - head) << 1) - 1;
+        }
+
+        size += put_varint(p_bytes + size, gap);
+        size += put_weight(p_bytes + size, arcs[i].weight, weight_quantum);
+        previous_head = head;
+    }
+
+    return size;
+}
+
+/*******************************************************************************
+* Compresses one direction of the CSR arrays of a frozen graph into            *
+* '*p_p_bytes', which is allocated here, and fills 'compressed_offsets'.       *
+* 'arcs' must have room for the largest adjacency list.                        *
+*******************************************************************************/
+static int compress_adjacency(size_t vertex_count,
+                              const size_t* offsets,
+                              const vertex_id_t* heads,
+                              const weight_t* weights,
+                              double weight_quantum,
+                              compressed_arc* arcs,
+                              size_t* compressed_offsets,
+                              unsigned char** p_p_bytes)
+{
+    /* Start from two bytes per arc and grow as needed: */
+    size_t capacity = 2 * offsets[vertex_count] + MAX_ARC_SIZE;
+    size_t size = 0;
+    size_t arc_count;
+    size_t i;
+    size_t j;
+    int sorted;
+    unsigned char* p_bytes = allocator_malloc(capacity);
+    unsigned char* p_new_bytes;
+
+    if (!p_bytes)
+    {
+        return FALSE;
+    }
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        arc_count = offsets[i + 1] - offsets[i];
+        sorted = TRUE;
+
+        for (j = 0; j < arc_count; ++j)
+        {
+            arcs[j].head = heads[offsets[i] + j];
+            arcs[j].weight = weights[offsets[i] + j];
+
+            if (j > 0 && arcs[j - 1].head > arcs[j].head)
+            {
+                sorted = FALSE;
+            }
+        }
+
+        if (!sorted)
+        {
+            qsort(arcs, arc_count, sizeof(compressed_arc), compare_arcs);
+        }
+
+        if (capacity - size < arc_count * MAX_ARC_SIZE)
+        {
+            capacity = 2 * capacity + arc_count * MAX_ARC_SIZE;
+            p_new_bytes = allocator_realloc(p_bytes, capacity);
+
+            if (!p_new_bytes)
+            {
+                allocator_free(p_bytes);
+                return FALSE;
+            }
+
+            p_bytes = p_new_bytes;
+        }
+
+        compressed_offsets[i] = size;
+        size += encode_arcs(p_bytes + size,
+                            arcs,
+                            arc_count,
+                            i,
+                            weight_quantum);
+    }
+
+    compressed_offsets[vertex_count] = size;
+
+    /* Give back the slack. If that fails, the old block is still valid: */
+    p_new_bytes = allocator_realloc(p_bytes, size + 1);
+    *p_p_bytes = p_new_bytes ? p_new_bytes : p_bytes;
+    return TRUE;
+}
+
+static size_t get_max_degree(const size_t* offsets, size_t vertex_count)
+{
+    size_t max_degree = 0;
+    size_t i;
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        if (max_degree < offsets[i + 1] - offsets[i])
+        {
+            max_degree = offsets[i + 1] - offsets[i];
+        }
+    }
+
+    return max_degree;
+}
+
+static vertex_id_t* copy_ids(const vertex_id_t* ids,
+                             size_t vertex_count,
+                             int* p_ok)
+{
+    vertex_id_t* copy;
+
+    if (!ids)
+    {
+        return NULL;
+    }
+
+    copy = allocator_malloc(sizeof(vertex_id_t) * (vertex_count + 1));
+
+    if (!copy)
+    {
+        *p_ok = FALSE;
+        return NULL;
+    }
+
+    memcpy(copy, ids, sizeof(vertex_id_t) * vertex_count);
+    return copy;
+}
+
+compressed_graph* frozen_graph_compress(frozen_graph* p_frozen_graph,
+                                        double weight_quantum,
+                                        int* p_return_status)
+{
+    compressed_graph* p_compressed_graph;
+    compressed_arc* arcs;
+    size_t vertex_count;
+    size_t max_degree;
+    int ok = TRUE;
+
+    if (!p_frozen_graph)
+    {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_GRAPH);
+        return NULL;
+    }
+
+    vertex_count = p_frozen_graph->vertex_count;
+    max_degree = get_max_degree(p_frozen_graph->forward_offsets,
+                                vertex_count);
+
+    if (max_degree < get_max_degree(p_frozen_graph->backward_offsets,
+                                    vertex_count))
+    {
+        max_degree = get_max_degree(p_frozen_graph->backward_offsets,
+                                    vertex_count);
+    }
+
+    p_compressed_graph = allocator_calloc(1, sizeof(*p_compressed_graph));
+    arcs = allocator_malloc(sizeof(compressed_arc) * (max_degree + 1));
+
+    if (!p_compressed_graph || !arcs)
+    {
+        allocator_free(p_compressed_graph);
+        allocator_free(arcs);
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    p_compressed_graph->vertex_count = vertex_count;
+    p_compressed_graph->edge_count = p_frozen_graph->edge_count;
+    p_compressed_graph->weight_quantum =
+            weight_quantum > 0.0 ? weight_quantum : 0.0;
+
+    p_compressed_graph->vertex_ids = copy_ids(p_frozen_graph->vertex_ids,
+                                              vertex_count,
+                                              &ok);
+
+    p_compressed_graph->sorted_indices =
+            copy_ids(p_frozen_graph->sorted_indices, vertex_count, &ok);
+
+    p_compressed_graph->forward_offsets =
+            allocator_malloc(sizeof(size_t) * (vertex_count + 1));
+
+    p_compressed_graph->backward_offsets =
+            allocator_malloc(sizeof(size_t) * (vertex_count + 1));
+
+    ok = ok &&
+         p_compressed_graph->forward_offsets &&
+         p_compressed_graph->backward_offsets &&
+         compress_adjacency(vertex_count,
+                            p_frozen_graph->forward_offsets,
+                            p_frozen_graph->forward_heads,
+                            p_frozen_graph->forward_weights,
+                            p_compressed_graph->weight_quantum,
+                            arcs,
+                            p_compressed_graph->forward_offsets,
+                            &p_compressed_graph->forward_arcs) &&
+         compress_adjacency(vertex_count,
+                            p_frozen_graph->backward_offsets,
+                            p_frozen_graph->backward_heads,
+                            p_frozen_graph->backward_weights,
+                            p_compressed_graph->weight_quantum,
+                            arcs,
+                            p_compressed_graph->backward_offsets,
+                            &p_compressed_graph->backward_arcs);
+
+    allocator_free(arcs);
+
+    if (!ok)
+    {
+        compressed_graph_free(p_compressed_graph);
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    TRY_REPORT_RETURN_STATUS(RETURN_STATUS_OK);
+    return p_compressed_graph;
+}
+
+void compressed_graph_free(compressed_graph* p_compressed_graph)
+{
+    if (!p_compressed_graph)
+    {
+        return;
+    }
+
+    allocator_free(p_compressed_graph->vertex_ids);
+    allocator_free(p_compressed_graph->sorted_indices);
+    allocator_free(p_compressed_graph->forward_offsets);
+    allocator_free(p_compressed_graph->forward_arcs);
+    allocator_free(p_compressed_graph->backward_offsets);
+    allocator_free(p_compressed_graph->backward_arcs);
+    allocator_free(p_compressed_graph);
+}
+
+size_t compressed_graph_size(compressed_graph* p_compressed_graph)
+{
+    size_t vertex_count = p_compressed_graph->vertex_count;
+    size_t size = sizeof(*p_compressed_graph) +
+                  2 * sizeof(size_t) * (vertex_count + 1) +
+                  p_compressed_graph->forward_offsets[vertex_count] +
+                  p_compressed_graph->backward_offsets[vertex_count];
+
+    if (p_compressed_graph->vertex_ids)
+    {
+        size += sizeof(vertex_id_t) * vertex_count;
+    }
+
+    if (p_compressed_graph->sorted_indices)
+    {
+        size += sizeof(vertex_id_t) * vertex_count;
+    }
+
+    return size;
+}
+
+int compressed_graph_get_index(compressed_graph* p_compressed_graph,
+                               vertex_id_t vertex_id,
+                               size_t* p_index)
+{
+    if (!p_compressed_graph)
+    {
+        return FALSE;
+    }
+
+    return frozen_graph_find_index(p_compressed_graph->vertex_ids,
+                                   p_compressed_graph->sorted_indices,
+                                   p_compressed_graph->vertex_count,
+                                   vertex_id,
+                                   p_index);
+}
+
+vertex_id_t compressed_graph_get_vertex_id(
+        compressed_graph* p_compressed_graph,
+        size_t index)
+{
+    return p_compressed_graph->vertex_ids ?
+           p_compressed_graph->vertex_ids[index] :
+           (vertex_id_t) index;
+}
+
+void compressed_arc_iterator_init(compressed_arc_iterator* p_iterator,
+                                  compressed_graph* p_compressed_graph,
+                                  size_t index,
+                                  int forward)
+{
+    size_t* offsets = forward ? p_compressed_graph->forward_offsets :
+                                p_compressed_graph->backward_offsets;
+    unsigned char* p_bytes = forward ? p_compressed_graph->forward_arcs :
+                                       p_compressed_graph->backward_arcs;
+
+    p_iterator->p_next = p_bytes + offsets[index];
+    p_iterator->p_end = p_bytes + offsets[index + 1];
+    p_iterator->previous_head = index;
+    p_iterator->first = TRUE;
+    p_iterator->weight_quantum = p_compressed_graph->weight_quantum;
+}
+
+size_t compressed_arc_iterator_decode(compressed_arc_iterator* p_iterator,
+                                      vertex_id_t* heads,
+                                      weight_t* weights,
+                                      size_t capacity)
+{
+    const unsigned char* p_next = p_iterator->p_next;
+    const unsigned char* p_end = p_iterator->p_end;
+    double weight_quantum = p_iterator->weight_quantum;
+    size_t head = p_iterator->previous_head;
+    size_t gap;
+    size_t count = 0;
+
+    if (p_iterator->first && capacity > 0 && p_next < p_end)
+    {
+        gap = get_varint(&p_next);
+        head = (gap & 1) ? head - (gap >> 1) - 1 : head + (gap >> 1);
+        heads[count] = (vertex_id_t) head;
+        weights[count] = get_weight(&p_next, weight_quantum);
+        count++;
+        p_iterator->first = FALSE;
+    }
+
+    while (count < capacity && p_next < p_end)
+    {
+        head += get_varint(&p_next);
+        heads[count] = (vertex_id_t) head;
+        weights[count] = get_weight(&p_next, weight_quantum);
+        count++;
+    }
+
+    p_iterator->p_next = p_next;
+    p_iterator->previous_head = head;
+    return count;
+}
@@ -0,0 +1,85 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_COMPRESSED_GRAPH_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_COMPRESSED_GRAPH_H
+
+#include "frozen_graph.h"
+#include "types.h"
+#include <stdlib.h>
+
+/*******************************************************************************
+* A frozen graph whose adjacency lists are compressed for graphs that do not   *
+* fit in memory otherwise. The arcs of the vertex with index 'i' occupy the    *
+* bytes [forward_offsets[i], forward_offsets[i + 1]) of 'forward_arcs', and    *
+* its in-arcs likewise in the backward arrays. Each list is sorted by head,    *
+* and every arc is stored as the gap to the previous head, followed by the     *
+* weight; the first gap is taken from 'i' and may be negative, which makes it  *
+* small after the graph has been reordered. The gaps are LEB128 varints: seven *
+* bits per byte, the high bit telling that another byte follows. The weights   *
+* are stored as they are, or, if 'weight_quantum' is not zero, as varints      *
+* counting multiples of 'weight_quantum'. Integer weights are always stored    *
+* as varints. The vertex IDs are mapped like in a frozen graph.                *
+*******************************************************************************/
+typedef struct compressed_graph {
+    size_t         vertex_count;
+    size_t         edge_count;
+    vertex_id_t*   vertex_ids;       /* NULL if each ID equals its index. */
+    vertex_id_t*   sorted_indices;   /* NULL if 'vertex_ids' is sorted. */
+    size_t*        forward_offsets;  /* Byte offsets into 'forward_arcs'. */
+    unsigned char* forward_arcs;
+    size_t*        backward_offsets; /* Byte offsets into 'backward_arcs'. */
+    unsigned char* backward_arcs;
+    double         weight_quantum;   /* Zero if the weights are exact. */
+} compressed_graph;
+
+/* Decodes the arcs of one adjacency list a batch at a time: */
+typedef struct compressed_arc_iterator {
+    const unsigned char* p_next;
+    const unsigned char* p_end;
+    size_t               previous_head;
+    int                  first;
+    double               weight_quantum;
+} compressed_arc_iterator;
+
+/*******************************************************************************
+* Compresses 'p_frozen_graph'. If 'weight_quantum' is positive, each weight is *
+* rounded up to a multiple of it, so that the path lengths found in the        *
+* compressed graph may exceed the exact ones by less than 'weight_quantum' per *
+* arc. Since no weight shrinks, the bounds stay consistent. Returns            *
+* NULL on failure, storing RETURN_STATUS_NO_GRAPH or RETURN_STATUS_NO_MEMORY   *
+* in '*p_return_status' if it is not NULL.                                     *
+*******************************************************************************/
+compressed_graph* frozen_graph_compress(frozen_graph* p_frozen_graph,
+                                        double weight_quantum,
+                                        int* p_return_status);
+
+void compressed_graph_free(compressed_graph* p_compressed_graph);
+
+/* The bytes taken by the arrays of the graph: */
+size_t compressed_graph_size(compressed_graph* p_compressed_graph);
+
+int compressed_graph_get_index(compressed_graph* p_compressed_graph,
+                               vertex_id_t vertex_id,
+                               size_t* p_index);
+
+vertex_id_t compressed_graph_get_vertex_id(
+        compressed_graph* p_compressed_graph,
+        size_t index);
+
+/*******************************************************************************
+* Starts decoding the out-arcs of the vertex 'index' if 'forward' is set, and  *
+* its in-arcs otherwise.                                                       *
+*******************************************************************************/
+void compressed_arc_iterator_init(compressed_arc_iterator* p_iterator,
+                                  compressed_graph* p_compressed_graph,
+                                  size_t index,
+                                  int forward);
+
+/*******************************************************************************
+* Decodes up to 'capacity' of the remaining arcs into 'heads' and 'weights'    *
+* and returns their number, which is zero once the list is exhausted.          *
+*******************************************************************************/
+size_t compressed_arc_iterator_decode(compressed_arc_iterator* p_iterator,
+                                      vertex_id_t* heads,
+                                      weight_t* weights,
+                                      size_t capacity);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_COMPRESSED_GRAPH_H */
@@ -0,0 +1,70 @@
+#include "distance_bound.h"
+#include <math.h>
+#include <stdlib.h>
+
+/* The mean radius of the Earth in meters: */
+static const double EARTH_RADIUS = 6371008.8;
+
+static const double RADIANS_PER_DEGREE = 3.14159265358979323846 / 180.0;
+
+static double euclidean_distance_bound(const void* p_data,
+                                       size_t from_index,
+                                       size_t to_index)
+{
+    const coordinate_bound* p_coordinate_bound = p_data;
+    const double* coordinates = p_coordinate_bound->coordinates;
+    double dx = coordinates[2 * to_index] - coordinates[2 * from_index];
+    double dy = coordinates[2 * to_index + 1] -
+                coordinates[2 * from_index + 1];
+
+    return p_coordinate_bound->scale * sqrt(dx * dx + dy * dy);
+}
+
+static double haversine_distance_bound(const void* p_data,
+                                       size_t from_index,
+                                       size_t to_index)
+{
+    const coordinate_bound* p_coordinate_bound = p_data;
+    const double* coordinates = p_coordinate_bound->coordinates;
+    double latitude_1 = coordinates[2 * from_index + 1] * RADIANS_PER_DEGREE;
+    double latitude_2 = coordinates[2 * to_index + 1] * RADIANS_PER_DEGREE;
+    double sin_half_dlatitude = sin((latitude_2 - latitude_1) / 2.0);
+    double sin_half_dlongitude = sin((coordinates[2 * to_index] -
+                                      coordinates[2 * from_index]) *
+                                     RADIANS_PER_DEGREE / 2.0);
+    double a = sin_half_dlatitude * sin_half_dlatitude +
+               cos(latitude_1) * cos(latitude_2) *
+               sin_half_dlongitude * sin_half_dlongitude;
+
+    /* Rounding may push 'a' slightly above 1 for antipodal points: */
+    if (a > 1.0)
+    {
+        a = 1.0;
+    }
+
+    return p_coordinate_bound->scale * 2.0 * EARTH_RADIUS * asin(sqrt(a));
+}
+
+void coordinate_bound_init(coordinate_bound* p_coordinate_bound,
+                           int kind,
+                           const double* coordinates,
+                           double scale)
+{
+    switch (kind)
+    {
+        case DISTANCE_BOUND_EUCLIDEAN:
+            p_coordinate_bound->bound.function = euclidean_distance_bound;
+            break;
+
+        case DISTANCE_BOUND_HAVERSINE:
+            p_coordinate_bound->bound.function = haversine_distance_bound;
+            break;
+
+        default:
+            abort();
+    }
+
+    p_coordinate_bound->bound.p_data = p_coordinate_bound;
+    p_coordinate_bound->coordinates = coordinates;
+    p_coordinate_bound->scale = scale;
+}
@@ -0,0 +1,60 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_DISTANCE_BOUND_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_DISTANCE_BOUND_H
+
+#include <stdlib.h>
+
+/*******************************************************************************
+* A lower bound on the length of any path from the vertex with the dense index *
+* 'from_index' to the vertex with the index 'to_index', used by the            *
+* goal-directed searches. The bound must be consistent: for every arc (u, v)   *
+* of weight w and every vertex x, bound(u, x) <= w + bound(v, x) and           *
+* bound(x, v) <= bound(x, u) + w. Otherwise the searches may return paths that *
+* are not the shortest. A bound that is zero everywhere is consistent and      *
+* turns the goal-directed searches into plain bidirectional Dijkstra. A bound  *
+* of HUGE_VAL states that there is no path at all; the searches then leave     *
+* the vertices that cannot reach the target for last, and give up at once if   *
+* the source is one of them.                                                   *
+*******************************************************************************/
+typedef double (*distance_bound_function)(const void* p_data,
+                                          size_t from_index,
+                                          size_t to_index);
+
+typedef struct distance_bound {
+    distance_bound_function function;
+    const void*             p_data;
+} distance_bound;
+
+/*******************************************************************************
+* The geometric bounds of 'coordinate_bound':                                  *
+*   DISTANCE_BOUND_EUCLIDEAN - the straight-line distance between two points   *
+*                              of the plane.                                   *
+*   DISTANCE_BOUND_HAVERSINE - the great-circle distance in meters between two *
+*                              points of the Earth, given as the longitude and *
+*                              the latitude in degrees.                        *
+*******************************************************************************/
+#define DISTANCE_BOUND_EUCLIDEAN 0
+#define DISTANCE_BOUND_HAVERSINE 1
+
+/*******************************************************************************
+* A bound computed from the positions of the vertices. 'coordinates' holds the *
+* x and the y of the vertex with index 'i' at '2 * i' and '2 * i + 1', like    *
+* the coordinates of a frozen graph, which a compressed graph made from it     *
+* shares, since compression keeps the vertex indices. The distance of two      *
+* vertices is multiplied by 'scale', which must not exceed the smallest ratio  *
+* of the weight of an arc to the distance of its end points: the reciprocal of *
+* the maximum speed if the weights are travel times, or a bit below 1 if they  *
+* are lengths, so that the rounding errors keep the bound consistent.          *
+*******************************************************************************/
+typedef struct coordinate_bound {
+    distance_bound bound; /* Pass this to the searches. */
+    const double*  coordinates;
+    double         scale;
+} coordinate_bound;
+
+/* Sets up 'p_coordinate_bound' with one of the DISTANCE_BOUND_* kinds: */
+void coordinate_bound_init(coordinate_bound* p_coordinate_bound,
+                           int kind,
+                           const double* coordinates,
+                           double scale);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_DISTANCE_BOUND_H */
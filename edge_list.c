@@ -0,0 +1,122 @@
+#include "edge_list.h"
+#include "allocator.h"
+#include "util.h"
+
+static const size_t MINIMUM_INITIAL_CAPACITY = 16;
+
+static size_t fix_initial_capacity(size_t initial_capacity)
+{
+    return initial_capacity < MINIMUM_INITIAL_CAPACITY ?
+           MINIMUM_INITIAL_CAPACITY :
+           initial_capacity;
+}
+
+edge_list* edge_list_alloc(size_t initial_capacity)
+{
+    edge_list* p_edge_list = allocator_malloc(sizeof(*p_edge_list));
+
+    if (!p_edge_list)
+    {
+        return NULL;
+    }
+
+    initial_capacity = fix_initial_capacity(initial_capacity);
+    p_edge_list->tails =
+            allocator_malloc(sizeof(vertex_id_t) * initial_capacity);
+    p_edge_list->heads =
+            allocator_malloc(sizeof(vertex_id_t) * initial_capacity);
+    p_edge_list->weights =
+            allocator_malloc(sizeof(weight_t) * initial_capacity);
+
+    if (!p_edge_list->tails || !p_edge_list->heads || !p_edge_list->weights)
+    {
+        edge_list_free(p_edge_list);
+        return NULL;
+    }
+
+    p_edge_list->size = 0;
+    p_edge_list->capacity = initial_capacity;
+    return p_edge_list;
+}
+
+static int ensure_capacity_before_add(edge_list* p_edge_list)
+{
+    vertex_id_t* new_tails;
+    vertex_id_t* new_heads;
+    weight_t* new_weights;
+    size_t new_capacity;
+
+    if (p_edge_list->size < p_edge_list->capacity)
+    {
+        return TRUE;
+    }
+
+    new_capacity = 2 * p_edge_list->capacity;
+
+    /* Each array is stored back as soon as it has moved, so that a failure
+       leaves the list consistent: */
+    new_tails = allocator_realloc(p_edge_list->tails,
+                                  sizeof(vertex_id_t) * new_capacity);
+
+    if (!new_tails)
+    {
+        return FALSE;
+    }
+
+    p_edge_list->tails = new_tails;
+    new_heads = allocator_realloc(p_edge_list->heads,
+                                  sizeof(vertex_id_t) * new_capacity);
+
+    if (!new_heads)
+    {
+        return FALSE;
+    }
+
+    p_edge_list->heads = new_heads;
+    new_weights = allocator_realloc(p_edge_list->weights,
+                                    sizeof(weight_t) * new_capacity);
+
+    if (!new_weights)
+    {
+        return FALSE;
+    }
+
+    p_edge_list->weights = new_weights;
+    p_edge_list->capacity = new_capacity;
+    return TRUE;
+}
+
+int edge_list_add(edge_list* p_edge_list,
+                  vertex_id_t tail_vertex_id,
+                  vertex_id_t head_vertex_id,
+                  weight_t weight)
+{
+    if (!ensure_capacity_before_add(p_edge_list))
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    p_edge_list->tails[p_edge_list->size] = tail_vertex_id;
+    p_edge_list->heads[p_edge_list->size] = head_vertex_id;
+    p_edge_list->weights[p_edge_list->size] = weight;
+    p_edge_list->size++;
+    return RETURN_STATUS_OK;
+}
+
+void edge_list_clear(edge_list* p_edge_list)
+{
+    p_edge_list->size = 0;
+}
+
+void edge_list_free(edge_list* p_edge_list)
+{
+    if (!p_edge_list)
+    {
+        return;
+    }
+
+    allocator_free(p_edge_list->tails);
+    allocator_free(p_edge_list->heads);
+    allocator_free(p_edge_list->weights);
+    allocator_free(p_edge_list);
+}
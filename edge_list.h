@@ -0,0 +1,32 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_EDGE_LIST_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_EDGE_LIST_H
+
+#include "types.h"
+#include <stdlib.h>
+
+/*******************************************************************************
+* A growable list of arcs stored as three parallel arrays: the arc 'i' leads   *
+* from 'tails[i]' to 'heads[i]' and weighs 'weights[i]'. The endpoints are     *
+* vertex IDs. The list may hold the same arc several times; the graphs built   *
+* from it keep the weight of the last occurrence, as 'addEdge' does.           *
+*******************************************************************************/
+typedef struct edge_list {
+    vertex_id_t* tails;
+    vertex_id_t* heads;
+    weight_t*    weights;
+    size_t       size;
+    size_t       capacity;
+} edge_list;
+
+edge_list* edge_list_alloc(size_t initial_capacity);
+
+int edge_list_add(edge_list* p_edge_list,
+                  vertex_id_t tail_vertex_id,
+                  vertex_id_t head_vertex_id,
+                  weight_t weight);
+
+void edge_list_clear(edge_list* p_edge_list);
+
+void edge_list_free(edge_list* p_edge_list);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_EDGE_LIST_H */
@@ -0,0 +1,414 @@
+#include "frozen_graph.h"
+#include "allocator.h"
+#include "graph.h"
+#include "graph_vertex_map.h"
+#include "util.h"
+#include "weight_map.h"
+#include <stdlib.h>
+
+static int compare_vertex_ids(const void* p_a, const void* p_b)
+{
+    vertex_id_t a = *(const vertex_id_t*) p_a;
+    vertex_id_t b = *(const vertex_id_t*) p_b;
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+frozen_graph* frozen_graph_alloc(size_t vertex_count, size_t edge_count)
+{
+    frozen_graph* p_frozen_graph = allocator_malloc(sizeof(*p_frozen_graph));
+
+    if (!p_frozen_graph)
+    {
+        return NULL;
+    }
+
+    p_frozen_graph->vertex_count = vertex_count;
+    p_frozen_graph->edge_count = edge_count;
+    p_frozen_graph->sorted_indices = NULL;
+    p_frozen_graph->coordinates = NULL;
+    p_frozen_graph->landmark_count = 0;
+    p_frozen_graph->landmarks = NULL;
+    p_frozen_graph->landmark_distances = NULL;
+    p_frozen_graph->p_landmark_block = NULL;
+    p_frozen_graph->release_storage = NULL;
+    p_frozen_graph->p_storage = NULL;
+    p_frozen_graph->storage_size = 0;
+
+    /* Allocate at least one element so that empty graphs are not confused
+       with failed allocations: */
+    p_frozen_graph->vertex_ids =
+            allocator_malloc(sizeof(vertex_id_t) * (vertex_count + 1));
+
+    p_frozen_graph->forward_offsets =
+            allocator_malloc(sizeof(size_t) * (vertex_count + 1));
+
+    p_frozen_graph->backward_offsets =
+            allocator_malloc(sizeof(size_t) * (vertex_count + 1));
+
+    p_frozen_graph->forward_heads =
+            allocator_malloc(sizeof(vertex_id_t) * (edge_count + 1));
+
+    p_frozen_graph->backward_heads =
+            allocator_malloc(sizeof(vertex_id_t) * (edge_count + 1));
+
+    p_frozen_graph->forward_weights =
+            allocator_malloc(sizeof(weight_t) * (edge_count + 1));
+
+    p_frozen_graph->backward_weights =
+            allocator_malloc(sizeof(weight_t) * (edge_count + 1));
+
+    if (!p_frozen_graph->vertex_ids       ||
+        !p_frozen_graph->forward_offsets  ||
+        !p_frozen_graph->backward_offsets ||
+        !p_frozen_graph->forward_heads    ||
+        !p_frozen_graph->backward_heads   ||
+        !p_frozen_graph->forward_weights  ||
+        !p_frozen_graph->backward_weights) {
+        frozen_graph_free(p_frozen_graph);
+        return NULL;
+    }
+
+    return p_frozen_graph;
+}
+
+void frozen_graph_free(frozen_graph* p_frozen_graph)
+{
+    if (!p_frozen_graph)
+    {
+        return;
+    }
+
+    allocator_free(p_frozen_graph->coordinates);
+    allocator_free(p_frozen_graph->p_landmark_block);
+
+    if (p_frozen_graph->release_storage)
+    {
+        p_frozen_graph->release_storage(p_frozen_graph);
+        allocator_free(p_frozen_graph);
+        return;
+    }
+
+    allocator_free(p_frozen_graph->vertex_ids);
+    allocator_free(p_frozen_graph->sorted_indices);
+    allocator_free(p_frozen_graph->forward_offsets);
+    allocator_free(p_frozen_graph->backward_offsets);
+    allocator_free(p_frozen_graph->forward_heads);
+    allocator_free(p_frozen_graph->backward_heads);
+    allocator_free(p_frozen_graph->forward_weights);
+    allocator_free(p_frozen_graph->backward_weights);
+    allocator_free(p_frozen_graph);
+}
+
+/* Looks up an ID through the index array sorted by ID of a reordered graph: */
+static int find_reordered_index(const vertex_id_t* vertex_ids,
+                                const vertex_id_t* sorted_indices,
+                                size_t vertex_count,
+                                vertex_id_t vertex_id,
+                                size_t* p_index)
+{
+    size_t low = 0;
+    size_t high = vertex_count;
+    size_t middle;
+
+    while (low < high)
+    {
+        middle = low + (high - low) / 2;
+
+        if (vertex_ids[sorted_indices[middle]] < vertex_id)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if (low == vertex_count || vertex_ids[sorted_indices[low]] != vertex_id)
+    {
+        return FALSE;
+    }
+
+    *p_index = sorted_indices[low];
+    return TRUE;
+}
+
+int frozen_graph_find_index(const vertex_id_t* vertex_ids,
+                            const vertex_id_t* sorted_indices,
+                            size_t vertex_count,
+                            vertex_id_t vertex_id,
+                            size_t* p_index)
+{
+    const vertex_id_t* p_found;
+
+    if (vertex_count == 0)
+    {
+        return FALSE;
+    }
+
+    if (!vertex_ids)
+    {
+        if (vertex_id >= vertex_count)
+        {
+            return FALSE;
+        }
+
+        *p_index = vertex_id;
+        return TRUE;
+    }
+
+    if (sorted_indices)
+    {
+        return find_reordered_index(vertex_ids,
+                                    sorted_indices,
+                                    vertex_count,
+                                    vertex_id,
+                                    p_index);
+    }
+
+    p_found = bsearch(&vertex_id,
+                      vertex_ids,
+                      vertex_count,
+                      sizeof(vertex_id_t),
+                      compare_vertex_ids);
+
+    if (!p_found)
+    {
+        return FALSE;
+    }
+
+    *p_index = (size_t)(p_found - vertex_ids);
+    return TRUE;
+}
+
+int frozen_graph_get_index(frozen_graph* p_frozen_graph,
+                           vertex_id_t vertex_id,
+                           size_t* p_index)
+{
+    if (!p_frozen_graph)
+    {
+        return FALSE;
+    }
+
+    return frozen_graph_find_index(p_frozen_graph->vertex_ids,
+                                   p_frozen_graph->sorted_indices,
+                                   p_frozen_graph->vertex_count,
+                                   vertex_id,
+                                   p_index);
+}
+
+vertex_id_t frozen_graph_get_vertex_id(frozen_graph* p_frozen_graph,
+                                       size_t index)
+{
+    return p_frozen_graph->vertex_ids ?
+           p_frozen_graph->vertex_ids[index] :
+           (vertex_id_t) index;
+}
+
+int frozen_graph_set_coordinates(frozen_graph* p_frozen_graph,
+                                 vertex_id_t vertex_id,
+                                 double x,
+                                 double y)
+{
+    size_t index;
+    size_t i;
+
+    if (!p_frozen_graph)
+    {
+        return RETURN_STATUS_NO_GRAPH;
+    }
+
+    if (!frozen_graph_get_index(p_frozen_graph, vertex_id, &index))
+    {
+        return RETURN_STATUS_NO_VERTEX;
+    }
+
+    if (!p_frozen_graph->coordinates)
+    {
+        p_frozen_graph->coordinates = allocator_malloc(
+                sizeof(double) * 2 * (p_frozen_graph->vertex_count + 1));
+
+        if (!p_frozen_graph->coordinates)
+        {
+            return RETURN_STATUS_NO_MEMORY;
+        }
+
+        for (i = 0; i < 2 * p_frozen_graph->vertex_count; ++i)
+        {
+            p_frozen_graph->coordinates[i] = 0.0;
+        }
+    }
+
+    p_frozen_graph->coordinates[2 * index] = x;
+    p_frozen_graph->coordinates[2 * index + 1] = y;
+    return RETURN_STATUS_OK;
+}
+
+int frozen_graph_alloc_landmarks(frozen_graph* p_frozen_graph,
+                                 size_t landmark_count)
+{
+    /* The indices go first, padded to the alignment of the distances: */
+    size_t index_size = (sizeof(vertex_id_t) * landmark_count +
+                         sizeof(distance_t) - 1) /
+                        sizeof(distance_t) * sizeof(distance_t);
+    size_t row_size = 2 * landmark_count;
+    char* p_block = NULL;
+
+    if (landmark_count > 0)
+    {
+        if (p_frozen_graph->vertex_count >
+            ((size_t) -1 - index_size) / sizeof(distance_t) / row_size)
+        {
+            return RETURN_STATUS_NO_MEMORY;
+        }
+
+        p_block = allocator_malloc(index_size +
+                                   sizeof(distance_t) *
+                                   row_size *
+                                   p_frozen_graph->vertex_count);
+
+        if (!p_block)
+        {
+            return RETURN_STATUS_NO_MEMORY;
+        }
+    }
+
+    allocator_free(p_frozen_graph->p_landmark_block);
+    p_frozen_graph->p_landmark_block = p_block;
+    p_frozen_graph->landmark_count = landmark_count;
+    p_frozen_graph->landmarks = (vertex_id_t*) p_block;
+    p_frozen_graph->landmark_distances =
+            p_block ? (distance_t*)(p_block + index_size) : NULL;
+
+    return RETURN_STATUS_OK;
+}
+
+/*******************************************************************************
+* Lays out the arcs stored in the weight maps of all vertices into the offset, *
+* head and weight arrays. 'children' selects whether the forward or the        *
+* backward adjacency is being built. 'vertices' lists the graph vertices in    *
+* the frozen order and 'frozen_index_of' maps a graph vertex index to the      *
+* frozen one.                                                                  *
+*******************************************************************************/
+static void fill_adjacency(frozen_graph* p_frozen_graph,
+                           GraphVertex** vertices,
+                           vertex_id_t* frozen_index_of,
+                           int children,
+                           size_t* offsets,
+                           vertex_id_t* heads,
+                           weight_t* weights)
+{
+    size_t i;
+    size_t arc_index = 0;
+    vertex_id_t neighbor_index;
+    weight_t weight;
+    weight_map_iterator iterator;
+
+    for (i = 0; i < p_frozen_graph->vertex_count; ++i)
+    {
+        offsets[i] = arc_index;
+
+        weight_map_iterator_init(&iterator,
+                                 children ? vertices[i]->p_children :
+                                            vertices[i]->p_parents);
+
+        while (weight_map_iterator_has_next(&iterator))
+        {
+            weight_map_iterator_visit(&iterator,
+                                      &neighbor_index,
+                                      &weight);
+
+            weight_map_iterator_next(&iterator);
+
+            heads[arc_index] = frozen_index_of[neighbor_index];
+            weights[arc_index] = weight;
+            arc_index++;
+        }
+    }
+
+    offsets[p_frozen_graph->vertex_count] = arc_index;
+}
+
+frozen_graph* graph_freeze(Graph* p_graph)
+{
+    frozen_graph* p_frozen_graph;
+    GraphVertex* p_graph_vertex;
+    GraphVertex** vertices;
+    vertex_id_t* frozen_index_of;
+    size_t vertex_count;
+    size_t edge_count = 0;
+    size_t i;
+    size_t j = 0;
+
+    if (!p_graph || !p_graph->p_nodes)
+    {
+        return NULL;
+    }
+
+    vertex_count = p_graph->p_nodes->table.size;
+
+    for (i = 0; i < p_graph->vertex_table_size; ++i)
+    {
+        p_graph_vertex = p_graph->p_vertex_table[i];
+
+        if (p_graph_vertex)
+        {
+            edge_count += weight_map_size(p_graph_vertex->p_children);
+        }
+    }
+
+    p_frozen_graph = frozen_graph_alloc(vertex_count, edge_count);
+    vertices = allocator_malloc(sizeof(GraphVertex*) * (vertex_count + 1));
+    frozen_index_of = allocator_malloc(sizeof(vertex_id_t) *
+                                       (p_graph->vertex_table_size + 1));
+
+    if (!p_frozen_graph || !vertices || !frozen_index_of)
+    {
+        frozen_graph_free(p_frozen_graph);
+        allocator_free(vertices);
+        allocator_free(frozen_index_of);
+        return NULL;
+    }
+
+    for (i = 0; i < p_graph->vertex_table_size; ++i)
+    {
+        if (p_graph->p_vertex_table[i])
+        {
+            p_frozen_graph->vertex_ids[j++] = p_graph->p_vertex_table[i]->id;
+        }
+    }
+
+    /* Sorting the IDs makes the vertex index lookup a binary search: */
+    qsort(p_frozen_graph->vertex_ids,
+          vertex_count,
+          sizeof(vertex_id_t),
+          compare_vertex_ids);
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        vertices[i] = graph_vertex_map_get(p_graph->p_nodes,
+                                           p_frozen_graph->vertex_ids[i]);
+
+        frozen_index_of[vertices[i]->index] = i;
+    }
+
+    fill_adjacency(p_frozen_graph,
+                   vertices,
+                   frozen_index_of,
+                   TRUE,
+                   p_frozen_graph->forward_offsets,
+                   p_frozen_graph->forward_heads,
+                   p_frozen_graph->forward_weights);
+
+    fill_adjacency(p_frozen_graph,
+                   vertices,
+                   frozen_index_of,
+                   FALSE,
+                   p_frozen_graph->backward_offsets,
+                   p_frozen_graph->backward_heads,
+                   p_frozen_graph->backward_weights);
+
+    allocator_free(vertices);
+    allocator_free(frozen_index_of);
+    return p_frozen_graph;
+}
@@ -0,0 +1,96 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_H
+
+#include "graph.h"
+#include <stdlib.h>
+
+/*******************************************************************************
+* An immutable compressed-sparse-row snapshot of a 'Graph'. Vertices are       *
+* renumbered into dense indices 0..vertex_count - 1. The out-arcs of the       *
+* vertex with index 'i' occupy the range                                       *
+* [forward_offsets[i], forward_offsets[i + 1]) of 'forward_heads' and          *
+* 'forward_weights'; the in-arcs are laid out likewise in the backward arrays, *
+* where 'backward_heads' holds the tails of the arcs. 'vertex_ids' may be      *
+* NULL, in which case the ID of each vertex equals its index. It is sorted     *
+* unless the graph has been reordered; then 'sorted_indices' lists the vertex  *
+* indices in increasing ID order for the lookups by ID. The arrays are         *
+* owned by the graph unless 'release_storage' is set: then they live in one    *
+* block of storage, such as a mapped snapshot file, which the function         *
+* releases. 'coordinates' is NULL unless positions have been given to the      *
+* vertices for the goal-directed searches; it is always owned by the graph.    *
+* 'landmark_count' is zero unless landmarks have been added to the graph, see  *
+* frozen_graph_landmarks.h. The landmark arrays live in 'p_landmark_block',    *
+* or in the storage of a snapshot if that is NULL.                             *
+*******************************************************************************/
+typedef struct frozen_graph {
+    size_t       vertex_count;
+    size_t       edge_count;
+    vertex_id_t* vertex_ids; /* Maps a vertex index to its ID. */
+    vertex_id_t* sorted_indices; /* NULL if 'vertex_ids' is sorted. */
+    size_t*      forward_offsets;
+    vertex_id_t* forward_heads;
+    weight_t*    forward_weights;
+    size_t*      backward_offsets;
+    vertex_id_t* backward_heads;
+    weight_t*    backward_weights;
+    double*      coordinates; /* x and y of index 'i' at 2i and 2i + 1. */
+    size_t       landmark_count;
+    vertex_id_t* landmarks; /* The indices of the landmarks. */
+    distance_t*  landmark_distances; /* 2 * landmark_count per vertex. */
+    void*        p_landmark_block;
+    void       (*release_storage)(struct frozen_graph* p_frozen_graph);
+    void*        p_storage;
+    size_t       storage_size;
+} frozen_graph;
+
+/*******************************************************************************
+* Allocates a frozen graph with room for 'vertex_count' vertices and           *
+* 'edge_count' arcs. The arrays are left uninitialized.                        *
+*******************************************************************************/
+frozen_graph* frozen_graph_alloc(size_t vertex_count, size_t edge_count);
+
+frozen_graph* graph_freeze(Graph* p_graph);
+
+void frozen_graph_free(frozen_graph* p_frozen_graph);
+
+int frozen_graph_get_index(frozen_graph* p_frozen_graph,
+                           vertex_id_t vertex_id,
+                           size_t* p_index);
+
+/*******************************************************************************
+* Finds the index of 'vertex_id' in an ID map laid out like the one of a       *
+* frozen graph: 'vertex_ids' is NULL for identity IDs, and 'sorted_indices' is *
+* NULL unless 'vertex_ids' is unsorted. Returns FALSE if the ID is absent.     *
+*******************************************************************************/
+int frozen_graph_find_index(const vertex_id_t* vertex_ids,
+                            const vertex_id_t* sorted_indices,
+                            size_t vertex_count,
+                            vertex_id_t vertex_id,
+                            size_t* p_index);
+
+vertex_id_t frozen_graph_get_vertex_id(frozen_graph* p_frozen_graph,
+                                       size_t index);
+
+/*******************************************************************************
+* Stores the position of 'vertex_id' for the bounds of 'coordinate_bound'. The *
+* first call allocates the coordinates of all vertices, all at the origin.     *
+* Returns RETURN_STATUS_OK, RETURN_STATUS_NO_GRAPH, RETURN_STATUS_NO_VERTEX or *
+* RETURN_STATUS_NO_MEMORY.                                                     *
+*******************************************************************************/
+int frozen_graph_set_coordinates(frozen_graph* p_frozen_graph,
+                                 vertex_id_t vertex_id,
+                                 double x,
+                                 double y);
+
+/*******************************************************************************
+* Replaces the landmarks of the graph with room for 'landmark_count' of them   *
+* in one block owned by the graph. The arrays are left uninitialized; row 'i'  *
+* of 'landmark_distances' holds the distances from the landmarks to the vertex *
+* with index 'i', then the ones from the vertex to the landmarks. Returns      *
+* RETURN_STATUS_OK or RETURN_STATUS_NO_MEMORY, in which case the graph keeps   *
+* its landmarks.                                                               *
+*******************************************************************************/
+int frozen_graph_alloc_landmarks(frozen_graph* p_frozen_graph,
+                                 size_t landmark_count);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_H */
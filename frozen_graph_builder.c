@@ -0,0 +1,1304 @@
+#include "allocator.h"
+#include "frozen_graph.h"
+#include "frozen_graph_builder.h"
+#include "util.h"
+#include "worker_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TRY_REPORT_RETURN_STATUS(RETURN_STATUS) \
+if (p_return_status) {                          \
+    *p_return_status = RETURN_STATUS;           \
+}
+
+/* The IDs are mapped through a direct table if the largest ID is below this
+   many times the number of arcs: */
+static const size_t DIRECT_TABLE_FACTOR = 4;
+
+static int compare_vertex_ids(const void* p_a, const void* p_b)
+{
+    vertex_id_t a = *(const vertex_id_t*) p_a;
+    vertex_id_t b = *(const vertex_id_t*) p_b;
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+/* Returns a shrunk copy of 'p_array', or 'p_array' if it cannot shrink: */
+static void* shrink_array(void* p_array, size_t size)
+{
+    void* p_new_array = allocator_realloc(p_array, size);
+    return p_new_array ? p_new_array : p_array;
+}
+
+/*******************************************************************************
+* Maps vertex IDs to vertex indices assigned in increasing ID order. Dense ID  *
+* ranges, such as the 1..n of DIMACS files, are mapped through 'index_of', a   *
+* table indexed by the IDs themselves; other ranges by binary search in        *
+* 'vertex_ids'. 'vertex_ids' lists the distinct IDs in increasing order and is *
+* NULL if they are exactly 0..vertex_count - 1.                                *
+*******************************************************************************/
+typedef struct vertex_id_mapping {
+    vertex_id_t* index_of;
+    vertex_id_t* vertex_ids;
+    size_t       vertex_count;
+} vertex_id_mapping;
+
+static vertex_id_t find_max_id(const vertex_id_t* tails,
+                               const vertex_id_t* heads,
+                               size_t begin,
+                               size_t end)
+{
+    vertex_id_t max_id = 0;
+    size_t i;
+
+    for (i = begin; i < end; ++i)
+    {
+        if (max_id < tails[i])
+        {
+            max_id = tails[i];
+        }
+
+        if (max_id < heads[i])
+        {
+            max_id = heads[i];
+        }
+    }
+
+    return max_id;
+}
+
+static int build_id_table(const vertex_id_t* tails,
+                          const vertex_id_t* heads,
+                          size_t edge_count,
+                          vertex_id_t max_id,
+                          vertex_id_mapping* p_mapping)
+{
+    size_t table_size = (size_t) max_id + 1;
+    vertex_id_t* index_of = allocator_calloc(table_size, sizeof(vertex_id_t));
+    vertex_id_t* vertex_ids = NULL;
+    size_t vertex_count = 0;
+    size_t i;
+
+    if (!index_of)
+    {
+        return FALSE;
+    }
+
+    /* Mark the IDs that occur: */
+    for (i = 0; i < edge_count; ++i)
+    {
+        index_of[tails[i]] = 1;
+        index_of[heads[i]] = 1;
+    }
+
+    for (i = 0; i < table_size; ++i)
+    {
+        vertex_count += index_of[i];
+    }
+
+    /* When every ID up to the largest occurs, the IDs are the indices: */
+    if (vertex_count < table_size)
+    {
+        vertex_ids = allocator_malloc(sizeof(vertex_id_t) * vertex_count);
+
+        if (!vertex_ids)
+        {
+            allocator_free(index_of);
+            return FALSE;
+        }
+    }
+
+    vertex_count = 0;
+
+    for (i = 0; i < table_size; ++i)
+    {
+        if (index_of[i])
+        {
+            if (vertex_ids)
+            {
+                vertex_ids[vertex_count] = (vertex_id_t) i;
+            }
+
+            index_of[i] = (vertex_id_t) vertex_count++;
+        }
+    }
+
+    p_mapping->index_of = index_of;
+    p_mapping->vertex_ids = vertex_ids;
+    p_mapping->vertex_count = vertex_count;
+    return TRUE;
+}
+
+static int build_sorted_ids(const vertex_id_t* tails,
+                            const vertex_id_t* heads,
+                            size_t edge_count,
+                            vertex_id_mapping* p_mapping)
+{
+    vertex_id_t* vertex_ids =
+            allocator_malloc(sizeof(vertex_id_t) * 2 * edge_count);
+    size_t vertex_count = 0;
+    size_t i;
+
+    if (!vertex_ids)
+    {
+        return FALSE;
+    }
+
+    memcpy(vertex_ids, tails, sizeof(vertex_id_t) * edge_count);
+    memcpy(vertex_ids + edge_count, heads, sizeof(vertex_id_t) * edge_count);
+    qsort(vertex_ids, 2 * edge_count, sizeof(vertex_id_t), compare_vertex_ids);
+
+    for (i = 0; i < 2 * edge_count; ++i)
+    {
+        if (vertex_count == 0 || vertex_ids[vertex_count - 1] != vertex_ids[i])
+        {
+            vertex_ids[vertex_count++] = vertex_ids[i];
+        }
+    }
+
+    /* The indices must leave VERTEX_ID_MAX free as a marker: */
+    if (vertex_count >= VERTEX_ID_MAX)
+    {
+        allocator_free(vertex_ids);
+        return FALSE;
+    }
+
+    p_mapping->index_of = NULL;
+    p_mapping->vertex_count = vertex_count;
+
+    if (vertex_ids[vertex_count - 1] == vertex_count - 1)
+    {
+        allocator_free(vertex_ids);
+        p_mapping->vertex_ids = NULL;
+    }
+    else
+    {
+        p_mapping->vertex_ids =
+                shrink_array(vertex_ids, sizeof(vertex_id_t) * vertex_count);
+    }
+
+    return TRUE;
+}
+
+/* Builds the mapping of the IDs of a nonempty arc list: */
+static int build_vertex_id_mapping(const vertex_id_t* tails,
+                                   const vertex_id_t* heads,
+                                   size_t edge_count,
+                                   vertex_id_t max_id,
+                                   vertex_id_mapping* p_mapping)
+{
+    if (max_id < VERTEX_ID_MAX && max_id / DIRECT_TABLE_FACTOR < edge_count)
+    {
+        return build_id_table(tails, heads, edge_count, max_id, p_mapping);
+    }
+
+    return build_sorted_ids(tails, heads, edge_count, p_mapping);
+}
+
+/* Returns the index of 'vertex_id', which must occur in 'vertex_ids': */
+static vertex_id_t find_index(const vertex_id_t* vertex_ids,
+                              size_t vertex_count,
+                              vertex_id_t vertex_id)
+{
+    const vertex_id_t* p_found = bsearch(&vertex_id,
+                                         vertex_ids,
+                                         vertex_count,
+                                         sizeof(vertex_id_t),
+                                         compare_vertex_ids);
+
+    return (vertex_id_t)(p_found - vertex_ids);
+}
+
+static vertex_id_t map_vertex_id(const vertex_id_mapping* p_mapping,
+                                 vertex_id_t vertex_id)
+{
+    if (p_mapping->index_of)
+    {
+        return p_mapping->index_of[vertex_id];
+    }
+
+    if (!p_mapping->vertex_ids)
+    {
+        return vertex_id;
+    }
+
+    return find_index(p_mapping->vertex_ids,
+                      p_mapping->vertex_count,
+                      vertex_id);
+}
+
+/* Maps the endpoints of the arcs in [begin, end) to vertex indices: */
+static void map_endpoints(const vertex_id_mapping* p_mapping,
+                          const vertex_id_t* tails,
+                          const vertex_id_t* heads,
+                          size_t begin,
+                          size_t end,
+                          vertex_id_t* tail_indices,
+                          vertex_id_t* head_indices)
+{
+    size_t i;
+
+    for (i = begin; i < end; ++i)
+    {
+        tail_indices[i] = map_vertex_id(p_mapping, tails[i]);
+        head_indices[i] = map_vertex_id(p_mapping, heads[i]);
+    }
+}
+
+/*******************************************************************************
+* Maps the endpoint IDs of all the arcs to vertex indices. Only                *
+* 'p_mapping->vertex_ids' outlives the call.                                   *
+*******************************************************************************/
+static int map_vertex_ids(const vertex_id_t* tails,
+                          const vertex_id_t* heads,
+                          size_t edge_count,
+                          vertex_id_t* tail_indices,
+                          vertex_id_t* head_indices,
+                          vertex_id_mapping* p_mapping)
+{
+    p_mapping->index_of = NULL;
+    p_mapping->vertex_ids = NULL;
+    p_mapping->vertex_count = 0;
+
+    if (edge_count == 0)
+    {
+        return TRUE;
+    }
+
+    if (!build_vertex_id_mapping(tails,
+                                 heads,
+                                 edge_count,
+                                 find_max_id(tails, heads, 0, edge_count),
+                                 p_mapping))
+    {
+        return FALSE;
+    }
+
+    map_endpoints(p_mapping,
+                  tails,
+                  heads,
+                  0,
+                  edge_count,
+                  tail_indices,
+                  head_indices);
+
+    allocator_free(p_mapping->index_of);
+    p_mapping->index_of = NULL;
+    return TRUE;
+}
+
+/*******************************************************************************
+* Buckets the arcs by tail into the forward arrays, keeping their input order  *
+* within each bucket, and then drops the repeated arcs in place, so that only  *
+* the first occurrence of each arc remains, carrying the weight of the last.   *
+* 'cursors' and 'last_tails' are scratch arrays of 'vertex_count' elements.    *
+* Returns the number of distinct arcs.                                         *
+*******************************************************************************/
+static size_t fill_forward_arcs(frozen_graph* p_frozen_graph,
+                                const vertex_id_t* tail_indices,
+                                const vertex_id_t* head_indices,
+                                const weight_t* weights,
+                                size_t edge_count,
+                                size_t* cursors,
+                                vertex_id_t* last_tails)
+{
+    size_t vertex_count = p_frozen_graph->vertex_count;
+    size_t* offsets = p_frozen_graph->forward_offsets;
+    vertex_id_t* heads = p_frozen_graph->forward_heads;
+    weight_t* arc_weights = p_frozen_graph->forward_weights;
+    size_t arc_count = 0;
+    size_t i;
+    size_t arc_index;
+    size_t arc_end;
+    vertex_id_t head;
+
+    memset(offsets, 0, sizeof(size_t) * (vertex_count + 1));
+
+    for (i = 0; i < edge_count; ++i)
+    {
+        offsets[tail_indices[i] + 1]++;
+    }
+
+    for (i = 1; i <= vertex_count; ++i)
+    {
+        offsets[i] += offsets[i - 1];
+    }
+
+    memcpy(cursors, offsets, sizeof(size_t) * vertex_count);
+
+    for (i = 0; i < edge_count; ++i)
+    {
+        arc_index = cursors[tail_indices[i]]++;
+        heads[arc_index] = head_indices[i];
+        arc_weights[arc_index] = weights[i];
+    }
+
+    /* From here on, 'cursors[head]' is where the arc from the current tail to
+       'head' was kept, valid while 'last_tails[head]' is the current tail: */
+    for (i = 0; i < vertex_count; ++i)
+    {
+        last_tails[i] = VERTEX_ID_MAX;
+    }
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        arc_index = offsets[i];
+        arc_end = offsets[i + 1];
+        offsets[i] = arc_count;
+
+        for (; arc_index < arc_end; ++arc_index)
+        {
+            head = heads[arc_index];
+
+            if (last_tails[head] == i)
+            {
+                arc_weights[cursors[head]] = arc_weights[arc_index];
+            }
+            else
+            {
+                last_tails[head] = (vertex_id_t) i;
+                cursors[head] = arc_count;
+                heads[arc_count] = head;
+                arc_weights[arc_count] = arc_weights[arc_index];
+                arc_count++;
+            }
+        }
+    }
+
+    offsets[vertex_count] = arc_count;
+    return arc_count;
+}
+
+/* Buckets the forward arcs by head into the backward arrays: */
+static void fill_backward_arcs(frozen_graph* p_frozen_graph,
+                               size_t arc_count,
+                               size_t* cursors)
+{
+    size_t vertex_count = p_frozen_graph->vertex_count;
+    size_t* offsets = p_frozen_graph->backward_offsets;
+    size_t i;
+    size_t arc_index;
+    size_t backward_index;
+
+    memset(offsets, 0, sizeof(size_t) * (vertex_count + 1));
+
+    for (arc_index = 0; arc_index < arc_count; ++arc_index)
+    {
+        offsets[p_frozen_graph->forward_heads[arc_index] + 1]++;
+    }
+
+    for (i = 1; i <= vertex_count; ++i)
+    {
+        offsets[i] += offsets[i - 1];
+    }
+
+    memcpy(cursors, offsets, sizeof(size_t) * vertex_count);
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        for (arc_index = p_frozen_graph->forward_offsets[i];
+             arc_index < p_frozen_graph->forward_offsets[i + 1];
+             ++arc_index)
+        {
+            backward_index =
+                    cursors[p_frozen_graph->forward_heads[arc_index]]++;
+
+            p_frozen_graph->backward_heads[backward_index] = (vertex_id_t) i;
+            p_frozen_graph->backward_weights[backward_index] =
+                    p_frozen_graph->forward_weights[arc_index];
+        }
+    }
+}
+
+/* Gives back the arc slots freed by dropping repeated arcs: */
+static void shrink_arcs(frozen_graph* p_frozen_graph, size_t arc_count)
+{
+    p_frozen_graph->edge_count = arc_count;
+
+    p_frozen_graph->forward_heads =
+            shrink_array(p_frozen_graph->forward_heads,
+                         sizeof(vertex_id_t) * (arc_count + 1));
+
+    p_frozen_graph->backward_heads =
+            shrink_array(p_frozen_graph->backward_heads,
+                         sizeof(vertex_id_t) * (arc_count + 1));
+
+    p_frozen_graph->forward_weights =
+            shrink_array(p_frozen_graph->forward_weights,
+                         sizeof(weight_t) * (arc_count + 1));
+
+    p_frozen_graph->backward_weights =
+            shrink_array(p_frozen_graph->backward_weights,
+                         sizeof(weight_t) * (arc_count + 1));
+}
+
+frozen_graph* frozen_graph_build(const vertex_id_t* tails,
+                                 const vertex_id_t* heads,
+                                 const weight_t* weights,
+                                 size_t edge_count,
+                                 int* p_return_status)
+{
+    frozen_graph* p_frozen_graph = NULL;
+    vertex_id_t* tail_indices =
+            allocator_malloc(sizeof(vertex_id_t) * (edge_count + 1));
+    vertex_id_t* head_indices =
+            allocator_malloc(sizeof(vertex_id_t) * (edge_count + 1));
+    vertex_id_t* last_tails = NULL;
+    size_t* cursors = NULL;
+    vertex_id_mapping mapping;
+    size_t arc_count;
+
+    mapping.vertex_ids = NULL;
+
+    if (tail_indices && head_indices && map_vertex_ids(tails,
+                                                       heads,
+                                                       edge_count,
+                                                       tail_indices,
+                                                       head_indices,
+                                                       &mapping))
+    {
+        p_frozen_graph = frozen_graph_alloc(mapping.vertex_count, edge_count);
+        cursors = allocator_malloc(sizeof(size_t) * (mapping.vertex_count + 1));
+        last_tails = allocator_malloc(sizeof(vertex_id_t) *
+                                      (mapping.vertex_count + 1));
+    }
+
+    if (!p_frozen_graph || !cursors || !last_tails)
+    {
+        frozen_graph_free(p_frozen_graph);
+        allocator_free(mapping.vertex_ids);
+        allocator_free(tail_indices);
+        allocator_free(head_indices);
+        allocator_free(cursors);
+        allocator_free(last_tails);
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    allocator_free(p_frozen_graph->vertex_ids);
+    p_frozen_graph->vertex_ids = mapping.vertex_ids;
+
+    arc_count = fill_forward_arcs(p_frozen_graph,
+                                  tail_indices,
+                                  head_indices,
+                                  weights,
+                                  edge_count,
+                                  cursors,
+                                  last_tails);
+
+    fill_backward_arcs(p_frozen_graph, arc_count, cursors);
+
+    if (arc_count < edge_count)
+    {
+        shrink_arcs(p_frozen_graph, arc_count);
+    }
+
+    allocator_free(tail_indices);
+    allocator_free(head_indices);
+    allocator_free(cursors);
+    allocator_free(last_tails);
+    TRY_REPORT_RETURN_STATUS(RETURN_STATUS_OK);
+    return p_frozen_graph;
+}
+
+/* Begin: parallel build. */
+
+/* The vertices are split into about this many blocks per worker: */
+static const size_t BLOCKS_PER_WORKER = 64;
+
+/* Up to this degree, repeated arcs are found by comparing all pairs: */
+static const size_t SMALL_DEGREE = 16;
+
+/*******************************************************************************
+* The arcs of one direction of the graph on their way through the parallel     *
+* build. For the forward direction the keys are the tails and the neighbors    *
+* the heads; for the backward direction, the other way round. The arcs are     *
+* first scattered into 'bucket_keys', 'bucket_neighbors' and 'bucket_weights'  *
+* grouped by the block of their key, then sorted by key into the arrays of the *
+* graph, and finally compacted back into the bucket arrays, which become the   *
+* arrays of the graph.                                                         *
+*******************************************************************************/
+typedef struct arc_buckets {
+    const vertex_id_t* keys;
+    const vertex_id_t* neighbors;
+    size_t*            histograms;    /* 'block_count' counters per worker. */
+    size_t*            block_offsets; /* Where the arcs of each block begin. */
+    size_t*            kept_offsets;  /* Ditto after merging repeated arcs. */
+    vertex_id_t*       bucket_keys;
+    vertex_id_t*       bucket_neighbors;
+    weight_t*          bucket_weights;
+    vertex_id_t*       kept_counts;   /* The degree of each vertex. */
+    size_t*            offsets;
+    vertex_id_t*       arc_neighbors;
+    weight_t*          arc_weights;
+    int                keeps_input_order;
+} arc_buckets;
+
+typedef struct parallel_build {
+    const vertex_id_t* tails;
+    const vertex_id_t* heads;
+    const weight_t*    weights;
+    size_t             edge_count;
+    size_t             worker_count;
+    vertex_id_t*       max_ids;  /* The largest ID seen by each worker. */
+    int*               statuses; /* The status of each worker. */
+    vertex_id_mapping  mapping;
+    vertex_id_t*       tail_indices;
+    vertex_id_t*       head_indices;
+    size_t             vertex_count;
+    size_t             block_shift;
+    size_t             block_count;
+    arc_buckets        directions[2];
+} parallel_build;
+
+typedef struct scratch_arc {
+    vertex_id_t neighbor;
+    weight_t    weight;
+    size_t      position;
+} scratch_arc;
+
+/* A per-worker buffer for merging the arcs of high-degree vertices: */
+typedef struct arc_scratch {
+    scratch_arc* arcs;
+    size_t       capacity;
+} arc_scratch;
+
+/* Returns where the share of 'worker_index' begins in 'count' items: */
+static size_t get_share_begin(size_t count,
+                              size_t worker_index,
+                              size_t worker_count)
+{
+    size_t remainder = count % worker_count;
+
+    return count / worker_count * worker_index +
+           (worker_index < remainder ? worker_index : remainder);
+}
+
+static int compare_scratch_arcs(const void* p_a, const void* p_b)
+{
+    const scratch_arc* p_arc_a = p_a;
+    const scratch_arc* p_arc_b = p_b;
+
+    if (p_arc_a->neighbor != p_arc_b->neighbor)
+    {
+        return p_arc_a->neighbor < p_arc_b->neighbor ? -1 : 1;
+    }
+
+    return p_arc_a->position < p_arc_b->position ? -1 :
+           (p_arc_a->position > p_arc_b->position ? 1 : 0);
+}
+
+/* Sorts by neighbor, keeping the input order among equal neighbors: */
+static void sort_scratch_arcs(scratch_arc* arcs, size_t count)
+{
+    size_t i;
+    size_t j;
+    scratch_arc arc;
+
+    if (count > SMALL_DEGREE)
+    {
+        qsort(arcs, count, sizeof(scratch_arc), compare_scratch_arcs);
+        return;
+    }
+
+    for (i = 1; i < count; ++i)
+    {
+        arc = arcs[i];
+
+        for (j = i; j > 0 && arcs[j - 1].neighbor > arc.neighbor; --j)
+        {
+            arcs[j] = arcs[j - 1];
+        }
+
+        arcs[j] = arc;
+    }
+}
+
+/*******************************************************************************
+* Merges the repeated arcs among the arcs [begin, end) of one vertex, which    *
+* are in input order, in place: the first occurrence of each arc stays, with   *
+* the weight of the last one. The arcs kept are moved to the front of the      *
+* range, in input order if 'keeps_input_order' is set and ordered by neighbor  *
+* otherwise, which matches the order 'frozen_graph_build' gives the backward   *
+* arcs. Returns the number of arcs kept, or (size_t) -1 if out of memory.      *
+*******************************************************************************/
+static size_t merge_repeated_arcs(vertex_id_t* neighbors,
+                                  weight_t* weights,
+                                  size_t begin,
+                                  size_t end,
+                                  int keeps_input_order,
+                                  arc_scratch* p_scratch)
+{
+    size_t count = end - begin;
+    size_t kept_end = begin;
+    size_t i;
+    size_t j;
+    size_t run_end;
+    scratch_arc* arcs;
+
+    if (count < 2)
+    {
+        return count;
+    }
+
+    if (keeps_input_order && count <= SMALL_DEGREE)
+    {
+        for (i = begin; i < end; ++i)
+        {
+            for (j = begin; j < kept_end && neighbors[j] != neighbors[i]; ++j)
+            {
+            }
+
+            if (j < kept_end)
+            {
+                weights[j] = weights[i];
+            }
+            else
+            {
+                neighbors[kept_end] = neighbors[i];
+                weights[kept_end++] = weights[i];
+            }
+        }
+
+        return kept_end - begin;
+    }
+
+    if (p_scratch->capacity < count)
+    {
+        arcs = allocator_realloc(p_scratch->arcs,
+                                 sizeof(scratch_arc) * 2 * count);
+
+        if (!arcs)
+        {
+            return (size_t) -1;
+        }
+
+        p_scratch->arcs = arcs;
+        p_scratch->capacity = 2 * count;
+    }
+
+    arcs = p_scratch->arcs;
+
+    for (i = 0; i < count; ++i)
+    {
+        arcs[i].neighbor = neighbors[begin + i];
+        arcs[i].weight = weights[begin + i];
+        arcs[i].position = begin + i;
+    }
+
+    sort_scratch_arcs(arcs, count);
+
+    for (i = 0; i < count; i = run_end)
+    {
+        for (run_end = i + 1;
+             run_end < count && arcs[run_end].neighbor == arcs[i].neighbor;
+             ++run_end)
+        {
+        }
+
+        if (keeps_input_order)
+        {
+            /* Mark the repetitions for removal: */
+            weights[arcs[i].position] = arcs[run_end - 1].weight;
+
+            for (j = i + 1; j < run_end; ++j)
+            {
+                neighbors[arcs[j].position] = VERTEX_ID_MAX;
+            }
+        }
+        else
+        {
+            neighbors[kept_end] = arcs[i].neighbor;
+            weights[kept_end] = arcs[run_end - 1].weight;
+        }
+
+        kept_end++;
+    }
+
+    if (keeps_input_order && kept_end < end)
+    {
+        kept_end = begin;
+
+        for (i = begin; i < end; ++i)
+        {
+            if (neighbors[i] != VERTEX_ID_MAX)
+            {
+                neighbors[kept_end] = neighbors[i];
+                weights[kept_end++] = weights[i];
+            }
+        }
+    }
+
+    return kept_end - begin;
+}
+
+static void find_max_id_task(void* p_argument,
+                             size_t worker_index,
+                             size_t worker_count)
+{
+    parallel_build* p_build = p_argument;
+
+    p_build->max_ids[worker_index] =
+            find_max_id(p_build->tails,
+                        p_build->heads,
+                        get_share_begin(p_build->edge_count,
+                                        worker_index,
+                                        worker_count),
+                        get_share_begin(p_build->edge_count,
+                                        worker_index + 1,
+                                        worker_count));
+}
+
+static void map_endpoints_task(void* p_argument,
+                               size_t worker_index,
+                               size_t worker_count)
+{
+    parallel_build* p_build = p_argument;
+
+    map_endpoints(&p_build->mapping,
+                  p_build->tails,
+                  p_build->heads,
+                  get_share_begin(p_build->edge_count,
+                                  worker_index,
+                                  worker_count),
+                  get_share_begin(p_build->edge_count,
+                                  worker_index + 1,
+                                  worker_count),
+                  p_build->tail_indices,
+                  p_build->head_indices);
+}
+
+/* Counts the arcs of the worker's share per block, in both directions: */
+static void count_arcs_task(void* p_argument,
+                            size_t worker_index,
+                            size_t worker_count)
+{
+    parallel_build* p_build = p_argument;
+    size_t begin = get_share_begin(p_build->edge_count,
+                                   worker_index,
+                                   worker_count);
+    size_t end = get_share_begin(p_build->edge_count,
+                                 worker_index + 1,
+                                 worker_count);
+    size_t direction;
+    size_t i;
+    size_t* histogram;
+    const vertex_id_t* keys;
+
+    for (direction = 0; direction < 2; ++direction)
+    {
+        histogram = p_build->directions[direction].histograms +
+                    worker_index * p_build->block_count;
+
+        keys = p_build->directions[direction].keys;
+
+        for (i = begin; i < end; ++i)
+        {
+            histogram[keys[i] >> p_build->block_shift]++;
+        }
+    }
+}
+
+/*******************************************************************************
+* Turns the histograms into the positions where each worker starts writing     *
+* the arcs of each block. The blocks follow each other, and within a block the *
+* shares of the workers follow each other, so the arcs keep their input order. *
+*******************************************************************************/
+static void compute_bucket_offsets(parallel_build* p_build,
+                                   arc_buckets* p_buckets)
+{
+    size_t block;
+    size_t worker_index;
+    size_t count;
+    size_t position = 0;
+    size_t* p_counter;
+
+    for (block = 0; block < p_build->block_count; ++block)
+    {
+        p_buckets->block_offsets[block] = position;
+
+        for (worker_index = 0;
+             worker_index < p_build->worker_count;
+             ++worker_index)
+        {
+            p_counter = &p_buckets->histograms[worker_index *
+                                               p_build->block_count + block];
+            count = *p_counter;
+            *p_counter = position;
+            position += count;
+        }
+    }
+
+    p_buckets->block_offsets[p_build->block_count] = position;
+}
+
+static void scatter_arcs_task(void* p_argument,
+                              size_t worker_index,
+                              size_t worker_count)
+{
+    parallel_build* p_build = p_argument;
+    size_t begin = get_share_begin(p_build->edge_count,
+                                   worker_index,
+                                   worker_count);
+    size_t end = get_share_begin(p_build->edge_count,
+                                 worker_index + 1,
+                                 worker_count);
+    size_t direction;
+    size_t i;
+    size_t position;
+    size_t* cursors;
+    arc_buckets* p_buckets;
+
+    for (direction = 0; direction < 2; ++direction)
+    {
+        p_buckets = &p_build->directions[direction];
+        cursors = p_buckets->histograms + worker_index * p_build->block_count;
+
+        for (i = begin; i < end; ++i)
+        {
+            position = cursors[p_buckets->keys[i] >> p_build->block_shift]++;
+            p_buckets->bucket_keys[position] = p_buckets->keys[i];
+            p_buckets->bucket_neighbors[position] = p_buckets->neighbors[i];
+            p_buckets->bucket_weights[position] = p_build->weights[i];
+        }
+    }
+}
+
+/*******************************************************************************
+* Sorts the arcs of one block by key into the arrays of the graph with a       *
+* counting sort and merges the repeated arcs of each vertex. The block owns    *
+* the offsets of its vertices, so no other worker touches them. Leaves the end *
+* of the arcs of each vertex in 'offsets', its degree in 'kept_counts' and the *
+* number of arcs kept in 'kept_offsets[block]'.                                *
+*******************************************************************************/
+static int sort_block(parallel_build* p_build,
+                      arc_buckets* p_buckets,
+                      size_t block,
+                      arc_scratch* p_scratch)
+{
+    size_t first_vertex = block << p_build->block_shift;
+    size_t end_vertex = first_vertex + ((size_t) 1 << p_build->block_shift);
+    size_t begin = p_buckets->block_offsets[block];
+    size_t end = p_buckets->block_offsets[block + 1];
+    size_t* offsets = p_buckets->offsets;
+    size_t kept_total = 0;
+    size_t vertex;
+    size_t i;
+    size_t count;
+    size_t position;
+    size_t arc_begin;
+    size_t kept;
+
+    if (end_vertex > p_build->vertex_count)
+    {
+        end_vertex = p_build->vertex_count;
+    }
+
+    for (vertex = first_vertex; vertex < end_vertex; ++vertex)
+    {
+        offsets[vertex] = 0;
+    }
+
+    for (i = begin; i < end; ++i)
+    {
+        offsets[p_buckets->bucket_keys[i]]++;
+    }
+
+    position = begin;
+
+    for (vertex = first_vertex; vertex < end_vertex; ++vertex)
+    {
+        count = offsets[vertex];
+        offsets[vertex] = position;
+        position += count;
+    }
+
+    for (i = begin; i < end; ++i)
+    {
+        position = offsets[p_buckets->bucket_keys[i]]++;
+        p_buckets->arc_neighbors[position] = p_buckets->bucket_neighbors[i];
+        p_buckets->arc_weights[position] = p_buckets->bucket_weights[i];
+    }
+
+    arc_begin = begin;
+
+    for (vertex = first_vertex; vertex < end_vertex; ++vertex)
+    {
+        kept = merge_repeated_arcs(p_buckets->arc_neighbors,
+                                   p_buckets->arc_weights,
+                                   arc_begin,
+                                   offsets[vertex],
+                                   p_buckets->keeps_input_order,
+                                   p_scratch);
+
+        if (kept == (size_t) -1)
+        {
+            return FALSE;
+        }
+
+        p_buckets->kept_counts[vertex] = (vertex_id_t) kept;
+        kept_total += kept;
+        arc_begin = offsets[vertex];
+    }
+
+    p_buckets->kept_offsets[block] = kept_total;
+    return TRUE;
+}
+
+static void sort_blocks_task(void* p_argument,
+                             size_t worker_index,
+                             size_t worker_count)
+{
+    parallel_build* p_build = p_argument;
+    arc_scratch scratch;
+    size_t block;
+
+    scratch.arcs = NULL;
+    scratch.capacity = 0;
+    p_build->statuses[worker_index] = RETURN_STATUS_OK;
+
+    /* Deal the blocks round robin, which evens out dense regions: */
+    for (block = worker_index;
+         block < p_build->block_count;
+         block += worker_count)
+    {
+        if (!sort_block(p_build, &p_build->directions[0], block, &scratch) ||
+            !sort_block(p_build, &p_build->directions[1], block, &scratch))
+        {
+            p_build->statuses[worker_index] = RETURN_STATUS_NO_MEMORY;
+            break;
+        }
+    }
+
+    allocator_free(scratch.arcs);
+}
+
+static void compute_kept_offsets(parallel_build* p_build,
+                                 arc_buckets* p_buckets)
+{
+    size_t block;
+    size_t count;
+    size_t position = 0;
+
+    for (block = 0; block < p_build->block_count; ++block)
+    {
+        count = p_buckets->kept_offsets[block];
+        p_buckets->kept_offsets[block] = position;
+        position += count;
+    }
+
+    p_buckets->kept_offsets[p_build->block_count] = position;
+}
+
+/* Moves the arcs kept in one block to their final place: */
+static void compact_block(parallel_build* p_build,
+                          arc_buckets* p_buckets,
+                          size_t block)
+{
+    size_t first_vertex = block << p_build->block_shift;
+    size_t end_vertex = first_vertex + ((size_t) 1 << p_build->block_shift);
+    size_t arc_begin = p_buckets->block_offsets[block];
+    size_t destination = p_buckets->kept_offsets[block];
+    size_t arc_end;
+    size_t kept;
+    size_t vertex;
+
+    if (end_vertex > p_build->vertex_count)
+    {
+        end_vertex = p_build->vertex_count;
+    }
+
+    for (vertex = first_vertex; vertex < end_vertex; ++vertex)
+    {
+        arc_end = p_buckets->offsets[vertex];
+        kept = p_buckets->kept_counts[vertex];
+
+        memcpy(p_buckets->bucket_neighbors + destination,
+               p_buckets->arc_neighbors + arc_begin,
+               sizeof(vertex_id_t) * kept);
+
+        memcpy(p_buckets->bucket_weights + destination,
+               p_buckets->arc_weights + arc_begin,
+               sizeof(weight_t) * kept);
+
+        p_buckets->offsets[vertex] = destination;
+        destination += kept;
+        arc_begin = arc_end;
+    }
+}
+
+static void compact_blocks_task(void* p_argument,
+                                size_t worker_index,
+                                size_t worker_count)
+{
+    parallel_build* p_build = p_argument;
+    size_t block;
+
+    for (block = worker_index;
+         block < p_build->block_count;
+         block += worker_count)
+    {
+        compact_block(p_build, &p_build->directions[0], block);
+        compact_block(p_build, &p_build->directions[1], block);
+    }
+}
+
+static void free_arc_buckets(arc_buckets* p_buckets)
+{
+    allocator_free(p_buckets->histograms);
+    allocator_free(p_buckets->block_offsets);
+    allocator_free(p_buckets->kept_offsets);
+    allocator_free(p_buckets->bucket_keys);
+    allocator_free(p_buckets->bucket_neighbors);
+    allocator_free(p_buckets->bucket_weights);
+    allocator_free(p_buckets->kept_counts);
+}
+
+static int alloc_arc_buckets(parallel_build* p_build, arc_buckets* p_buckets)
+{
+    size_t block_count = p_build->block_count;
+    size_t edge_count = p_build->edge_count;
+
+    p_buckets->histograms =
+            allocator_calloc(p_build->worker_count * block_count,
+                             sizeof(size_t));
+    p_buckets->block_offsets =
+            allocator_malloc(sizeof(size_t) * (block_count + 1));
+    p_buckets->kept_offsets =
+            allocator_malloc(sizeof(size_t) * (block_count + 1));
+    p_buckets->bucket_keys =
+            allocator_malloc(sizeof(vertex_id_t) * (edge_count + 1));
+    p_buckets->bucket_neighbors =
+            allocator_malloc(sizeof(vertex_id_t) * (edge_count + 1));
+    p_buckets->bucket_weights =
+            allocator_malloc(sizeof(weight_t) * (edge_count + 1));
+    p_buckets->kept_counts =
+            allocator_malloc(sizeof(vertex_id_t) * p_build->vertex_count);
+
+    return p_buckets->histograms       &&
+           p_buckets->block_offsets    &&
+           p_buckets->kept_offsets     &&
+           p_buckets->bucket_keys      &&
+           p_buckets->bucket_neighbors &&
+           p_buckets->bucket_weights   &&
+           p_buckets->kept_counts;
+}
+
+static void free_parallel_build(parallel_build* p_build)
+{
+    allocator_free(p_build->max_ids);
+    allocator_free(p_build->statuses);
+    allocator_free(p_build->mapping.index_of);
+    allocator_free(p_build->mapping.vertex_ids);
+    allocator_free(p_build->tail_indices);
+    allocator_free(p_build->head_indices);
+    free_arc_buckets(&p_build->directions[0]);
+    free_arc_buckets(&p_build->directions[1]);
+}
+
+/* Maps the IDs in parallel, apart from building the mapping itself: */
+static int map_vertex_ids_in_parallel(parallel_build* p_build,
+                                      worker_pool* p_pool)
+{
+    vertex_id_t max_id = 0;
+    size_t worker_index;
+
+    worker_pool_run(p_pool, find_max_id_task, p_build);
+
+    for (worker_index = 0;
+         worker_index < p_build->worker_count;
+         ++worker_index)
+    {
+        if (max_id < p_build->max_ids[worker_index])
+        {
+            max_id = p_build->max_ids[worker_index];
+        }
+    }
+
+    if (!build_vertex_id_mapping(p_build->tails,
+                                 p_build->heads,
+                                 p_build->edge_count,
+                                 max_id,
+                                 &p_build->mapping))
+    {
+        return FALSE;
+    }
+
+    worker_pool_run(p_pool, map_endpoints_task, p_build);
+    p_build->vertex_count = p_build->mapping.vertex_count;
+    return TRUE;
+}
+
+/* Splits the vertices into about BLOCKS_PER_WORKER blocks per worker: */
+static void choose_blocks(parallel_build* p_build)
+{
+    size_t target_block_count = BLOCKS_PER_WORKER * p_build->worker_count;
+
+    p_build->block_shift = 0;
+
+    while ((p_build->vertex_count >> p_build->block_shift) >
+           target_block_count)
+    {
+        p_build->block_shift++;
+    }
+
+    p_build->block_count =
+            ((p_build->vertex_count - 1) >> p_build->block_shift) + 1;
+}
+
+/* Points the graph at the compacted arcs of one direction: */
+static void adopt_arcs(parallel_build* p_build,
+                       arc_buckets* p_buckets,
+                       vertex_id_t** p_neighbors,
+                       weight_t** p_weights)
+{
+    p_buckets->offsets[p_build->vertex_count] =
+            p_buckets->kept_offsets[p_build->block_count];
+
+    allocator_free(*p_neighbors);
+    allocator_free(*p_weights);
+    *p_neighbors = p_buckets->bucket_neighbors;
+    *p_weights = p_buckets->bucket_weights;
+    p_buckets->bucket_neighbors = NULL;
+    p_buckets->bucket_weights = NULL;
+}
+
+static void init_arc_buckets(arc_buckets* p_buckets,
+                             const vertex_id_t* keys,
+                             const vertex_id_t* neighbors,
+                             size_t* offsets,
+                             vertex_id_t* arc_neighbors,
+                             weight_t* arc_weights,
+                             int keeps_input_order)
+{
+    memset(p_buckets, 0, sizeof(*p_buckets));
+    p_buckets->keys = keys;
+    p_buckets->neighbors = neighbors;
+    p_buckets->offsets = offsets;
+    p_buckets->arc_neighbors = arc_neighbors;
+    p_buckets->arc_weights = arc_weights;
+    p_buckets->keeps_input_order = keeps_input_order;
+}
+
+frozen_graph* frozen_graph_build_parallel(const vertex_id_t* tails,
+                                          const vertex_id_t* heads,
+                                          const weight_t* weights,
+                                          size_t edge_count,
+                                          worker_pool* p_pool,
+                                          int* p_return_status)
+{
+    parallel_build build;
+    frozen_graph* p_frozen_graph = NULL;
+    size_t worker_count = p_pool ? worker_pool_size(p_pool) : 1;
+    size_t worker_index;
+    size_t arc_count;
+
+    if (worker_count == 1 || edge_count < worker_count)
+    {
+        return frozen_graph_build(tails,
+                                  heads,
+                                  weights,
+                                  edge_count,
+                                  p_return_status);
+    }
+
+    memset(&build, 0, sizeof(build));
+    build.tails = tails;
+    build.heads = heads;
+    build.weights = weights;
+    build.edge_count = edge_count;
+    build.worker_count = worker_count;
+    build.max_ids = allocator_malloc(sizeof(vertex_id_t) * worker_count);
+    build.statuses = allocator_malloc(sizeof(int) * worker_count);
+    build.tail_indices = allocator_malloc(sizeof(vertex_id_t) * edge_count);
+    build.head_indices = allocator_malloc(sizeof(vertex_id_t) * edge_count);
+
+    if (build.max_ids      &&
+        build.statuses     &&
+        build.tail_indices &&
+        build.head_indices &&
+        map_vertex_ids_in_parallel(&build, p_pool))
+    {
+        p_frozen_graph = frozen_graph_alloc(build.vertex_count, edge_count);
+    }
+
+    if (p_frozen_graph)
+    {
+        init_arc_buckets(&build.directions[0],
+                         build.tail_indices,
+                         build.head_indices,
+                         p_frozen_graph->forward_offsets,
+                         p_frozen_graph->forward_heads,
+                         p_frozen_graph->forward_weights,
+                         TRUE);
+
+        init_arc_buckets(&build.directions[1],
+                         build.head_indices,
+                         build.tail_indices,
+                         p_frozen_graph->backward_offsets,
+                         p_frozen_graph->backward_heads,
+                         p_frozen_graph->backward_weights,
+                         FALSE);
+
+        choose_blocks(&build);
+
+        if (!alloc_arc_buckets(&build, &build.directions[0]) ||
+            !alloc_arc_buckets(&build, &build.directions[1]))
+        {
+            frozen_graph_free(p_frozen_graph);
+            p_frozen_graph = NULL;
+        }
+    }
+
+    if (!p_frozen_graph)
+    {
+        free_parallel_build(&build);
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    worker_pool_run(p_pool, count_arcs_task, &build);
+    compute_bucket_offsets(&build, &build.directions[0]);
+    compute_bucket_offsets(&build, &build.directions[1]);
+    worker_pool_run(p_pool, scatter_arcs_task, &build);
+    worker_pool_run(p_pool, sort_blocks_task, &build);
+
+    for (worker_index = 0; worker_index < worker_count; ++worker_index)
+    {
+        if (build.statuses[worker_index] != RETURN_STATUS_OK)
+        {
+            frozen_graph_free(p_frozen_graph);
+            free_parallel_build(&build);
+            TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+            return NULL;
+        }
+    }
+
+    compute_kept_offsets(&build, &build.directions[0]);
+    compute_kept_offsets(&build, &build.directions[1]);
+    worker_pool_run(p_pool, compact_blocks_task, &build);
+
+    adopt_arcs(&build,
+               &build.directions[0],
+               &p_frozen_graph->forward_heads,
+               &p_frozen_graph->forward_weights);
+
+    adopt_arcs(&build,
+               &build.directions[1],
+               &p_frozen_graph->backward_heads,
+               &p_frozen_graph->backward_weights);
+
+    allocator_free(p_frozen_graph->vertex_ids);
+    p_frozen_graph->vertex_ids = build.mapping.vertex_ids;
+    build.mapping.vertex_ids = NULL;
+
+    arc_count = build.directions[0].kept_offsets[build.block_count];
+
+    if (arc_count < edge_count)
+    {
+        shrink_arcs(p_frozen_graph, arc_count);
+    }
+
+    free_parallel_build(&build);
+    TRY_REPORT_RETURN_STATUS(RETURN_STATUS_OK);
+    return p_frozen_graph;
+}
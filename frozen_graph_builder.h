@@ -0,0 +1,45 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_BUILDER_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_BUILDER_H
+
+#include "frozen_graph.h"
+#include "types.h"
+#include "worker_pool.h"
+#include <stdlib.h>
+
+/*******************************************************************************
+* Builds a frozen graph straight from 'edge_count' arcs given as parallel      *
+* arrays of tail IDs, head IDs and weights, without going through a 'Graph'.   *
+* The vertices are the distinct endpoints, indexed in increasing ID order as   *
+* 'graph_freeze' does. An arc that occurs several times keeps the weight of    *
+* its last occurrence. The arcs are bucketed by counting sort, so apart from   *
+* mapping the IDs the build runs in linear time. Returns NULL on failure,      *
+* storing RETURN_STATUS_NO_MEMORY in '*p_return_status' if it is not NULL.     *
+*******************************************************************************/
+frozen_graph* frozen_graph_build(const vertex_id_t* tails,
+                                 const vertex_id_t* heads,
+                                 const weight_t* weights,
+                                 size_t edge_count,
+                                 int* p_return_status);
+
+/*******************************************************************************
+* Builds the same graph as 'frozen_graph_build' with the workers of 'p_pool'.  *
+* Every pass over the arcs is split among the workers, and each pass handles   *
+* the forward and the backward arrays together:                                *
+*   1. the workers count the arcs of their share per block of vertices in      *
+*      private histograms, both by tail and by head,                           *
+*   2. a prefix sum over the histograms gives each worker its own range of     *
+*      every block, where it scatters its arcs,                                *
+*   3. the workers sort the blocks by vertex, merge the repeated arcs, and     *
+*      compact the arcs into place.                                            *
+* Only building the ID-to-index mapping, a single pass, runs serially. The     *
+* build needs about twice the memory of the serial one. Falls back to          *
+* 'frozen_graph_build' if the pool has a single worker or 'p_pool' is NULL.    *
+*******************************************************************************/
+frozen_graph* frozen_graph_build_parallel(const vertex_id_t* tails,
+                                          const vertex_id_t* heads,
+                                          const weight_t* weights,
+                                          size_t edge_count,
+                                          worker_pool* p_pool,
+                                          int* p_return_status);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_BUILDER_H */
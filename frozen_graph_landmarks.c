@@ -0,0 +1,961 @@
+#include "frozen_graph_landmarks.h"
+#include "allocator.h"
+#include "index_heap.h"
+#include "types.h"
+#include "util.h"
+#include "vertex_bitset.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The distance stored for the vertices a search does not reach: */
+#define NO_DISTANCE ((distance_t) -1)
+
+#define HEAP_DEGREE 4
+
+/* The number of random roots the avoid selection tries for each landmark: */
+#define AVOID_ROOT_ATTEMPTS 8
+
+/* The heap of one search, with the positions it keeps for decrease-key: */
+typedef struct search_workspace {
+    index_heap*  p_heap;
+    vertex_id_t* positions;
+    distance_t*  distances;
+} search_workspace;
+
+/*******************************************************************************
+* The state of a build shared by the workers. Job 'j' computes the distances   *
+* from the landmark 'j / 2' if 'j' is even, and to it otherwise, and copies    *
+* them into the rows of the table, whose width is 'row_size'.                  *
+*******************************************************************************/
+typedef struct landmark_build {
+    const frozen_graph* p_frozen_graph;
+    const vertex_id_t*  landmarks;
+    distance_t*         rows;
+    size_t              row_size;
+    search_workspace*   workspaces; /* One per worker. */
+    int*                statuses;   /* One per worker. */
+    size_t              first_job;
+    size_t              job_count;
+} landmark_build;
+
+static int workspace_init(search_workspace* p_workspace, size_t vertex_count)
+{
+    p_workspace->p_heap = index_heap_alloc(HEAP_DEGREE, 1024);
+    p_workspace->positions =
+            allocator_malloc(sizeof(vertex_id_t) * (vertex_count + 1));
+    p_workspace->distances =
+            allocator_malloc(sizeof(distance_t) * (vertex_count + 1));
+
+    if (!p_workspace->p_heap || !p_workspace->positions ||
+        !p_workspace->distances)
+    {
+        return FALSE;
+    }
+
+    index_heap_set_positions(p_workspace->p_heap,
+                             p_workspace->positions,
+                             sizeof(vertex_id_t));
+    return TRUE;
+}
+
+static void workspace_destroy(search_workspace* p_workspace)
+{
+    index_heap_free(p_workspace->p_heap);
+    allocator_free(p_workspace->positions);
+    allocator_free(p_workspace->distances);
+}
+
+static int has_arcs(const frozen_graph* p_frozen_graph, size_t index)
+{
+    return p_frozen_graph->forward_offsets[index + 1] >
+           p_frozen_graph->forward_offsets[index] ||
+           p_frozen_graph->backward_offsets[index + 1] >
+           p_frozen_graph->backward_offsets[index];
+}
+
+/*******************************************************************************
+* Runs Dijkstra's algorithm from 'source_index' over the out-arcs if 'forward' *
+* is set and over the in-arcs otherwise, storing the distance of each vertex   *
+* in 'distances'. Unless 'parents' is NULL, also stores the shortest path tree *
+* and lists the vertices in the order they are settled in 'order', their       *
+* number in '*p_settled_count'. No settled set is needed: the distance of a    *
+* settled vertex is never improved.                                            *
+*******************************************************************************/
+static int compute_distances(const frozen_graph* p_frozen_graph,
+                             size_t source_index,
+                             int forward,
+                             distance_t* distances,
+                             vertex_id_t* parents,
+                             vertex_id_t* order,
+                             size_t* p_settled_count,
+                             index_heap* p_heap)
+{
+    const size_t* offsets = forward ? p_frozen_graph->forward_offsets :
+                                      p_frozen_graph->backward_offsets;
+    const vertex_id_t* heads = forward ? p_frozen_graph->forward_heads :
+                                         p_frozen_graph->backward_heads;
+    const weight_t* weights = forward ? p_frozen_graph->forward_weights :
+                                        p_frozen_graph->backward_weights;
+    size_t settled_count = 0;
+    size_t current_index;
+    size_t neighbor_index;
+    size_t arc;
+    size_t i;
+    distance_t distance;
+
+    for (i = 0; i < p_frozen_graph->vertex_count; ++i)
+    {
+        distances[i] = NO_DISTANCE;
+    }
+
+    index_heap_clear(p_heap);
+    distances[source_index] = 0;
+
+    if (parents)
+    {
+        parents[source_index] = (vertex_id_t) source_index;
+    }
+
+    if (index_heap_add(p_heap, (vertex_id_t) source_index, 0.0) !=
+        RETURN_STATUS_OK)
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    while (index_heap_size(p_heap) > 0)
+    {
+        current_index = index_heap_extract_min(p_heap);
+
+        if (order)
+        {
+            order[settled_count] = (vertex_id_t) current_index;
+        }
+
+        settled_count++;
+
+        for (arc = offsets[current_index];
+             arc < offsets[current_index + 1];
+             ++arc)
+        {
+            neighbor_index = heads[arc];
+            distance = distances[current_index] + weights[arc];
+
+            if (distances[neighbor_index] == NO_DISTANCE)
+            {
+                if (index_heap_add(p_heap,
+                                   (vertex_id_t) neighbor_index,
+                                   distance) != RETURN_STATUS_OK)
+                {
+                    return RETURN_STATUS_NO_MEMORY;
+                }
+            }
+            else if (distance < distances[neighbor_index])
+            {
+                index_heap_decrease_key(p_heap,
+                                        (vertex_id_t) neighbor_index,
+                                        distance);
+            }
+            else
+            {
+                continue;
+            }
+
+            distances[neighbor_index] = distance;
+
+            if (parents)
+            {
+                parents[neighbor_index] = (vertex_id_t) current_index;
+            }
+        }
+    }
+
+    if (p_settled_count)
+    {
+        *p_settled_count = settled_count;
+    }
+
+    return RETURN_STATUS_OK;
+}
+
+static void compute_rows_task(void* p_argument,
+                              size_t worker_index,
+                              size_t worker_count)
+{
+    landmark_build* p_build = p_argument;
+    search_workspace* p_workspace = &p_build->workspaces[worker_index];
+    size_t landmark_count = p_build->row_size / 2;
+    size_t vertex_count = p_build->p_frozen_graph->vertex_count;
+    size_t column;
+    size_t job;
+    size_t i;
+
+    for (job = p_build->first_job + worker_index;
+         job < p_build->first_job + p_build->job_count;
+         job += worker_count)
+    {
+        if (compute_distances(p_build->p_frozen_graph,
+                              p_build->landmarks[job / 2],
+                              job % 2 == 0,
+                              p_workspace->distances,
+                              NULL,
+                              NULL,
+                              NULL,
+                              p_workspace->p_heap) != RETURN_STATUS_OK)
+        {
+            p_build->statuses[worker_index] = RETURN_STATUS_NO_MEMORY;
+            return;
+        }
+
+        column = job / 2 + (job % 2 == 0 ? 0 : landmark_count);
+
+        for (i = 0; i < vertex_count; ++i)
+        {
+            p_build->rows[i * p_build->row_size + column] =
+                    p_workspace->distances[i];
+        }
+    }
+}
+
+/* Fills the table columns of the jobs [first_job, first_job + job_count): */
+static int compute_rows(landmark_build* p_build,
+                        size_t first_job,
+                        size_t job_count,
+                        worker_pool* p_pool)
+{
+    size_t worker_count = p_pool ? worker_pool_size(p_pool) : 1;
+    size_t worker_index;
+
+    p_build->first_job = first_job;
+    p_build->job_count = job_count;
+
+    for (worker_index = 0; worker_index < worker_count; ++worker_index)
+    {
+        p_build->statuses[worker_index] = RETURN_STATUS_OK;
+    }
+
+    if (p_pool)
+    {
+        worker_pool_run(p_pool, compute_rows_task, p_build);
+    }
+    else
+    {
+        compute_rows_task(p_build, 0, 1);
+    }
+
+    for (worker_index = 0; worker_index < worker_count; ++worker_index)
+    {
+        if (p_build->statuses[worker_index] != RETURN_STATUS_OK)
+        {
+            return p_build->statuses[worker_index];
+        }
+    }
+
+    return RETURN_STATUS_OK;
+}
+
+/*******************************************************************************
+* Returns the bound the first 'landmark_count' landmarks of a table give on    *
+* the distance from the vertex of 'from_row' to the vertex of 'to_row'. The    *
+* distances to the landmarks start at 'row_size / 2' in each row. A landmark   *
+* that reaches only one of the two vertices, or that only one of them reaches, *
+* shows there is no path, but only in the one direction.                       *
+*******************************************************************************/
+static double compute_bound(const distance_t* from_row,
+                            const distance_t* to_row,
+                            size_t landmark_count,
+                            size_t row_size)
+{
+    const distance_t* from_row_back = from_row + row_size / 2;
+    const distance_t* to_row_back = to_row + row_size / 2;
+    double bound = 0.0;
+    double term;
+    size_t i;
+
+    for (i = 0; i < landmark_count; ++i)
+    {
+        /* d(L, to) >= d(L, from) - d(from, to): */
+        if (from_row[i] != NO_DISTANCE)
+        {
+            if (to_row[i] == NO_DISTANCE)
+            {
+                return HUGE_VAL;
+            }
+
+            term = (double) to_row[i] - from_row[i];
+
+            if (bound < term)
+            {
+                bound = term;
+            }
+        }
+
+        /* d(from, L) <= d(from, to) + d(to, L): */
+        if (to_row_back[i] != NO_DISTANCE)
+        {
+            if (from_row_back[i] == NO_DISTANCE)
+            {
+                return HUGE_VAL;
+            }
+
+            term = (double) from_row_back[i] - to_row_back[i];
+
+            if (bound < term)
+            {
+                bound = term;
+            }
+        }
+    }
+
+    return bound;
+}
+
+static double landmark_distance_bound(const void* p_data,
+                                      size_t from_index,
+                                      size_t to_index)
+{
+    const frozen_graph* p_frozen_graph =
+            ((const landmark_bound*) p_data)->p_frozen_graph;
+    size_t row_size = 2 * p_frozen_graph->landmark_count;
+
+    return compute_bound(
+            p_frozen_graph->landmark_distances + row_size * from_index,
+            p_frozen_graph->landmark_distances + row_size * to_index,
+            p_frozen_graph->landmark_count,
+            row_size);
+}
+
+void landmark_bound_init(landmark_bound* p_landmark_bound,
+                         const frozen_graph* p_frozen_graph)
+{
+    p_landmark_bound->bound.function = landmark_distance_bound;
+    p_landmark_bound->bound.p_data = p_landmark_bound;
+    p_landmark_bound->p_frozen_graph = p_frozen_graph;
+}
+
+/*******************************************************************************
+* Lowers 'distances', the distances from the landmarks chosen so far with the  *
+* arcs taken in both directions, to the distances from 'source_index'. The     *
+* search does not go past the vertices that are closer to an earlier one, so   *
+* each landmark costs a search of its own region only.                         *
+* 'p_queued' marks the vertices that have entered the heap.                    *
+*******************************************************************************/
+static int lower_distances(const frozen_graph* p_frozen_graph,
+                           size_t source_index,
+                           distance_t* distances,
+                           vertex_bitset* p_queued,
+                           index_heap* p_heap)
+{
+    const size_t* offsets;
+    const vertex_id_t* heads;
+    const weight_t* weights;
+    size_t current_index;
+    size_t neighbor_index;
+    size_t arc;
+    int direction;
+    distance_t distance;
+
+    index_heap_clear(p_heap);
+    vertex_bitset_clear(p_queued);
+    distances[source_index] = 0;
+    vertex_bitset_add(p_queued, source_index);
+
+    if (index_heap_add(p_heap, (vertex_id_t) source_index, 0.0) !=
+        RETURN_STATUS_OK)
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    while (index_heap_size(p_heap) > 0)
+    {
+        current_index = index_heap_extract_min(p_heap);
+
+        for (direction = 0; direction < 2; ++direction)
+        {
+            if (direction == 0)
+            {
+                offsets = p_frozen_graph->forward_offsets;
+                heads = p_frozen_graph->forward_heads;
+                weights = p_frozen_graph->forward_weights;
+            }
+            else
+            {
+                offsets = p_frozen_graph->backward_offsets;
+                heads = p_frozen_graph->backward_heads;
+                weights = p_frozen_graph->backward_weights;
+            }
+
+            for (arc = offsets[current_index];
+                 arc < offsets[current_index + 1];
+                 ++arc)
+            {
+                neighbor_index = heads[arc];
+                distance = distances[current_index] + weights[arc];
+
+                if (distances[neighbor_index] != NO_DISTANCE &&
+                    distances[neighbor_index] <= distance)
+                {
+                    continue;
+                }
+
+                if (VERTEX_BITSET_CONTAINS(p_queued, neighbor_index))
+                {
+                    index_heap_decrease_key(p_heap,
+                                            (vertex_id_t) neighbor_index,
+                                            distance);
+                }
+                else
+                {
+                    if (index_heap_add(p_heap,
+                                       (vertex_id_t) neighbor_index,
+                                       distance) != RETURN_STATUS_OK)
+                    {
+                        return RETURN_STATUS_NO_MEMORY;
+                    }
+
+                    vertex_bitset_add(p_queued, neighbor_index);
+                }
+
+                distances[neighbor_index] = distance;
+            }
+        }
+    }
+
+    return RETURN_STATUS_OK;
+}
+
+/*******************************************************************************
+* Returns the vertex with arcs that is farthest from the landmarks chosen so   *
+* far, preferring one they do not reach at all, or the vertex count if every   *
+* vertex with arcs is at distance zero.                                        *
+*******************************************************************************/
+static size_t find_farthest_vertex(const frozen_graph* p_frozen_graph,
+                                   const distance_t* distances)
+{
+    size_t farthest_index = p_frozen_graph->vertex_count;
+    distance_t farthest_distance = 0;
+    size_t i;
+
+    for (i = 0; i < p_frozen_graph->vertex_count; ++i)
+    {
+        if (!has_arcs(p_frozen_graph, i))
+        {
+            continue;
+        }
+
+        if (distances[i] == NO_DISTANCE)
+        {
+            return i;
+        }
+
+        if (farthest_distance < distances[i])
+        {
+            farthest_distance = distances[i];
+            farthest_index = i;
+        }
+    }
+
+    return farthest_index;
+}
+
+/* Chooses the landmarks given 'distances', which must be all NO_DISTANCE: */
+static int choose_farthest(const frozen_graph* p_frozen_graph,
+                           vertex_id_t* landmarks,
+                           size_t landmark_count,
+                           size_t* p_selected_count,
+                           distance_t* distances,
+                           vertex_bitset* p_queued,
+                           index_heap* p_heap)
+{
+    size_t vertex_count = p_frozen_graph->vertex_count;
+    size_t selected_count = 0;
+    size_t candidate;
+    size_t i;
+
+    /* Start from the vertex farthest from the first one that has arcs: */
+    candidate = find_farthest_vertex(p_frozen_graph, distances);
+
+    if (candidate < vertex_count)
+    {
+        if (lower_distances(p_frozen_graph,
+                            candidate,
+                            distances,
+                            p_queued,
+                            p_heap) != RETURN_STATUS_OK)
+        {
+            return RETURN_STATUS_NO_MEMORY;
+        }
+
+        i = find_farthest_vertex(p_frozen_graph, distances);
+        candidate = i < vertex_count ? i : candidate;
+
+        for (i = 0; i < vertex_count; ++i)
+        {
+            distances[i] = NO_DISTANCE;
+        }
+    }
+
+    while (selected_count < landmark_count && candidate < vertex_count)
+    {
+        landmarks[selected_count++] = (vertex_id_t) candidate;
+
+        if (lower_distances(p_frozen_graph,
+                            candidate,
+                            distances,
+                            p_queued,
+                            p_heap) != RETURN_STATUS_OK)
+        {
+            return RETURN_STATUS_NO_MEMORY;
+        }
+
+        candidate = find_farthest_vertex(p_frozen_graph, distances);
+    }
+
+    *p_selected_count = selected_count;
+    return RETURN_STATUS_OK;
+}
+
+static int select_farthest(const frozen_graph* p_frozen_graph,
+                           vertex_id_t* landmarks,
+                           size_t landmark_count,
+                           size_t* p_selected_count,
+                           index_heap* p_heap)
+{
+    size_t vertex_count = p_frozen_graph->vertex_count;
+    distance_t* distances =
+            allocator_malloc(sizeof(distance_t) * (vertex_count + 1));
+    vertex_bitset queued;
+    size_t i;
+    int status = RETURN_STATUS_NO_MEMORY;
+
+    vertex_bitset_init(&queued);
+
+    if (distances &&
+        vertex_bitset_reserve(&queued, vertex_count) == RETURN_STATUS_OK)
+    {
+        for (i = 0; i < vertex_count; ++i)
+        {
+            distances[i] = NO_DISTANCE;
+        }
+
+        status = choose_farthest(p_frozen_graph,
+                                 landmarks,
+                                 landmark_count,
+                                 p_selected_count,
+                                 distances,
+                                 &queued,
+                                 p_heap);
+    }
+
+    allocator_free(distances);
+    vertex_bitset_destroy(&queued);
+    return status;
+}
+
+/* A small deterministic generator, so that builds repeat exactly: */
+static size_t next_random(unsigned long* p_state, size_t bound)
+{
+    *p_state = *p_state * 1103515245UL + 12345UL;
+    return (size_t)((*p_state >> 16) & 0x7fffffffUL) % bound;
+}
+
+/*******************************************************************************
+* Chooses the next landmark with the avoid heuristic of Goldberg and Werneck.  *
+* The weight of a vertex of the shortest path tree from 'root_index' is the    *
+* gap between its distance and the bound the landmarks chosen so far give on   *
+* it; the size of a vertex is the total weight of its subtree, or zero if the  *
+* subtree holds a landmark. Returns the leaf reached by walking down from the  *
+* root to the child of largest size, or the vertex count if the root has no    *
+* child of positive size.                                                      *
+*******************************************************************************/
+static size_t find_avoided_vertex(const frozen_graph* p_frozen_graph,
+                                  size_t root_index,
+                                  const landmark_build* p_build,
+                                  size_t selected_count,
+                                  const unsigned char* is_landmark,
+                                  distance_t* distances,
+                                  vertex_id_t* parents,
+                                  vertex_id_t* order,
+                                  double* sizes,
+                                  unsigned char* holds_landmark,
+                                  size_t settled_count)
+{
+    size_t vertex_count = p_frozen_graph->vertex_count;
+    const distance_t* root_row = p_build->rows + p_build->row_size * root_index;
+    size_t current_index = root_index;
+    size_t best_index;
+    size_t index;
+    size_t arc;
+    size_t i;
+    double weight;
+
+    for (i = 0; i < settled_count; ++i)
+    {
+        sizes[order[i]] = 0.0;
+        holds_landmark[order[i]] = is_landmark[order[i]];
+    }
+
+    /* The children are settled after their parents: */
+    for (i = settled_count; i > 0; --i)
+    {
+        index = order[i - 1];
+
+        if (holds_landmark[index])
+        {
+            sizes[index] = 0.0;
+        }
+        else
+        {
+            weight = distances[index] -
+                     compute_bound(root_row,
+                                   p_build->rows + p_build->row_size * index,
+                                   selected_count,
+                                   p_build->row_size);
+
+            sizes[index] += weight > 0.0 ? weight : 0.0;
+        }
+
+        if (index != root_index)
+        {
+            if (holds_landmark[index])
+            {
+                holds_landmark[parents[index]] = TRUE;
+            }
+            else
+            {
+                sizes[parents[index]] += sizes[index];
+            }
+        }
+    }
+
+    for (;;)
+    {
+        best_index = vertex_count;
+
+        for (arc = p_frozen_graph->forward_offsets[current_index];
+             arc < p_frozen_graph->forward_offsets[current_index + 1];
+             ++arc)
+        {
+            index = p_frozen_graph->forward_heads[arc];
+
+            if (index == current_index ||
+                distances[index] == NO_DISTANCE ||
+                parents[index] != current_index ||
+                holds_landmark[index] ||
+                sizes[index] <= 0.0)
+            {
+                continue;
+            }
+
+            if (best_index == vertex_count || sizes[best_index] < sizes[index])
+            {
+                best_index = index;
+            }
+        }
+
+        if (best_index == vertex_count)
+        {
+            break;
+        }
+
+        current_index = best_index;
+    }
+
+    return current_index == root_index ? vertex_count : current_index;
+}
+
+/* The scratch arrays of the avoid selection, one entry per vertex each: */
+typedef struct avoid_state {
+    distance_t*    distances;
+    vertex_id_t*   parents;
+    vertex_id_t*   order;
+    double*        sizes;
+    unsigned char* is_landmark;
+    unsigned char* holds_landmark;
+} avoid_state;
+
+static int choose_avoiding(landmark_build* p_build,
+                           vertex_id_t* landmarks,
+                           size_t landmark_count,
+                           size_t* p_selected_count,
+                           avoid_state* p_state,
+                           worker_pool* p_pool)
+{
+    const frozen_graph* p_frozen_graph = p_build->p_frozen_graph;
+    size_t vertex_count = p_frozen_graph->vertex_count;
+    unsigned long random_state = 1;
+    size_t selected_count = 0;
+    size_t settled_count;
+    size_t root_index;
+    size_t landmark_index;
+    size_t attempt;
+    size_t i;
+
+    memset(p_state->is_landmark, FALSE, vertex_count);
+
+    while (selected_count < landmark_count)
+    {
+        landmark_index = vertex_count;
+
+        for (attempt = 0;
+             attempt < AVOID_ROOT_ATTEMPTS && landmark_index == vertex_count;
+             ++attempt)
+        {
+            /* The first vertex with arcs from a random position on: */
+            root_index = next_random(&random_state, vertex_count);
+
+            for (i = 0;
+                 i < vertex_count && !has_arcs(p_frozen_graph, root_index);
+                 ++i)
+            {
+                root_index = (root_index + 1) % vertex_count;
+            }
+
+            if (i == vertex_count)
+            {
+                break;
+            }
+
+            if (compute_distances(p_frozen_graph,
+                                  root_index,
+                                  TRUE,
+                                  p_state->distances,
+                                  p_state->parents,
+                                  p_state->order,
+                                  &settled_count,
+                                  p_build->workspaces[0].p_heap) !=
+                RETURN_STATUS_OK)
+            {
+                return RETURN_STATUS_NO_MEMORY;
+            }
+
+            landmark_index = find_avoided_vertex(p_frozen_graph,
+                                                 root_index,
+                                                 p_build,
+                                                 selected_count,
+                                                 p_state->is_landmark,
+                                                 p_state->distances,
+                                                 p_state->parents,
+                                                 p_state->order,
+                                                 p_state->sizes,
+                                                 p_state->holds_landmark,
+                                                 settled_count);
+        }
+
+        if (landmark_index == vertex_count)
+        {
+            break;
+        }
+
+        landmarks[selected_count] = (vertex_id_t) landmark_index;
+        p_state->is_landmark[landmark_index] = TRUE;
+
+        /* The later choices need the bounds of this landmark: */
+        if (compute_rows(p_build, 2 * selected_count, 2, p_pool) !=
+            RETURN_STATUS_OK)
+        {
+            return RETURN_STATUS_NO_MEMORY;
+        }
+
+        selected_count++;
+    }
+
+    *p_selected_count = selected_count;
+    return RETURN_STATUS_OK;
+}
+
+/* Also fills the table, the rows of each landmark as soon as it is chosen: */
+static int select_avoiding(landmark_build* p_build,
+                           vertex_id_t* landmarks,
+                           size_t landmark_count,
+                           size_t* p_selected_count,
+                           worker_pool* p_pool)
+{
+    size_t vertex_count = p_build->p_frozen_graph->vertex_count;
+    avoid_state state;
+    int status = RETURN_STATUS_NO_MEMORY;
+
+    state.distances = allocator_malloc(sizeof(distance_t) * (vertex_count + 1));
+    state.parents = allocator_malloc(sizeof(vertex_id_t) * (vertex_count + 1));
+    state.order = allocator_malloc(sizeof(vertex_id_t) * (vertex_count + 1));
+    state.sizes = allocator_malloc(sizeof(double) * (vertex_count + 1));
+    state.is_landmark = allocator_malloc(vertex_count + 1);
+    state.holds_landmark = allocator_malloc(vertex_count + 1);
+
+    if (state.distances && state.parents && state.order && state.sizes &&
+        state.is_landmark && state.holds_landmark)
+    {
+        status = choose_avoiding(p_build,
+                                 landmarks,
+                                 landmark_count,
+                                 p_selected_count,
+                                 &state,
+                                 p_pool);
+    }
+
+    allocator_free(state.distances);
+    allocator_free(state.parents);
+    allocator_free(state.order);
+    allocator_free(state.sizes);
+    allocator_free(state.is_landmark);
+    allocator_free(state.holds_landmark);
+    return status;
+}
+
+/* Narrows the rows of a table of which only 'selected_count' columns of each
+   half were filled, in place: */
+static void compact_rows(distance_t* rows,
+                         size_t vertex_count,
+                         size_t landmark_count,
+                         size_t selected_count)
+{
+    size_t i;
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        memmove(rows + 2 * selected_count * i,
+                rows + 2 * landmark_count * i,
+                sizeof(distance_t) * selected_count);
+
+        memmove(rows + 2 * selected_count * i + selected_count,
+                rows + 2 * landmark_count * i + landmark_count,
+                sizeof(distance_t) * selected_count);
+    }
+}
+
+/* Chooses the landmarks and fills the table with the workspaces ready: */
+static int build_landmarks(landmark_build* p_build,
+                           size_t landmark_count,
+                           int selection,
+                           worker_pool* p_pool)
+{
+    frozen_graph* p_frozen_graph = (frozen_graph*) p_build->p_frozen_graph;
+    size_t selected_count = 0;
+    int status;
+
+    if (selection == LANDMARK_SELECTION_FARTHEST)
+    {
+        /* The selection is cheap; the table searches go all in parallel: */
+        status = select_farthest(p_frozen_graph,
+                                 p_frozen_graph->landmarks,
+                                 landmark_count,
+                                 &selected_count,
+                                 p_build->workspaces[0].p_heap);
+
+        if (status == RETURN_STATUS_OK)
+        {
+            status = compute_rows(p_build, 0, 2 * selected_count, p_pool);
+        }
+    }
+    else
+    {
+        status = select_avoiding(p_build,
+                                 p_frozen_graph->landmarks,
+                                 landmark_count,
+                                 &selected_count,
+                                 p_pool);
+    }
+
+    if (status != RETURN_STATUS_OK)
+    {
+        return status;
+    }
+
+    if (selected_count == 0)
+    {
+        return frozen_graph_alloc_landmarks(p_frozen_graph, 0);
+    }
+
+    if (selected_count < landmark_count)
+    {
+        compact_rows(p_frozen_graph->landmark_distances,
+                     p_frozen_graph->vertex_count,
+                     landmark_count,
+                     selected_count);
+
+        p_frozen_graph->landmark_count = selected_count;
+    }
+
+    return RETURN_STATUS_OK;
+}
+
+int frozen_graph_add_landmarks(frozen_graph* p_frozen_graph,
+                               size_t landmark_count,
+                               int selection,
+                               worker_pool* p_pool)
+{
+    landmark_build build;
+    size_t worker_count = p_pool ? worker_pool_size(p_pool) : 1;
+    size_t worker_index;
+    int status;
+
+    if (!p_frozen_graph)
+    {
+        return RETURN_STATUS_NO_GRAPH;
+    }
+
+    if (selection != LANDMARK_SELECTION_FARTHEST &&
+        selection != LANDMARK_SELECTION_AVOID)
+    {
+        abort();
+    }
+
+    if (landmark_count > p_frozen_graph->vertex_count)
+    {
+        landmark_count = p_frozen_graph->vertex_count;
+    }
+
+    status = frozen_graph_alloc_landmarks(p_frozen_graph, landmark_count);
+
+    if (status != RETURN_STATUS_OK || landmark_count == 0)
+    {
+        frozen_graph_alloc_landmarks(p_frozen_graph, 0);
+        return status;
+    }
+
+    build.p_frozen_graph = p_frozen_graph;
+    build.landmarks = p_frozen_graph->landmarks;
+    build.rows = p_frozen_graph->landmark_distances;
+    build.row_size = 2 * landmark_count;
+    build.workspaces = allocator_malloc(sizeof(search_workspace) *
+                                        worker_count);
+    build.statuses = allocator_malloc(sizeof(int) * worker_count);
+    status = RETURN_STATUS_NO_MEMORY;
+
+    if (build.workspaces && build.statuses)
+    {
+        status = RETURN_STATUS_OK;
+
+        for (worker_index = 0; worker_index < worker_count; ++worker_index)
+        {
+            if (!workspace_init(&build.workspaces[worker_index],
+                                p_frozen_graph->vertex_count))
+            {
+                status = RETURN_STATUS_NO_MEMORY;
+            }
+        }
+
+        if (status == RETURN_STATUS_OK)
+        {
+            status = build_landmarks(&build,
+                                     landmark_count,
+                                     selection,
+                                     p_pool);
+        }
+
+        for (worker_index = 0; worker_index < worker_count; ++worker_index)
+        {
+            workspace_destroy(&build.workspaces[worker_index]);
+        }
+    }
+
+    allocator_free(build.workspaces);
+    allocator_free(build.statuses);
+
+    if (status != RETURN_STATUS_OK)
+    {
+        frozen_graph_alloc_landmarks(p_frozen_graph, 0);
+    }
+
+    return status;
+}
@@ -0,0 +1,56 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_LANDMARKS_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_LANDMARKS_H
+
+#include "distance_bound.h"
+#include "frozen_graph.h"
+#include "worker_pool.h"
+
+/*******************************************************************************
+* The ways of choosing the landmarks of a graph:                               *
+*   LANDMARK_SELECTION_FARTHEST - each landmark is the vertex farthest from    *
+*                                 the ones chosen before it, the arcs taken in *
+*                                 both directions. Cheap, and spreads the      *
+*                                 landmarks along the rim of the graph.        *
+*   LANDMARK_SELECTION_AVOID    - each landmark is the leaf of a shortest path *
+*                                 tree from a random vertex, reached through   *
+*                                 the subtrees whose distances the landmarks   *
+*                                 chosen so far bound worst. Costs one more    *
+*                                 search per landmark, but gives tighter       *
+*                                 bounds.                                      *
+*******************************************************************************/
+#define LANDMARK_SELECTION_FARTHEST 0
+#define LANDMARK_SELECTION_AVOID    1
+
+/*******************************************************************************
+* Chooses up to 'landmark_count' landmarks and stores in the graph the         *
+* distances from each landmark to every vertex and back, which give the lower  *
+* bounds of 'landmark_bound' by the triangle inequality. The searches of the   *
+* distance tables run on the workers of 'p_pool', which may be NULL. Fewer     *
+* landmarks are chosen if the graph runs out of vertices with arcs. Replaces   *
+* the landmarks the graph had; the table is saved with the snapshots and kept  *
+* by 'frozen_graph_reorder'. Returns RETURN_STATUS_OK, RETURN_STATUS_NO_GRAPH  *
+* or RETURN_STATUS_NO_MEMORY, in which case the graph is left without          *
+* landmarks.                                                                   *
+*******************************************************************************/
+int frozen_graph_add_landmarks(frozen_graph* p_frozen_graph,
+                               size_t landmark_count,
+                               int selection,
+                               worker_pool* p_pool);
+
+/*******************************************************************************
+* The bound given by the landmarks of a frozen graph. It is the largest of     *
+* d(L, to) - d(L, from) and d(from, L) - d(to, L) over the landmarks L, and it *
+* is HUGE_VAL if some landmark shows there is no path. The bound is zero if    *
+* the graph has no landmarks. It also fits a compressed graph made from the    *
+* frozen one, since compression keeps the vertex indices and never shrinks a   *
+* weight.                                                                      *
+*******************************************************************************/
+typedef struct landmark_bound {
+    distance_bound      bound; /* Pass this to the searches. */
+    const frozen_graph* p_frozen_graph;
+} landmark_bound;
+
+void landmark_bound_init(landmark_bound* p_landmark_bound,
+                         const frozen_graph* p_frozen_graph);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_LANDMARKS_H */
@@ -0,0 +1,525 @@
+#include "allocator.h"
+#include "frozen_graph.h"
+#include "frozen_graph_order.h"
+#include "types.h"
+#include "util.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TRY_REPORT_RETURN_STATUS(RETURN_STATUS) \
+if (p_return_status) {                          \
+    *p_return_status = RETURN_STATUS;           \
+}
+
+/* Marks a vertex that has no new index yet: */
+#define UNVISITED VERTEX_ID_MAX
+
+/* A vertex paired with its degree, for sorting the neighbors of a vertex: */
+typedef struct ranked_vertex {
+    size_t      degree;
+    vertex_id_t index;
+} ranked_vertex;
+
+/* Counts both the in-arcs and the out-arcs of the vertex 'index': */
+static size_t get_degree(frozen_graph* p_frozen_graph, size_t index)
+{
+    return p_frozen_graph->forward_offsets[index + 1] -
+           p_frozen_graph->forward_offsets[index] +
+           p_frozen_graph->backward_offsets[index + 1] -
+           p_frozen_graph->backward_offsets[index];
+}
+
+static size_t get_max_degree(frozen_graph* p_frozen_graph)
+{
+    size_t max_degree = 0;
+    size_t degree;
+    size_t i;
+
+    for (i = 0; i < p_frozen_graph->vertex_count; ++i)
+    {
+        degree = get_degree(p_frozen_graph, i);
+
+        if (max_degree < degree)
+        {
+            max_degree = degree;
+        }
+    }
+
+    return max_degree;
+}
+
+static int compare_ranked_vertices(const void* p_a, const void* p_b)
+{
+    const ranked_vertex* p_vertex_a = p_a;
+    const ranked_vertex* p_vertex_b = p_b;
+
+    if (p_vertex_a->degree != p_vertex_b->degree)
+    {
+        return p_vertex_a->degree < p_vertex_b->degree ? -1 : 1;
+    }
+
+    return p_vertex_a->index < p_vertex_b->index ? -1 :
+           (p_vertex_a->index > p_vertex_b->index ? 1 : 0);
+}
+
+/*******************************************************************************
+* Stores the vertex indices in 'sorted' by increasing or, if 'descending' is   *
+* set, decreasing degree. The counting sort keeps vertices of equal degree in  *
+* index order.                                                                 *
+*******************************************************************************/
+static int sort_by_degree(frozen_graph* p_frozen_graph,
+                          int descending,
+                          vertex_id_t* sorted)
+{
+    size_t vertex_count = p_frozen_graph->vertex_count;
+    size_t max_degree = get_max_degree(p_frozen_graph);
+    size_t* counts = allocator_calloc(max_degree + 2, sizeof(size_t));
+    size_t key;
+    size_t i;
+
+    if (!counts)
+    {
+        return FALSE;
+    }
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        key = get_degree(p_frozen_graph, i);
+        counts[(descending ? max_degree - key : key) + 1]++;
+    }
+
+    for (i = 1; i <= max_degree + 1; ++i)
+    {
+        counts[i] += counts[i - 1];
+    }
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        key = get_degree(p_frozen_graph, i);
+        sorted[counts[descending ? max_degree - key : key]++] =
+                (vertex_id_t) i;
+    }
+
+    allocator_free(counts);
+    return TRUE;
+}
+
+/* Appends to 'queue' the neighbors of 'index' that have no new index yet: */
+static size_t enqueue_neighbors(frozen_graph* p_frozen_graph,
+                                size_t index,
+                                vertex_id_t* queue,
+                                size_t queue_size,
+                                vertex_id_t* new_index_of)
+{
+    size_t arc;
+    vertex_id_t neighbor;
+
+    for (arc = p_frozen_graph->forward_offsets[index];
+         arc < p_frozen_graph->forward_offsets[index + 1];
+         ++arc)
+    {
+        neighbor = p_frozen_graph->forward_heads[arc];
+
+        if (new_index_of[neighbor] == UNVISITED)
+        {
+            new_index_of[neighbor] = (vertex_id_t) queue_size;
+            queue[queue_size++] = neighbor;
+        }
+    }
+
+    for (arc = p_frozen_graph->backward_offsets[index];
+         arc < p_frozen_graph->backward_offsets[index + 1];
+         ++arc)
+    {
+        neighbor = p_frozen_graph->backward_heads[arc];
+
+        if (new_index_of[neighbor] == UNVISITED)
+        {
+            new_index_of[neighbor] = (vertex_id_t) queue_size;
+            queue[queue_size++] = neighbor;
+        }
+    }
+
+    return queue_size;
+}
+
+static void order_breadth_first(frozen_graph* p_frozen_graph,
+                                vertex_id_t* order,
+                                vertex_id_t* new_index_of)
+{
+    size_t vertex_count = p_frozen_graph->vertex_count;
+    size_t queue_head = 0;
+    size_t queue_size = 0;
+    size_t root;
+
+    for (root = 0; root < vertex_count; ++root)
+    {
+        if (new_index_of[root] != UNVISITED)
+        {
+            continue;
+        }
+
+        new_index_of[root] = (vertex_id_t) queue_size;
+        order[queue_size++] = (vertex_id_t) root;
+
+        while (queue_head < queue_size)
+        {
+            queue_size = enqueue_neighbors(p_frozen_graph,
+                                           order[queue_head++],
+                                           order,
+                                           queue_size,
+                                           new_index_of);
+        }
+    }
+}
+
+/* Sorts the vertices order[begin..end) by degree and renumbers them: */
+static void sort_by_rank(frozen_graph* p_frozen_graph,
+                         vertex_id_t* order,
+                         size_t begin,
+                         size_t end,
+                         vertex_id_t* new_index_of,
+                         ranked_vertex* ranked)
+{
+    size_t i;
+
+    for (i = begin; i < end; ++i)
+    {
+        ranked[i - begin].degree = get_degree(p_frozen_graph, order[i]);
+        ranked[i - begin].index = order[i];
+    }
+
+    qsort(ranked, end - begin, sizeof(ranked_vertex), compare_ranked_vertices);
+
+    for (i = begin; i < end; ++i)
+    {
+        order[i] = ranked[i - begin].index;
+        new_index_of[order[i]] = (vertex_id_t) i;
+    }
+}
+
+static int order_reverse_cuthill_mckee(frozen_graph* p_frozen_graph,
+                                       vertex_id_t* order,
+                                       vertex_id_t* new_index_of)
+{
+    size_t vertex_count = p_frozen_graph->vertex_count;
+    vertex_id_t* by_degree =
+            allocator_malloc(sizeof(vertex_id_t) * (vertex_count + 1));
+    ranked_vertex* ranked =
+            allocator_malloc(sizeof(ranked_vertex) *
+                             (get_max_degree(p_frozen_graph) + 1));
+    size_t next_root = 0;
+    size_t queue_head = 0;
+    size_t queue_size = 0;
+    size_t first_neighbor;
+    size_t i;
+    vertex_id_t root;
+    vertex_id_t swap;
+
+    if (!by_degree || !ranked ||
+        !sort_by_degree(p_frozen_graph, FALSE, by_degree))
+    {
+        allocator_free(by_degree);
+        allocator_free(ranked);
+        return FALSE;
+    }
+
+    while (queue_size < vertex_count)
+    {
+        /* Start each component at a vertex of minimum degree: */
+        while (new_index_of[by_degree[next_root]] != UNVISITED)
+        {
+            next_root++;
+        }
+
+        root = by_degree[next_root];
+        new_index_of[root] = (vertex_id_t) queue_size;
+        order[queue_size++] = root;
+
+        while (queue_head < queue_size)
+        {
+            first_neighbor = queue_size;
+            queue_size = enqueue_neighbors(p_frozen_graph,
+                                           order[queue_head++],
+                                           order,
+                                           queue_size,
+                                           new_index_of);
+
+            sort_by_rank(p_frozen_graph,
+                         order,
+                         first_neighbor,
+                         queue_size,
+                         new_index_of,
+                         ranked);
+        }
+    }
+
+    for (i = 0; i < vertex_count / 2; ++i)
+    {
+        swap = order[i];
+        order[i] = order[vertex_count - 1 - i];
+        order[vertex_count - 1 - i] = swap;
+    }
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        new_index_of[order[i]] = (vertex_id_t) i;
+    }
+
+    allocator_free(by_degree);
+    allocator_free(ranked);
+    return TRUE;
+}
+
+static int order_by_degree(frozen_graph* p_frozen_graph,
+                           vertex_id_t* order,
+                           vertex_id_t* new_index_of)
+{
+    size_t i;
+
+    if (!sort_by_degree(p_frozen_graph, TRUE, order))
+    {
+        return FALSE;
+    }
+
+    for (i = 0; i < p_frozen_graph->vertex_count; ++i)
+    {
+        new_index_of[order[i]] = (vertex_id_t) i;
+    }
+
+    return TRUE;
+}
+
+/* Copies the arcs of the vertices in their new order, renumbering the heads: */
+static void renumber_adjacency(size_t vertex_count,
+                               const vertex_id_t* order,
+                               const vertex_id_t* new_index_of,
+                               const size_t* offsets,
+                               const vertex_id_t* heads,
+                               const weight_t* weights,
+                               size_t* new_offsets,
+                               vertex_id_t* new_heads,
+                               weight_t* new_weights)
+{
+    size_t arc_index = 0;
+    size_t arc;
+    size_t i;
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        new_offsets[i] = arc_index;
+
+        for (arc = offsets[order[i]]; arc < offsets[order[i] + 1]; ++arc)
+        {
+            new_heads[arc_index] = new_index_of[heads[arc]];
+            new_weights[arc_index] = weights[arc];
+            arc_index++;
+        }
+    }
+
+    new_offsets[vertex_count] = arc_index;
+}
+
+static frozen_graph* renumber(frozen_graph* p_frozen_graph,
+                              const vertex_id_t* order,
+                              const vertex_id_t* new_index_of)
+{
+    size_t vertex_count = p_frozen_graph->vertex_count;
+    frozen_graph* p_reordered_graph =
+            frozen_graph_alloc(vertex_count, p_frozen_graph->edge_count);
+    vertex_id_t* sorted_indices;
+    size_t old_index;
+    size_t row_size;
+    size_t i;
+    int ids_sorted = TRUE;
+
+    if (!p_reordered_graph)
+    {
+        return NULL;
+    }
+
+    sorted_indices = allocator_malloc(sizeof(vertex_id_t) * (vertex_count + 1));
+
+    if (!sorted_indices)
+    {
+        frozen_graph_free(p_reordered_graph);
+        return NULL;
+    }
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        p_reordered_graph->vertex_ids[i] =
+                frozen_graph_get_vertex_id(p_frozen_graph, order[i]);
+    }
+
+    /* The indices of the old graph in increasing ID order, renumbered: */
+    for (i = 0; i < vertex_count; ++i)
+    {
+        old_index = p_frozen_graph->sorted_indices ?
+                    p_frozen_graph->sorted_indices[i] :
+                    i;
+
+        sorted_indices[i] = new_index_of[old_index];
+
+        if (sorted_indices[i] != i)
+        {
+            ids_sorted = FALSE;
+        }
+    }
+
+    if (ids_sorted)
+    {
+        allocator_free(sorted_indices);
+    }
+    else
+    {
+        p_reordered_graph->sorted_indices = sorted_indices;
+    }
+
+    renumber_adjacency(vertex_count,
+                       order,
+                       new_index_of,
+                       p_frozen_graph->forward_offsets,
+                       p_frozen_graph->forward_heads,
+                       p_frozen_graph->forward_weights,
+                       p_reordered_graph->forward_offsets,
+                       p_reordered_graph->forward_heads,
+                       p_reordered_graph->forward_weights);
+
+    renumber_adjacency(vertex_count,
+                       order,
+                       new_index_of,
+                       p_frozen_graph->backward_offsets,
+                       p_frozen_graph->backward_heads,
+                       p_frozen_graph->backward_weights,
+                       p_reordered_graph->backward_offsets,
+                       p_reordered_graph->backward_heads,
+                       p_reordered_graph->backward_weights);
+
+    if (p_frozen_graph->coordinates)
+    {
+        p_reordered_graph->coordinates =
+                allocator_malloc(sizeof(double) * 2 * (vertex_count + 1));
+
+        if (!p_reordered_graph->coordinates)
+        {
+            frozen_graph_free(p_reordered_graph);
+            return NULL;
+        }
+
+        for (i = 0; i < vertex_count; ++i)
+        {
+            p_reordered_graph->coordinates[2 * i] =
+                    p_frozen_graph->coordinates[2 * order[i]];
+
+            p_reordered_graph->coordinates[2 * i + 1] =
+                    p_frozen_graph->coordinates[2 * order[i] + 1];
+        }
+    }
+
+    if (p_frozen_graph->landmark_count > 0)
+    {
+        if (frozen_graph_alloc_landmarks(p_reordered_graph,
+                                         p_frozen_graph->landmark_count) !=
+            RETURN_STATUS_OK)
+        {
+            frozen_graph_free(p_reordered_graph);
+            return NULL;
+        }
+
+        for (i = 0; i < p_frozen_graph->landmark_count; ++i)
+        {
+            p_reordered_graph->landmarks[i] =
+                    new_index_of[p_frozen_graph->landmarks[i]];
+        }
+
+        row_size = 2 * p_frozen_graph->landmark_count;
+
+        for (i = 0; i < vertex_count; ++i)
+        {
+            memcpy(p_reordered_graph->landmark_distances + row_size * i,
+                   p_frozen_graph->landmark_distances + row_size * order[i],
+                   sizeof(distance_t) * row_size);
+        }
+    }
+
+    return p_reordered_graph;
+}
+
+frozen_graph* frozen_graph_reorder(frozen_graph* p_frozen_graph,
+                                   int order,
+                                   int* p_return_status)
+{
+    frozen_graph* p_reordered_graph = NULL;
+    vertex_id_t* vertex_order;
+    vertex_id_t* new_index_of;
+    size_t vertex_count;
+    size_t i;
+    int ok = TRUE;
+
+    if (order != FROZEN_GRAPH_ORDER_BFS &&
+        order != FROZEN_GRAPH_ORDER_RCM &&
+        order != FROZEN_GRAPH_ORDER_DEGREE)
+    {
+        abort();
+    }
+
+    if (!p_frozen_graph)
+    {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_GRAPH);
+        return NULL;
+    }
+
+    vertex_count = p_frozen_graph->vertex_count;
+    vertex_order = allocator_malloc(sizeof(vertex_id_t) * (vertex_count + 1));
+    new_index_of = allocator_malloc(sizeof(vertex_id_t) * (vertex_count + 1));
+
+    if (!vertex_order || !new_index_of)
+    {
+        allocator_free(vertex_order);
+        allocator_free(new_index_of);
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        new_index_of[i] = UNVISITED;
+    }
+
+    switch (order)
+    {
+        case FROZEN_GRAPH_ORDER_BFS:
+            order_breadth_first(p_frozen_graph, vertex_order, new_index_of);
+            break;
+
+        case FROZEN_GRAPH_ORDER_RCM:
+            ok = order_reverse_cuthill_mckee(p_frozen_graph,
+                                             vertex_order,
+                                             new_index_of);
+            break;
+
+        default:
+            ok = order_by_degree(p_frozen_graph, vertex_order, new_index_of);
+            break;
+    }
+
+    if (ok)
+    {
+        p_reordered_graph = renumber(p_frozen_graph,
+                                     vertex_order,
+                                     new_index_of);
+    }
+
+    allocator_free(vertex_order);
+    allocator_free(new_index_of);
+
+    if (!p_reordered_graph)
+    {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    TRY_REPORT_RETURN_STATUS(RETURN_STATUS_OK);
+    return p_reordered_graph;
+}
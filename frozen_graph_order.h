@@ -0,0 +1,39 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_ORDER_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_ORDER_H
+
+#include "frozen_graph.h"
+
+/*******************************************************************************
+* The vertex orders a frozen graph can be renumbered into. Each one looks at   *
+* the graph as undirected, so that a vertex is near its parents as well as its *
+* children:                                                                    *
+*   FROZEN_GRAPH_ORDER_BFS    - breadth-first order. Each search starts from   *
+*                               the lowest index not yet reached.              *
+*   FROZEN_GRAPH_ORDER_RCM    - reverse Cuthill-McKee: breadth-first order     *
+*                               from a vertex of minimum degree, visiting the  *
+*                               new neighbors of each vertex by increasing     *
+*                               degree, then reversed. It keeps the arcs close *
+*                               to the diagonal of the adjacency matrix.       *
+*   FROZEN_GRAPH_ORDER_DEGREE - decreasing degree, so that the hubs, which     *
+*                               most searches pass through, share the first    *
+*                               cache lines.                                   *
+* Ties are broken by the current index.                                        *
+*******************************************************************************/
+#define FROZEN_GRAPH_ORDER_BFS    0
+#define FROZEN_GRAPH_ORDER_RCM    1
+#define FROZEN_GRAPH_ORDER_DEGREE 2
+
+/*******************************************************************************
+* Returns a copy of 'p_frozen_graph' with its vertices renumbered in the given *
+* order, so that the arcs a search scans next lie close in memory. The vertex  *
+* IDs stay the same, so the searches and 'frozen_graph_get_index' work on the  *
+* copy as before and find paths of the same length; only the vertex indices    *
+* and, among several shortest paths, the one found may differ. Returns NULL    *
+* on failure, storing RETURN_STATUS_NO_GRAPH or RETURN_STATUS_NO_MEMORY in     *
+* '*p_return_status' if it is not NULL.                                        *
+*******************************************************************************/
+frozen_graph* frozen_graph_reorder(frozen_graph* p_frozen_graph,
+                                   int order,
+                                   int* p_return_status);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_ORDER_H */
@@ -0,0 +1,562 @@
+/* mmap is POSIX, not ANSI C; request it before any system header: */
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200112L
+#define FROZEN_GRAPH_SNAPSHOT_MMAP
+#endif
+
+#include "allocator.h"
+#include "frozen_graph.h"
+#include "frozen_graph_snapshot.h"
+#include "types.h"
+#include "util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef FROZEN_GRAPH_SNAPSHOT_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define TRY_REPORT_RETURN_STATUS(RETURN_STATUS) \
+if (p_return_status) {                          \
+    *p_return_status = RETURN_STATUS;           \
+}
+
+#define SNAPSHOT_ALIGNMENT 64
+
+static const char SNAPSHOT_MAGIC[8] = "BDGRAPH";
+
+/* Reads back differently on a machine with another byte order: */
+static const size_t SNAPSHOT_BYTE_ORDER_MARK = 0x01020304;
+
+#define SNAPSHOT_WEIGHT_FLOATING 0
+#define SNAPSHOT_WEIGHT_INTEGER  1
+
+typedef struct snapshot_header {
+    char   magic[8];
+    size_t version;
+    size_t byte_order_mark;
+    size_t offset_size;
+    size_t vertex_id_size;
+    size_t weight_size;
+    size_t weight_kind;
+    size_t has_vertex_ids;
+    size_t has_sorted_indices;
+    size_t vertex_count;
+    size_t edge_count;
+    size_t distance_size;
+    size_t landmark_count;
+} snapshot_header;
+
+/* The file positions of the sections and the total file size: */
+typedef struct snapshot_layout {
+    size_t forward_offsets;
+    size_t forward_heads;
+    size_t forward_weights;
+    size_t backward_offsets;
+    size_t backward_heads;
+    size_t backward_weights;
+    size_t vertex_ids;
+    size_t sorted_indices;
+    size_t landmarks;
+    size_t landmark_distances;
+    size_t size;
+} snapshot_layout;
+
+/* Tells float and double apart from the integer weight types: */
+static size_t get_weight_kind()
+{
+    return (weight_t) 0.5 == (weight_t) 0 ?
+           SNAPSHOT_WEIGHT_INTEGER :
+           SNAPSHOT_WEIGHT_FLOATING;
+}
+
+static size_t align_section(size_t position)
+{
+    return (position + SNAPSHOT_ALIGNMENT - 1) /
+           SNAPSHOT_ALIGNMENT *
+           SNAPSHOT_ALIGNMENT;
+}
+
+static void compute_layout(const snapshot_header* p_header,
+                           snapshot_layout* p_layout)
+{
+    size_t offsets_size = sizeof(size_t) * (p_header->vertex_count + 1);
+    size_t heads_size = sizeof(vertex_id_t) * p_header->edge_count;
+    size_t weights_size = sizeof(weight_t) * p_header->edge_count;
+    size_t ids_size = sizeof(vertex_id_t) * p_header->vertex_count;
+    size_t landmarks_size = sizeof(vertex_id_t) * p_header->landmark_count;
+    size_t position = align_section(sizeof(snapshot_header));
+
+    p_layout->forward_offsets = position;
+    position = align_section(position + offsets_size);
+    p_layout->forward_heads = position;
+    position = align_section(position + heads_size);
+    p_layout->forward_weights = position;
+    position = align_section(position + weights_size);
+    p_layout->backward_offsets = position;
+    position = align_section(position + offsets_size);
+    p_layout->backward_heads = position;
+    position = align_section(position + heads_size);
+    p_layout->backward_weights = position;
+    position += weights_size;
+    p_layout->vertex_ids = 0;
+    p_layout->sorted_indices = 0;
+    p_layout->landmarks = 0;
+    p_layout->landmark_distances = 0;
+
+    /* The file ends right after its last section: */
+    if (p_header->has_vertex_ids)
+    {
+        p_layout->vertex_ids = align_section(position);
+        position = p_layout->vertex_ids + ids_size;
+    }
+
+    if (p_header->has_sorted_indices)
+    {
+        p_layout->sorted_indices = align_section(position);
+        position = p_layout->sorted_indices + ids_size;
+    }
+
+    if (p_header->landmark_count > 0)
+    {
+        p_layout->landmarks = align_section(position);
+        position = p_layout->landmarks + landmarks_size;
+        p_layout->landmark_distances = align_section(position);
+        position = p_layout->landmark_distances +
+                   sizeof(distance_t) *
+                   2 * p_header->landmark_count *
+                   p_header->vertex_count;
+    }
+
+    p_layout->size = position;
+}
+
+static int has_identity_vertex_ids(frozen_graph* p_frozen_graph)
+{
+    size_t i;
+
+    if (!p_frozen_graph->vertex_ids)
+    {
+        return TRUE;
+    }
+
+    for (i = 0; i < p_frozen_graph->vertex_count; ++i)
+    {
+        if (p_frozen_graph->vertex_ids[i] != i)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/* Pads the file with zeros up to 'section_position' and writes the section: */
+static int write_section(FILE* p_file,
+                         size_t* p_position,
+                         size_t section_position,
+                         const void* p_data,
+                         size_t data_size)
+{
+    static const char padding[SNAPSHOT_ALIGNMENT] = { 0 };
+    size_t padding_size = section_position - *p_position;
+
+    if (fwrite(padding, 1, padding_size, p_file) != padding_size ||
+        fwrite(p_data, 1, data_size, p_file) != data_size)
+    {
+        return FALSE;
+    }
+
+    *p_position = section_position + data_size;
+    return TRUE;
+}
+
+int frozen_graph_save(frozen_graph* p_frozen_graph, const char* file_name)
+{
+    snapshot_header header;
+    snapshot_layout layout;
+    FILE* p_file;
+    size_t position = 0;
+    size_t vertex_count;
+    size_t edge_count;
+    int ok;
+
+    if (!p_frozen_graph)
+    {
+        return RETURN_STATUS_NO_GRAPH;
+    }
+
+    vertex_count = p_frozen_graph->vertex_count;
+    edge_count = p_frozen_graph->edge_count;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = FROZEN_GRAPH_SNAPSHOT_VERSION;
+    header.byte_order_mark = SNAPSHOT_BYTE_ORDER_MARK;
+    header.offset_size = sizeof(size_t);
+    header.vertex_id_size = sizeof(vertex_id_t);
+    header.weight_size = sizeof(weight_t);
+    header.weight_kind = get_weight_kind();
+    header.has_vertex_ids = !has_identity_vertex_ids(p_frozen_graph);
+    header.has_sorted_indices = header.has_vertex_ids &&
+                                p_frozen_graph->sorted_indices != NULL;
+    header.vertex_count = vertex_count;
+    header.edge_count = edge_count;
+    header.distance_size = sizeof(distance_t);
+    header.landmark_count = p_frozen_graph->landmark_count;
+    compute_layout(&header, &layout);
+
+    p_file = fopen(file_name, "wb");
+
+    if (!p_file)
+    {
+        return RETURN_STATUS_IO_ERROR;
+    }
+
+    ok = write_section(p_file, &position, 0, &header, sizeof(header)) &&
+         write_section(p_file,
+                       &position,
+                       layout.forward_offsets,
+                       p_frozen_graph->forward_offsets,
+                       sizeof(size_t) * (vertex_count + 1)) &&
+         write_section(p_file,
+                       &position,
+                       layout.forward_heads,
+                       p_frozen_graph->forward_heads,
+                       sizeof(vertex_id_t) * edge_count) &&
+         write_section(p_file,
+                       &position,
+                       layout.forward_weights,
+                       p_frozen_graph->forward_weights,
+                       sizeof(weight_t) * edge_count) &&
+         write_section(p_file,
+                       &position,
+                       layout.backward_offsets,
+                       p_frozen_graph->backward_offsets,
+                       sizeof(size_t) * (vertex_count + 1)) &&
+         write_section(p_file,
+                       &position,
+                       layout.backward_heads,
+                       p_frozen_graph->backward_heads,
+                       sizeof(vertex_id_t) * edge_count) &&
+         write_section(p_file,
+                       &position,
+                       layout.backward_weights,
+                       p_frozen_graph->backward_weights,
+                       sizeof(weight_t) * edge_count);
+
+    if (ok && header.has_vertex_ids)
+    {
+        ok = write_section(p_file,
+                           &position,
+                           layout.vertex_ids,
+                           p_frozen_graph->vertex_ids,
+                           sizeof(vertex_id_t) * vertex_count);
+    }
+
+    if (ok && header.has_sorted_indices)
+    {
+        ok = write_section(p_file,
+                           &position,
+                           layout.sorted_indices,
+                           p_frozen_graph->sorted_indices,
+                           sizeof(vertex_id_t) * vertex_count);
+    }
+
+    if (ok && header.landmark_count > 0)
+    {
+        ok = write_section(p_file,
+                           &position,
+                           layout.landmarks,
+                           p_frozen_graph->landmarks,
+                           sizeof(vertex_id_t) * header.landmark_count) &&
+             write_section(p_file,
+                           &position,
+                           layout.landmark_distances,
+                           p_frozen_graph->landmark_distances,
+                           sizeof(distance_t) *
+                           2 * header.landmark_count *
+                           vertex_count);
+    }
+
+    /* A failed close may mean that buffered data never reached the file: */
+    if (fclose(p_file) != 0 || !ok)
+    {
+        remove(file_name);
+        return RETURN_STATUS_IO_ERROR;
+    }
+
+    return RETURN_STATUS_OK;
+}
+
+/* Checks that the header matches this build and fits in 'storage_size': */
+static int validate_header(const snapshot_header* p_header,
+                           size_t storage_size,
+                           snapshot_layout* p_layout)
+{
+    if (memcmp(p_header->magic, SNAPSHOT_MAGIC, sizeof(p_header->magic)) ||
+        p_header->version != FROZEN_GRAPH_SNAPSHOT_VERSION ||
+        p_header->byte_order_mark != SNAPSHOT_BYTE_ORDER_MARK ||
+        p_header->offset_size != sizeof(size_t) ||
+        p_header->vertex_id_size != sizeof(vertex_id_t) ||
+        p_header->weight_size != sizeof(weight_t) ||
+        p_header->weight_kind != get_weight_kind() ||
+        p_header->distance_size != sizeof(distance_t) ||
+        (p_header->has_sorted_indices && !p_header->has_vertex_ids))
+    {
+        return FALSE;
+    }
+
+    /* Bound the counts first, so that computing the layout cannot
+       overflow: */
+    if (p_header->vertex_count >= storage_size / sizeof(size_t) ||
+        p_header->vertex_count > VERTEX_ID_MAX ||
+        p_header->edge_count > storage_size / sizeof(vertex_id_t) ||
+        p_header->landmark_count > p_header->vertex_count)
+    {
+        return FALSE;
+    }
+
+    if (p_header->landmark_count > 0 &&
+        2 * p_header->landmark_count >
+        storage_size / sizeof(distance_t) / p_header->vertex_count)
+    {
+        return FALSE;
+    }
+
+    compute_layout(p_header, p_layout);
+    return p_layout->size <= storage_size;
+}
+
+/*******************************************************************************
+* Makes a frozen graph whose arrays point into 'p_storage', which holds a      *
+* whole snapshot. Returns NULL and stores the reason in '*p_return_status' if  *
+* the snapshot is not valid for this build or no memory is left.               *
+*******************************************************************************/
+static frozen_graph* bind_snapshot(void* p_storage,
+                                   size_t storage_size,
+                                   int* p_return_status)
+{
+    char* p_bytes = p_storage;
+    snapshot_header header;
+    snapshot_layout layout;
+    frozen_graph* p_frozen_graph;
+    size_t vertex_count;
+
+    if (storage_size < sizeof(header))
+    {
+        *p_return_status = RETURN_STATUS_INVALID_SNAPSHOT;
+        return NULL;
+    }
+
+    /* The header is copied out, since nothing guarantees its alignment in
+       the storage: */
+    memcpy(&header, p_bytes, sizeof(header));
+
+    if (!validate_header(&header, storage_size, &layout))
+    {
+        *p_return_status = RETURN_STATUS_INVALID_SNAPSHOT;
+        return NULL;
+    }
+
+    p_frozen_graph = allocator_malloc(sizeof(*p_frozen_graph));
+
+    if (!p_frozen_graph)
+    {
+        *p_return_status = RETURN_STATUS_NO_MEMORY;
+        return NULL;
+    }
+
+    vertex_count = header.vertex_count;
+    p_frozen_graph->vertex_count = vertex_count;
+    p_frozen_graph->edge_count = header.edge_count;
+    p_frozen_graph->forward_offsets =
+            (size_t*)(p_bytes + layout.forward_offsets);
+    p_frozen_graph->forward_heads =
+            (vertex_id_t*)(p_bytes + layout.forward_heads);
+    p_frozen_graph->forward_weights =
+            (weight_t*)(p_bytes + layout.forward_weights);
+    p_frozen_graph->backward_offsets =
+            (size_t*)(p_bytes + layout.backward_offsets);
+    p_frozen_graph->backward_heads =
+            (vertex_id_t*)(p_bytes + layout.backward_heads);
+    p_frozen_graph->backward_weights =
+            (weight_t*)(p_bytes + layout.backward_weights);
+    p_frozen_graph->vertex_ids =
+            header.has_vertex_ids ?
+            (vertex_id_t*)(p_bytes + layout.vertex_ids) :
+            NULL;
+    p_frozen_graph->sorted_indices =
+            header.has_sorted_indices ?
+            (vertex_id_t*)(p_bytes + layout.sorted_indices) :
+            NULL;
+
+    p_frozen_graph->coordinates = NULL;
+    p_frozen_graph->landmark_count = header.landmark_count;
+    p_frozen_graph->landmarks =
+            header.landmark_count > 0 ?
+            (vertex_id_t*)(p_bytes + layout.landmarks) :
+            NULL;
+    p_frozen_graph->landmark_distances =
+            header.landmark_count > 0 ?
+            (distance_t*)(p_bytes + layout.landmark_distances) :
+            NULL;
+    p_frozen_graph->p_landmark_block = NULL;
+    p_frozen_graph->release_storage = NULL;
+    p_frozen_graph->p_storage = p_storage;
+    p_frozen_graph->storage_size = storage_size;
+
+    /* The offsets must span exactly the arcs: */
+    if (p_frozen_graph->forward_offsets[0] != 0 ||
+        p_frozen_graph->backward_offsets[0] != 0 ||
+        p_frozen_graph->forward_offsets[vertex_count] != header.edge_count ||
+        p_frozen_graph->backward_offsets[vertex_count] != header.edge_count)
+    {
+        allocator_free(p_frozen_graph);
+        *p_return_status = RETURN_STATUS_INVALID_SNAPSHOT;
+        return NULL;
+    }
+
+    return p_frozen_graph;
+}
+
+#ifdef FROZEN_GRAPH_SNAPSHOT_MMAP
+
+static void unmap_storage(frozen_graph* p_frozen_graph)
+{
+    munmap(p_frozen_graph->p_storage, p_frozen_graph->storage_size);
+}
+
+frozen_graph* frozen_graph_load(const char* file_name, int* p_return_status)
+{
+    struct stat file_status;
+    frozen_graph* p_frozen_graph;
+    void* p_storage;
+    size_t storage_size;
+    int file_descriptor = open(file_name, O_RDONLY);
+    int rs; /* return status */
+
+    if (file_descriptor < 0)
+    {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_IO_ERROR);
+        return NULL;
+    }
+
+    if (fstat(file_descriptor, &file_status) != 0)
+    {
+        close(file_descriptor);
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_IO_ERROR);
+        return NULL;
+    }
+
+    storage_size = (size_t) file_status.st_size;
+
+    if (storage_size < sizeof(snapshot_header))
+    {
+        close(file_descriptor);
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_INVALID_SNAPSHOT);
+        return NULL;
+    }
+
+    p_storage = mmap(NULL,
+                     storage_size,
+                     PROT_READ,
+                     MAP_PRIVATE,
+                     file_descriptor,
+                     0);
+
+    /* The mapping stays valid after the descriptor is closed: */
+    close(file_descriptor);
+
+    if (p_storage == MAP_FAILED)
+    {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_IO_ERROR);
+        return NULL;
+    }
+
+    p_frozen_graph = bind_snapshot(p_storage, storage_size, &rs);
+
+    if (!p_frozen_graph)
+    {
+        munmap(p_storage, storage_size);
+        TRY_REPORT_RETURN_STATUS(rs);
+        return NULL;
+    }
+
+    p_frozen_graph->release_storage = unmap_storage;
+    TRY_REPORT_RETURN_STATUS(RETURN_STATUS_OK);
+    return p_frozen_graph;
+}
+
+#else
+
+static void free_storage(frozen_graph* p_frozen_graph)
+{
+    allocator_free(p_frozen_graph->p_storage);
+}
+
+frozen_graph* frozen_graph_load(const char* file_name, int* p_return_status)
+{
+    frozen_graph* p_frozen_graph;
+    void* p_storage;
+    long file_size;
+    size_t storage_size;
+    FILE* p_file = fopen(file_name, "rb");
+    int rs; /* return status */
+
+    if (!p_file)
+    {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_IO_ERROR);
+        return NULL;
+    }
+
+    if (fseek(p_file, 0, SEEK_END) != 0 ||
+        (file_size = ftell(p_file)) < 0 ||
+        fseek(p_file, 0, SEEK_SET) != 0)
+    {
+        fclose(p_file);
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_IO_ERROR);
+        return NULL;
+    }
+
+    storage_size = (size_t) file_size;
+
+    /* Allocate at least one byte so that an empty file is not confused with
+       a failed allocation: */
+    p_storage = allocator_malloc(storage_size + 1);
+
+    if (!p_storage)
+    {
+        fclose(p_file);
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    if (fread(p_storage, 1, storage_size, p_file) != storage_size)
+    {
+        allocator_free(p_storage);
+        fclose(p_file);
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_IO_ERROR);
+        return NULL;
+    }
+
+    fclose(p_file);
+    p_frozen_graph = bind_snapshot(p_storage, storage_size, &rs);
+
+    if (!p_frozen_graph)
+    {
+        allocator_free(p_storage);
+        TRY_REPORT_RETURN_STATUS(rs);
+        return NULL;
+    }
+
+    p_frozen_graph->release_storage = free_storage;
+    TRY_REPORT_RETURN_STATUS(RETURN_STATUS_OK);
+    return p_frozen_graph;
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_SNAPSHOT_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_SNAPSHOT_H
+
+#include "frozen_graph.h"
+
+/*******************************************************************************
+* A snapshot stores a frozen graph in a binary file laid out exactly like the  *
+* graph in memory: a header, then the forward offsets, heads and weights, the  *
+* backward offsets, heads and weights, then the vertex ID map, which is        *
+* omitted when every vertex ID equals its index, and finally the vertex        *
+* indices in increasing ID order, which are stored only for a reordered graph  *
+* whose ID map is not sorted, and the landmark indices and distance table if   *
+* the graph has landmarks. Each section starts at a multiple of 64 bytes.      *
+* The data is written in the byte order and type sizes of the writing          *
+* machine; the header records them together with the format version, and a     *
+* loader that does not match them rejects the file.                            *
+*******************************************************************************/
+#define FROZEN_GRAPH_SNAPSHOT_VERSION 3
+
+/*******************************************************************************
+* Writes 'p_frozen_graph' to the file 'file_name'. Returns RETURN_STATUS_OK,   *
+* RETURN_STATUS_NO_GRAPH or RETURN_STATUS_IO_ERROR.                            *
+*******************************************************************************/
+int frozen_graph_save(frozen_graph* p_frozen_graph, const char* file_name);
+
+/*******************************************************************************
+* Loads a snapshot written by 'frozen_graph_save'. On POSIX systems the file   *
+* is mapped read-only and the arrays of the returned graph point into the      *
+* mapping, so loading neither parses nor copies the arcs, and processes that   *
+* load the same snapshot share its pages. Elsewhere, the file is read into one *
+* block of memory. The graph must be released with 'frozen_graph_free'.        *
+* The header and the section sizes are validated, but the arcs and the         *
+* landmarks are trusted.                                                       *
+* Returns NULL on failure, storing RETURN_STATUS_IO_ERROR,                     *
+* RETURN_STATUS_INVALID_SNAPSHOT or RETURN_STATUS_NO_MEMORY in                 *
+* '*p_return_status' if it is not NULL.                                        *
+*******************************************************************************/
+frozen_graph* frozen_graph_load(const char* file_name, int* p_return_status);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_FROZEN_GRAPH_SNAPSHOT_H */
@@ -1,31 +1,46 @@
 #include "graph.h"
+#include "allocator.h"
 #include "graph_vertex_map.h"
 #include "util.h"
 #include "weight_map.h"
+#include <string.h>
 
 static const size_t initial_capacity = 1024;
 static const float load_factor = 1.3f;
 
+/* Weight maps start in the array mode, so this is only the size of the hash
+   table a weight map upgrades to once the vertex degree grows large: */
+static const size_t weight_map_initial_capacity = 64;
+
+/* Marks an arc of a batch that repeats an earlier one: */
+static const size_t merged_arc = (size_t) -1;
+
 Graph* allocGraph()
 {
-    Graph* p_graph = malloc(sizeof(Graph));
+    Graph* p_graph = allocator_malloc(sizeof(Graph));
     initGraph(p_graph);
     return p_graph;
 }
 
-void initGraphVertex(GraphVertex* p_graph_vertex, size_t id)
+/* Sets up a vertex whose weight maps live in 'p_arena', or on the heap if
+   'p_arena' is NULL: */
+static void init_vertex_in_arena(GraphVertex* p_graph_vertex,
+                                 vertex_id_t id,
+                                 graph_arena* p_arena)
 {
     p_graph_vertex->p_children =
-            weight_map_alloc(initial_capacity,
-                             load_factor);
+            weight_map_alloc_in_arena(p_arena,
+                                      weight_map_initial_capacity,
+                                      load_factor);
 
     if (!p_graph_vertex->p_children) {
         abort();
     }
 
     p_graph_vertex->p_parents =
-            weight_map_alloc(initial_capacity,
-                             load_factor);
+            weight_map_alloc_in_arena(p_arena,
+                                      weight_map_initial_capacity,
+                                      load_factor);
 
     if (!p_graph_vertex->p_parents) {
         weight_map_free(p_graph_vertex->p_children);
@@ -35,6 +50,11 @@ void initGraphVertex(GraphVertex* p_graph_vertex, size_t id)
     p_graph_vertex->id = id;
 }
 
+void initGraphVertex(GraphVertex* p_graph_vertex, vertex_id_t id)
+{
+    init_vertex_in_arena(p_graph_vertex, id, NULL);
+}
+
 void freeGraphVertex(GraphVertex* p_graph_vertex)
 {
     weight_map_free(p_graph_vertex->p_children);
@@ -43,38 +63,94 @@ void freeGraphVertex(GraphVertex* p_graph_vertex)
 
 void initGraph(Graph* p_graph)
 {
+    p_graph->p_arena = graph_arena_alloc();
+
+    if (!p_graph->p_arena) {
+        abort();
+    }
+
     p_graph->p_nodes =
-            graph_vertex_map_alloc(initial_capacity,
-                                   load_factor);
+            graph_vertex_map_alloc_in_arena(p_graph->p_arena,
+                                            initial_capacity,
+                                            load_factor);
+
+    p_graph->p_vertex_table = NULL;
+    p_graph->vertex_table_size = 0;
+    p_graph->vertex_table_capacity = 0;
+    p_graph->hole_count = 0;
 }
 
 void freeGraph(Graph* p_graph)
 {
-	graph_vertex_map_iterator* p_iterator =
-		graph_vertex_map_iterator_alloc(p_graph->p_nodes);
+    /* Every vertex and map of the graph lives in the arena: */
+    graph_arena_destroy(p_graph->p_arena);
+    p_graph->p_arena = NULL;
+    p_graph->p_nodes = NULL;
+
+    allocator_free(p_graph->p_vertex_table);
+    p_graph->p_vertex_table = NULL;
+    p_graph->vertex_table_size = 0;
+    p_graph->vertex_table_capacity = 0;
+    p_graph->hole_count = 0;
+}
+
+static int ensure_vertex_table_capacity(Graph* p_graph)
+{
+    GraphVertex** p_new_table;
+    size_t new_capacity;
+
+    if (p_graph->vertex_table_size < p_graph->vertex_table_capacity)
+    {
+        return RETURN_STATUS_OK;
+    }
 
-	GraphVertex* p_graph_vertex;
-    size_t p_vertex_id;
+    new_capacity = p_graph->vertex_table_capacity ?
+                   2 * p_graph->vertex_table_capacity :
+                   initial_capacity;
 
-    if (!p_iterator) {
-        abort();
+    p_new_table = allocator_realloc(p_graph->p_vertex_table,
+                                    sizeof(GraphVertex*) * new_capacity);
+
+    if (!p_new_table)
+    {
+        return RETURN_STATUS_NO_MEMORY;
     }
 
-	while (graph_vertex_map_iterator_has_next(p_iterator))
-	{
-		graph_vertex_map_iterator_next(
-			p_iterator,
-			&p_vertex_id,
-			&p_graph_vertex);
+    p_graph->p_vertex_table = p_new_table;
+    p_graph->vertex_table_capacity = new_capacity;
+    return RETURN_STATUS_OK;
+}
+
+int reserveGraph(Graph* p_graph, size_t vertex_count)
+{
+    GraphVertex** p_new_table;
+    size_t new_capacity = p_graph->hole_count + vertex_count;
+
+    if (graph_vertex_map_reserve(p_graph->p_nodes,
+                                 vertex_count) != RETURN_STATUS_OK)
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    if (new_capacity <= p_graph->vertex_table_capacity)
+    {
+        return RETURN_STATUS_OK;
+    }
+
+    p_new_table = allocator_realloc(p_graph->p_vertex_table,
+                                    sizeof(GraphVertex*) * new_capacity);
 
-		freeGraphVertex(p_graph_vertex);
-	}
+    if (!p_new_table)
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
 
-	graph_vertex_map_free(p_graph->p_nodes);
-	p_graph->p_nodes = NULL;
+    p_graph->p_vertex_table = p_new_table;
+    p_graph->vertex_table_capacity = new_capacity;
+    return RETURN_STATUS_OK;
 }
 
-GraphVertex* addVertex(Graph* p_graph, size_t vertex_id)
+GraphVertex* addVertex(Graph* p_graph, vertex_id_t vertex_id)
 {
     GraphVertex* p_graph_vertex =
             graph_vertex_map_get(p_graph->p_nodes, vertex_id);
@@ -84,32 +160,55 @@ GraphVertex* addVertex(Graph* p_graph, size_t vertex_id)
         return p_graph_vertex;
     }
 
-    p_graph_vertex = malloc(sizeof(GraphVertex));
+    /* The vertex indices must fit in a vertex_id_t: */
+    if (p_graph->vertex_table_size >= VERTEX_ID_MAX)
+    {
+        return NULL;
+    }
 
-    initGraphVertex(p_graph_vertex, vertex_id);
+    if (ensure_vertex_table_capacity(p_graph) != RETURN_STATUS_OK)
+    {
+        return NULL;
+    }
+
+    p_graph_vertex = graph_arena_malloc(p_graph->p_arena,
+                                        sizeof(GraphVertex));
+
+    if (!p_graph_vertex)
+    {
+        return NULL;
+    }
+
+    init_vertex_in_arena(p_graph_vertex, vertex_id, p_graph->p_arena);
 
     if (graph_vertex_map_put(p_graph->p_nodes,
                              vertex_id,
                              p_graph_vertex) != RETURN_STATUS_OK) {
+        freeGraphVertex(p_graph_vertex);
+        graph_arena_free(p_graph->p_arena,
+                         p_graph_vertex,
+                         sizeof(GraphVertex));
         return NULL;
     }
 
+    p_graph_vertex->index = p_graph->vertex_table_size;
+    p_graph->p_vertex_table[p_graph->vertex_table_size++] = p_graph_vertex;
     return p_graph_vertex;
 }
 
-void removeVertex(Graph* p_graph, size_t vertex_id)
+void removeVertex(Graph* p_graph, vertex_id_t vertex_id)
 {
     GraphVertex* p_graph_vertex;
     GraphVertex* p_child_vertex;
     GraphVertex* p_parent_vertex;
 
-    size_t child_vertex_id;
-    size_t parent_vertex_id;
+    vertex_id_t child_index;
+    vertex_id_t parent_index;
 
-    weight_map_iterator* p_child_iterator;
-    weight_map_iterator* p_parent_iterator;
+    weight_map_iterator child_iterator;
+    weight_map_iterator parent_iterator;
 
-    double weight;
+    weight_t weight;
 
     p_graph_vertex = graph_vertex_map_get(p_graph->p_nodes, vertex_id);
 
@@ -117,59 +216,120 @@ void removeVertex(Graph* p_graph, size_t vertex_id)
         return;
     }
 
-    p_child_iterator =
-            weight_map_iterator_alloc(p_graph_vertex->p_children);
+    weight_map_iterator_init(&child_iterator, p_graph_vertex->p_children);
 
     /* Disconnect from children: */
-    while (weight_map_iterator_has_next(p_child_iterator))
+    while (weight_map_iterator_has_next(&child_iterator))
     {
-        weight_map_iterator_visit(p_child_iterator,
-                                  &child_vertex_id,
+        weight_map_iterator_visit(&child_iterator,
+                                  &child_index,
                                   &weight);
 
-        weight_map_iterator_remove(p_child_iterator);
+        weight_map_iterator_remove(&child_iterator);
 
-        /* Grab the weight map from child_vertex_id: */
-        p_child_vertex = graph_vertex_map_get(p_graph->p_nodes,
-                                              child_vertex_id);
+        /* Grab the weight map from child_index: */
+        p_child_vertex = p_graph->p_vertex_table[child_index];
 
         weight_map_remove(p_child_vertex->p_parents,
-                          p_graph_vertex->id);
+                          p_graph_vertex->index);
     }
 
-    p_parent_iterator =
-            weight_map_iterator_alloc(p_graph_vertex->p_parents);
+    weight_map_iterator_init(&parent_iterator, p_graph_vertex->p_parents);
 
     /* Disconnect from parents: */
-    while (weight_map_iterator_has_next(p_parent_iterator))
+    while (weight_map_iterator_has_next(&parent_iterator))
     {
-        weight_map_iterator_visit(p_parent_iterator,
-                                  &parent_vertex_id,
+        weight_map_iterator_visit(&parent_iterator,
+                                  &parent_index,
                                   &weight);
 
-        weight_map_iterator_remove(p_parent_iterator);
+        weight_map_iterator_remove(&parent_iterator);
 
-        p_parent_vertex = graph_vertex_map_get(p_graph->p_nodes,
-                                               parent_vertex_id);
+        p_parent_vertex = p_graph->p_vertex_table[parent_index];
 
         weight_map_remove(p_parent_vertex->p_children,
-                          p_graph_vertex->id);
+                          p_graph_vertex->index);
     }
 
     graph_vertex_map_remove(p_graph->p_nodes, vertex_id);
 
-    /* Free the children/parents maps: */
+    /* Leave a hole in the vertex table: */
+    p_graph->p_vertex_table[p_graph_vertex->index] = NULL;
+    p_graph->hole_count++;
+
+    /* Return the vertex and its children/parents maps to the arena: */
     freeGraphVertex(p_graph_vertex);
+    graph_arena_free(p_graph->p_arena, p_graph_vertex, sizeof(GraphVertex));
 }
 
-int hasVertex(Graph* p_graph, size_t vertex_id)
+/*******************************************************************************
+* Renumbers the vertices so that the vertex indices form the range             *
+* 0..n - 1 again, where n is the number of vertices in the graph. The relative *
+* order of the vertices is preserved.                                          *
+*******************************************************************************/
+int compactGraph(Graph* p_graph)
+{
+    vertex_id_t* p_index_map;
+    size_t old_index;
+    size_t new_index = 0;
+    GraphVertex* p_graph_vertex;
+
+    if (p_graph->hole_count == 0)
+    {
+        return RETURN_STATUS_OK;
+    }
+
+    p_index_map =
+            allocator_malloc(sizeof(vertex_id_t) * p_graph->vertex_table_size);
+
+    if (!p_index_map)
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    for (old_index = 0;
+         old_index < p_graph->vertex_table_size;
+         ++old_index)
+    {
+        p_graph_vertex = p_graph->p_vertex_table[old_index];
+
+        if (p_graph_vertex)
+        {
+            p_index_map[old_index] = new_index;
+            p_graph_vertex->index = new_index;
+            p_graph->p_vertex_table[new_index++] = p_graph_vertex;
+        }
+    }
+
+    p_graph->vertex_table_size = new_index;
+    p_graph->hole_count = 0;
+
+    for (new_index = 0;
+         new_index < p_graph->vertex_table_size;
+         ++new_index)
+    {
+        p_graph_vertex = p_graph->p_vertex_table[new_index];
+        weight_map_remap_keys(p_graph_vertex->p_children, p_index_map);
+        weight_map_remap_keys(p_graph_vertex->p_parents,  p_index_map);
+    }
+
+    allocator_free(p_index_map);
+    return RETURN_STATUS_OK;
+}
+
+void getVertexMapStats(Graph* p_graph, vertex_hash_table_stats* p_stats)
+{
+    vertex_hash_table_get_stats(&p_graph->p_nodes->table, p_stats);
+}
+
+int hasVertex(Graph* p_graph, vertex_id_t vertex_id)
 {
     return graph_vertex_map_contains_key(
             p_graph->p_nodes,
             vertex_id);
 }
 
-GraphVertex* getVertex(Graph* p_graph, size_t vertex_id)
+GraphVertex* getVertex(Graph* p_graph, vertex_id_t vertex_id)
 {
     GraphVertex* p_graph_vertex =
             graph_vertex_map_get(p_graph->p_nodes,
@@ -179,34 +339,12 @@ GraphVertex* getVertex(Graph* p_graph, size_t vertex_id)
 }
 
 int addEdge(Graph* p_graph,
-            size_t tail_vertex_id,
-            size_t head_vertex_id,
-            double weight)
+            vertex_id_t tail_vertex_id,
+            vertex_id_t head_vertex_id,
+            weight_t weight)
 {
     GraphVertex* p_head_vertex;
     GraphVertex* p_tail_vertex;
-    GraphVertex* p_temp_vertex;
-
-    if (hasEdge(p_graph, tail_vertex_id, head_vertex_id)) {
-        /* Update weight: */
-        p_temp_vertex =
-                graph_vertex_map_get(p_graph->p_nodes,
-                                     tail_vertex_id);
-
-        weight_map_put(p_temp_vertex->p_children,
-                       head_vertex_id,
-                       weight);
-
-        p_temp_vertex =
-                graph_vertex_map_get(p_graph->p_nodes,
-                                     head_vertex_id);
-
-        weight_map_put(p_temp_vertex->p_parents,
-                       tail_vertex_id,
-                       weight);
-
-        return RETURN_STATUS_OK;
-    }
 
     p_tail_vertex = addVertex(p_graph, tail_vertex_id);
 
@@ -220,14 +358,15 @@ int addEdge(Graph* p_graph,
         return RETURN_STATUS_NO_MEMORY;
     }
 
+    /* If the edge is already there, only its weight is updated: */
     if (weight_map_put(p_tail_vertex->p_children,
-                       p_head_vertex->id,
+                       p_head_vertex->index,
                        weight) != RETURN_STATUS_OK) {
         return RETURN_STATUS_NO_MEMORY;
     }
 
     if (weight_map_put(p_head_vertex->p_parents,
-                       p_tail_vertex->id,
+                       p_tail_vertex->index,
                        weight) != RETURN_STATUS_OK) {
         return RETURN_STATUS_NO_MEMORY;
     }
@@ -235,9 +374,327 @@ int addEdge(Graph* p_graph,
     return RETURN_STATUS_OK;
 }
 
+/*******************************************************************************
+* Maps the endpoints of the arcs to vertex indices, adding the missing         *
+* vertices in the same order as 'addEdge' would.                               *
+*******************************************************************************/
+static int resolve_endpoints(Graph* p_graph,
+                             const vertex_id_t* tail_vertex_ids,
+                             const vertex_id_t* head_vertex_ids,
+                             size_t edge_count,
+                             vertex_id_t* tail_indices,
+                             vertex_id_t* head_indices)
+{
+    GraphVertex* p_tail_vertex = NULL;
+    GraphVertex* p_head_vertex;
+    size_t i;
+
+    for (i = 0; i < edge_count; ++i)
+    {
+        /* Arc lists usually come grouped by tail; reuse the last lookup: */
+        if (!p_tail_vertex || p_tail_vertex->id != tail_vertex_ids[i])
+        {
+            p_tail_vertex = addVertex(p_graph, tail_vertex_ids[i]);
+        }
+
+        p_head_vertex = addVertex(p_graph, head_vertex_ids[i]);
+
+        if (!p_tail_vertex || !p_head_vertex)
+        {
+            return RETURN_STATUS_NO_MEMORY;
+        }
+
+        tail_indices[i] = p_tail_vertex->index;
+        head_indices[i] = p_head_vertex->index;
+    }
+
+    return RETURN_STATUS_OK;
+}
+
+/*******************************************************************************
+* Sorts the arcs by 'keys' into 'order' with a stable counting sort, leaving   *
+* the arcs with the key 'k' in [offsets[k], offsets[k + 1]). If 'winners' is   *
+* not NULL, the merged arcs are left out.                                      *
+*******************************************************************************/
+static void bucket_arcs(const vertex_id_t* keys,
+                        const size_t* winners,
+                        size_t edge_count,
+                        size_t key_count,
+                        size_t* offsets,
+                        size_t* order)
+{
+    size_t arc;
+    size_t key;
+
+    memset(offsets, 0, sizeof(size_t) * (key_count + 1));
+
+    for (arc = 0; arc < edge_count; ++arc)
+    {
+        if (!winners || winners[arc] != merged_arc)
+        {
+            offsets[keys[arc] + 1]++;
+        }
+    }
+
+    for (key = 1; key <= key_count; ++key)
+    {
+        offsets[key] += offsets[key - 1];
+    }
+
+    for (arc = 0; arc < edge_count; ++arc)
+    {
+        if (!winners || winners[arc] != merged_arc)
+        {
+            order[offsets[keys[arc]]++] = arc;
+        }
+    }
+
+    /* Placing the arcs advanced each offset to the start of the next
+       bucket; shift them back: */
+    for (key = key_count; key > 0; --key)
+    {
+        offsets[key] = offsets[key - 1];
+    }
+
+    offsets[0] = 0;
+}
+
+/*******************************************************************************
+* Adds the arcs to the children maps of their tails. Within the bucket of each *
+* tail, the first occurrence of an arc stays and takes the weight of the last  *
+* one: 'winners[arc]' is the arc whose weight it gets, or 'merged_arc' if the  *
+* arc repeats an earlier one. 'slots[head]' is the first occurrence of the arc *
+* from the current tail to 'head', valid while 'last_tails[head]' is the tail. *
+*******************************************************************************/
+static int add_children(Graph* p_graph,
+                        const vertex_id_t* tail_indices,
+                        const vertex_id_t* head_indices,
+                        const weight_t* weights,
+                        size_t edge_count,
+                        size_t* offsets,
+                        size_t* order,
+                        size_t* winners,
+                        size_t* slots,
+                        vertex_id_t* last_tails)
+{
+    size_t vertex_count = p_graph->vertex_table_size;
+    size_t tail;
+    size_t i;
+    size_t arc;
+    size_t new_arc_count;
+    vertex_id_t head;
+    weight_map* p_children;
+
+    bucket_arcs(tail_indices, NULL, edge_count, vertex_count, offsets, order);
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        last_tails[i] = VERTEX_ID_MAX;
+    }
+
+    for (tail = 0; tail < vertex_count; ++tail)
+    {
+        new_arc_count = 0;
+
+        for (i = offsets[tail]; i < offsets[tail + 1]; ++i)
+        {
+            arc = order[i];
+            head = head_indices[arc];
+
+            if (last_tails[head] == tail)
+            {
+                winners[slots[head]] = arc;
+                winners[arc] = merged_arc;
+            }
+            else
+            {
+                last_tails[head] = (vertex_id_t) tail;
+                slots[head] = arc;
+                winners[arc] = arc;
+                new_arc_count++;
+            }
+        }
+
+        if (new_arc_count == 0)
+        {
+            continue;
+        }
+
+        p_children = p_graph->p_vertex_table[tail]->p_children;
+
+        if (weight_map_reserve(p_children,
+                               weight_map_size(p_children) + new_arc_count)
+                != RETURN_STATUS_OK)
+        {
+            return RETURN_STATUS_NO_MEMORY;
+        }
+
+        for (i = offsets[tail]; i < offsets[tail + 1]; ++i)
+        {
+            arc = order[i];
+
+            if (winners[arc] != merged_arc &&
+                weight_map_put(p_children,
+                               head_indices[arc],
+                               weights[winners[arc]]) != RETURN_STATUS_OK)
+            {
+                return RETURN_STATUS_NO_MEMORY;
+            }
+        }
+    }
+
+    return RETURN_STATUS_OK;
+}
+
+/*******************************************************************************
+* Adds the arcs kept by 'add_children' to the parents maps of their heads, in  *
+* one pass over the arcs grouped by head.                                      *
+*******************************************************************************/
+static int add_parents(Graph* p_graph,
+                       const vertex_id_t* tail_indices,
+                       const vertex_id_t* head_indices,
+                       const weight_t* weights,
+                       size_t edge_count,
+                       size_t* offsets,
+                       size_t* order,
+                       const size_t* winners)
+{
+    size_t vertex_count = p_graph->vertex_table_size;
+    size_t head;
+    size_t i;
+    size_t arc;
+    weight_map* p_parents;
+
+    bucket_arcs(head_indices,
+                winners,
+                edge_count,
+                vertex_count,
+                offsets,
+                order);
+
+    for (head = 0; head < vertex_count; ++head)
+    {
+        if (offsets[head] == offsets[head + 1])
+        {
+            continue;
+        }
+
+        p_parents = p_graph->p_vertex_table[head]->p_parents;
+
+        if (weight_map_reserve(p_parents,
+                               weight_map_size(p_parents) +
+                               offsets[head + 1] - offsets[head])
+                != RETURN_STATUS_OK)
+        {
+            return RETURN_STATUS_NO_MEMORY;
+        }
+
+        for (i = offsets[head]; i < offsets[head + 1]; ++i)
+        {
+            arc = order[i];
+
+            if (weight_map_put(p_parents,
+                               tail_indices[arc],
+                               weights[winners[arc]]) != RETURN_STATUS_OK)
+            {
+                return RETURN_STATUS_NO_MEMORY;
+            }
+        }
+    }
+
+    return RETURN_STATUS_OK;
+}
+
+int addEdges(Graph* p_graph,
+             const vertex_id_t* tail_vertex_ids,
+             const vertex_id_t* head_vertex_ids,
+             const weight_t* weights,
+             size_t edge_count,
+             size_t vertex_count_hint)
+{
+    vertex_id_t* tail_indices;
+    vertex_id_t* head_indices;
+    size_t* order;
+    size_t* winners;
+    size_t* offsets = NULL;
+    size_t* slots = NULL;
+    vertex_id_t* last_tails = NULL;
+    size_t vertex_count;
+    int status;
+
+    if (!p_graph)
+    {
+        return RETURN_STATUS_NO_GRAPH;
+    }
+
+    if (vertex_count_hint > 0 &&
+        reserveGraph(p_graph, vertex_count_hint) != RETURN_STATUS_OK)
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    tail_indices = allocator_malloc(sizeof(vertex_id_t) * (edge_count + 1));
+    head_indices = allocator_malloc(sizeof(vertex_id_t) * (edge_count + 1));
+    order = allocator_malloc(sizeof(size_t) * (edge_count + 1));
+    winners = allocator_malloc(sizeof(size_t) * (edge_count + 1));
+    status = RETURN_STATUS_NO_MEMORY;
+
+    if (tail_indices && head_indices && order && winners)
+    {
+        status = resolve_endpoints(p_graph,
+                                   tail_vertex_ids,
+                                   head_vertex_ids,
+                                   edge_count,
+                                   tail_indices,
+                                   head_indices);
+    }
+
+    if (status == RETURN_STATUS_OK)
+    {
+        vertex_count = p_graph->vertex_table_size;
+        offsets = allocator_malloc(sizeof(size_t) * (vertex_count + 1));
+        slots = allocator_malloc(sizeof(size_t) * (vertex_count + 1));
+        last_tails = allocator_malloc(sizeof(vertex_id_t) * (vertex_count + 1));
+
+        status = offsets && slots && last_tails ?
+                 add_children(p_graph,
+                              tail_indices,
+                              head_indices,
+                              weights,
+                              edge_count,
+                              offsets,
+                              order,
+                              winners,
+                              slots,
+                              last_tails) :
+                 RETURN_STATUS_NO_MEMORY;
+    }
+
+    if (status == RETURN_STATUS_OK)
+    {
+        status = add_parents(p_graph,
+                             tail_indices,
+                             head_indices,
+                             weights,
+                             edge_count,
+                             offsets,
+                             order,
+                             winners);
+    }
+
+    allocator_free(tail_indices);
+    allocator_free(head_indices);
+    allocator_free(order);
+    allocator_free(winners);
+    allocator_free(offsets);
+    allocator_free(slots);
+    allocator_free(last_tails);
+    return status;
+}
+
 void removeEdge(Graph* p_graph,
-                size_t tail_vertex_id,
-                size_t head_vertex_id)
+                vertex_id_t tail_vertex_id,
+                vertex_id_t head_vertex_id)
 {
     GraphVertex* p_tail_vertex;
     GraphVertex* p_head_vertex;
@@ -249,37 +706,43 @@ void removeEdge(Graph* p_graph,
         return;
     }
 
-    weight_map_remove(p_head_vertex->p_parents,  tail_vertex_id);
-    weight_map_remove(p_tail_vertex->p_children, head_vertex_id);
+    weight_map_remove(p_head_vertex->p_parents,  p_tail_vertex->index);
+    weight_map_remove(p_tail_vertex->p_children, p_head_vertex->index);
 }
 
 int hasEdge(Graph* p_graph,
-            size_t tail_vertex_id,
-            size_t head_vertex_id)
+            vertex_id_t tail_vertex_id,
+            vertex_id_t head_vertex_id)
 {
-    GraphVertex* p_graph_vertex =
+    GraphVertex* p_tail_vertex =
             graph_vertex_map_get(p_graph->p_nodes, tail_vertex_id);
 
-    if (!p_graph_vertex) {
+    GraphVertex* p_head_vertex =
+            graph_vertex_map_get(p_graph->p_nodes, head_vertex_id);
+
+    if (!p_tail_vertex || !p_head_vertex) {
         return 0;
     }
 
-    return weight_map_contains_key(p_graph_vertex->p_children,
-                                   head_vertex_id);
+    return weight_map_contains_key(p_tail_vertex->p_children,
+                                   p_head_vertex->index);
 }
 
-double getEdgeWeight(
+weight_t getEdgeWeight(
         Graph* p_graph,
-        size_t tail_vertex_id,
-        size_t head_vertex_id)
+        vertex_id_t tail_vertex_id,
+        vertex_id_t head_vertex_id)
 {
-    GraphVertex* p_graph_vertex =
+    GraphVertex* p_tail_vertex =
             graph_vertex_map_get(p_graph->p_nodes, tail_vertex_id);
 
-    if (!p_graph_vertex) {
+    GraphVertex* p_head_vertex =
+            graph_vertex_map_get(p_graph->p_nodes, head_vertex_id);
+
+    if (!p_tail_vertex || !p_head_vertex) {
         abort();
     }
 
-    return weight_map_get(p_graph_vertex->p_children,
-                          head_vertex_id);
+    return weight_map_get(p_tail_vertex->p_children,
+                          p_head_vertex->index);
 }
\ No newline at end of file
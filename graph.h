@@ -1,22 +1,46 @@
 #ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_GRAPH_H
 #define COM_GITHUB_CODERODDE_BIDIR_SEARCH_GRAPH_H
 
+#include "graph_arena.h"
 #include "graph_vertex_map.h"
+#include "types.h"
+#include "vertex_hash_table.h"
 #include "weight_map.h"
 #include <stdlib.h>
 
+/*******************************************************************************
+* Besides its (arbitrary) ID, each vertex has a dense index into the vertex    *
+* table of its graph. The weight maps are keyed by the indices of the          *
+* neighbors, so that traversals never need to look up vertices by their IDs.   *
+*******************************************************************************/
 typedef struct GraphVertex {
-    size_t id;
-    weight_map* p_children; /* Maps a child to the edge weight. */
-    weight_map* p_parents;  /* Maps a parent to the edge weight. */
+    vertex_id_t id;
+    vertex_id_t index;
+    weight_map* p_children; /* Maps a child index to the edge weight. */
+    weight_map* p_parents;  /* Maps a parent index to the edge weight. */
 } GraphVertex;
 
+/*******************************************************************************
+* The vertices, the vertex map and the weight maps of a graph, with all their  *
+* entries, are allocated from the arena of the graph, so that building a graph *
+* makes few calls to the system allocator and 'freeGraph' releases the whole   *
+* graph by destroying the arena, without visiting the vertices.                *
+*******************************************************************************/
 typedef struct Graph {
+    graph_arena* p_arena;
+
     /* Maps each node ID to a vertex: */
     struct graph_vertex_map* p_nodes;
+
+    /* Maps each vertex index to a vertex. Removed vertices leave NULL holes
+       in the table until the graph is compacted: */
+    GraphVertex** p_vertex_table;
+    size_t        vertex_table_size;
+    size_t        vertex_table_capacity;
+    size_t        hole_count;
 } Graph;
 
-void initGraphVertex(GraphVertex* p_graph_vertex, size_t id);
+void initGraphVertex(GraphVertex* p_graph_vertex, vertex_id_t id);
 void freeGraphVertex(GraphVertex* p_graph_vertex);
 
 Graph* allocGraph();
@@ -24,27 +48,70 @@ Graph* allocGraph();
 void initGraph(Graph* p_graph);
 void freeGraph(Graph* p_graph);
 
-GraphVertex* addVertex (Graph* p_graph, size_t vertex_id);
-void removeVertex      (Graph* p_graph, size_t vertex_id);
-int hasVertex          (Graph* p_graph, size_t vertex_id);
-GraphVertex* getVertex (Graph* p_graph, size_t vertex_id);
+/*******************************************************************************
+* 'removeVertex' leaves a hole in the vertex table and keeps the indices of    *
+* the other vertices, so that data keyed by vertex index, such as the          *
+* 'distance_bound' of 'find_shortest_path_astar', stays valid.                 *
+*******************************************************************************/
+GraphVertex* addVertex (Graph* p_graph, vertex_id_t vertex_id);
+void removeVertex      (Graph* p_graph, vertex_id_t vertex_id);
+int hasVertex          (Graph* p_graph, vertex_id_t vertex_id);
+GraphVertex* getVertex (Graph* p_graph, vertex_id_t vertex_id);
+
+/*******************************************************************************
+* Closes the holes the removed vertices left, renumbering the vertices that    *
+* follow them. Only this function renumbers vertices; call it after removing   *
+* many of them and before computing any data keyed by vertex index. Returns    *
+* RETURN_STATUS_OK or RETURN_STATUS_NO_MEMORY, in which case the graph is      *
+* unchanged.                                                                   *
+*******************************************************************************/
+int compactGraph(Graph* p_graph);
+
+/*******************************************************************************
+* Reports how evenly the map from vertex IDs to vertices spreads the IDs of    *
+* the graph. The other maps of a graph are keyed by dense vertex indices, so   *
+* only this one depends on the ID distribution.                                *
+*******************************************************************************/
+void getVertexMapStats(Graph* p_graph, vertex_hash_table_stats* p_stats);
+
+/*******************************************************************************
+* Makes room for 'vertex_count' vertices in total, so that adding them neither *
+* rehashes the vertex map nor grows the vertex table.                          *
+*******************************************************************************/
+int reserveGraph(Graph* p_graph, size_t vertex_count);
 
 int addEdge(
         Graph* p_graph,
-        size_t tail_vertex_id,
-        size_t head_vertex_id,
-        double weight);
+        vertex_id_t tail_vertex_id,
+        vertex_id_t head_vertex_id,
+        weight_t weight);
+
+/*******************************************************************************
+* Adds the 'edge_count' arcs given as parallel arrays of tail IDs, head IDs    *
+* and weights. The result is the same as calling 'addEdge' on each arc in      *
+* turn, but the arcs are grouped by tail and by head first, so that every      *
+* weight map is sized once for all of its new arcs and repeated arcs are       *
+* merged before they reach the maps. 'vertex_count_hint', unless zero, is the  *
+* expected number of vertices in the graph afterwards and is passed to         *
+* 'reserveGraph'. On failure, some of the arcs may have been added.            *
+*******************************************************************************/
+int addEdges(Graph* p_graph,
+             const vertex_id_t* tail_vertex_ids,
+             const vertex_id_t* head_vertex_ids,
+             const weight_t* weights,
+             size_t edge_count,
+             size_t vertex_count_hint);
 
 void removeEdge(Graph* graph,
-                size_t tail_vertex_id,
-                size_t head_vertex_id);
+                vertex_id_t tail_vertex_id,
+                vertex_id_t head_vertex_id);
 
 int hasEdge(Graph* p_graph,
-            size_t tail_vertex_id,
-            size_t head_vertex_id);
+            vertex_id_t tail_vertex_id,
+            vertex_id_t head_vertex_id);
 
-double getEdgeWeight(Graph* p_graph,
-                     size_t tail_vertex_id,
-                     size_t head_vertex_id);
+weight_t getEdgeWeight(Graph* p_graph,
+                       vertex_id_t tail_vertex_id,
+                       vertex_id_t head_vertex_id);
 
 #endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_GRAPH_H */
\ No newline at end of file
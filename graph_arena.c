@@ -0,0 +1,308 @@
+#include "graph_arena.h"
+#include "allocator.h"
+#include "util.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* The blocks are aligned to, and the size classes are multiples of, 8 bytes: */
+#define ALIGNMENT 8
+
+/* Classes 0..15 are 8, 16, ..., 128 bytes; the rest are 256, 512, ...: */
+#define LINEAR_CLASS_COUNT 16
+#define LINEAR_CLASS_LIMIT (LINEAR_CLASS_COUNT * ALIGNMENT)
+#define CLASS_COUNT        (LINEAR_CLASS_COUNT + 7)
+
+/* A freed small block holds the link to the next one of its class: */
+typedef struct free_block {
+    struct free_block* next;
+} free_block;
+
+/* Precedes the payload of every slab and large block: */
+typedef union block_header {
+    struct {
+        union block_header* prev;
+        union block_header* next;
+    } links;
+
+    double alignment; /* Keeps the payload aligned. */
+} block_header;
+
+struct graph_arena {
+    free_block*   free_lists[CLASS_COUNT];
+    char*         p_slab_next; /* The unused rest of the newest slab. */
+    char*         p_slab_end;
+    block_header* slabs;
+    block_header* large_blocks;
+    size_t        reserved_size;
+};
+
+graph_arena* graph_arena_alloc()
+{
+    graph_arena* p_arena = allocator_malloc(sizeof(*p_arena));
+    size_t i;
+
+    if (!p_arena)
+    {
+        return NULL;
+    }
+
+    for (i = 0; i < CLASS_COUNT; ++i)
+    {
+        p_arena->free_lists[i] = NULL;
+    }
+
+    p_arena->p_slab_next = NULL;
+    p_arena->p_slab_end = NULL;
+    p_arena->slabs = NULL;
+    p_arena->large_blocks = NULL;
+    p_arena->reserved_size = sizeof(*p_arena);
+    return p_arena;
+}
+
+static size_t get_class(size_t size)
+{
+    size_t class_index = LINEAR_CLASS_COUNT;
+    size_t class_size = 2 * LINEAR_CLASS_LIMIT;
+
+    if (size <= LINEAR_CLASS_LIMIT)
+    {
+        return size == 0 ? 0 : (size - 1) / ALIGNMENT;
+    }
+
+    while (class_size < size)
+    {
+        class_size <<= 1;
+        class_index++;
+    }
+
+    return class_index;
+}
+
+static size_t get_class_size(size_t class_index)
+{
+    return class_index < LINEAR_CLASS_COUNT ?
+           (class_index + 1) * ALIGNMENT :
+           (size_t) 2 * LINEAR_CLASS_LIMIT <<
+                    (class_index - LINEAR_CLASS_COUNT);
+}
+
+/* Starts a new slab. The rest of the previous one is left unused: */
+static int add_slab(graph_arena* p_arena)
+{
+    block_header* p_slab = allocator_malloc(sizeof(block_header) +
+                                            GRAPH_ARENA_SLAB_SIZE);
+
+    if (!p_slab)
+    {
+        return FALSE;
+    }
+
+    p_slab->links.next = p_arena->slabs;
+    p_arena->slabs = p_slab;
+    p_arena->p_slab_next = (char*)(p_slab + 1);
+    p_arena->p_slab_end = p_arena->p_slab_next + GRAPH_ARENA_SLAB_SIZE;
+    p_arena->reserved_size += sizeof(block_header) + GRAPH_ARENA_SLAB_SIZE;
+    return TRUE;
+}
+
+static void* allocate_small(graph_arena* p_arena, size_t size)
+{
+    size_t class_index = get_class(size);
+    size_t class_size = get_class_size(class_index);
+    free_block* p_block = p_arena->free_lists[class_index];
+    void* p_result;
+
+    if (p_block)
+    {
+        p_arena->free_lists[class_index] = p_block->next;
+        return p_block;
+    }
+
+    if ((size_t)(p_arena->p_slab_end - p_arena->p_slab_next) < class_size &&
+        !add_slab(p_arena))
+    {
+        return NULL;
+    }
+
+    p_result = p_arena->p_slab_next;
+    p_arena->p_slab_next += class_size;
+    return p_result;
+}
+
+static void* allocate_large(graph_arena* p_arena, size_t size)
+{
+    block_header* p_header;
+
+    if (size > (size_t) -1 - sizeof(block_header))
+    {
+        return NULL;
+    }
+
+    p_header = allocator_malloc(sizeof(block_header) + size);
+
+    if (!p_header)
+    {
+        return NULL;
+    }
+
+    p_header->links.prev = NULL;
+    p_header->links.next = p_arena->large_blocks;
+
+    if (p_arena->large_blocks)
+    {
+        p_arena->large_blocks->links.prev = p_header;
+    }
+
+    p_arena->large_blocks = p_header;
+    p_arena->reserved_size += sizeof(block_header) + size;
+    return p_header + 1;
+}
+
+static void unlink_large(graph_arena* p_arena, block_header* p_header)
+{
+    if (p_header->links.prev)
+    {
+        p_header->links.prev->links.next = p_header->links.next;
+    }
+    else
+    {
+        p_arena->large_blocks = p_header->links.next;
+    }
+
+    if (p_header->links.next)
+    {
+        p_header->links.next->links.prev = p_header->links.prev;
+    }
+}
+
+void* graph_arena_malloc(graph_arena* p_arena, size_t size)
+{
+    if (!p_arena)
+    {
+        return allocator_malloc(size);
+    }
+
+    return size <= GRAPH_ARENA_MAX_SMALL_SIZE ?
+           allocate_small(p_arena, size) :
+           allocate_large(p_arena, size);
+}
+
+void* graph_arena_calloc(graph_arena* p_arena, size_t count, size_t size)
+{
+    void* p_block;
+
+    if (!p_arena)
+    {
+        return allocator_calloc(count, size);
+    }
+
+    if (size != 0 && count > (size_t) -1 / size)
+    {
+        return NULL;
+    }
+
+    p_block = graph_arena_malloc(p_arena, count * size);
+
+    if (p_block)
+    {
+        memset(p_block, 0, count * size);
+    }
+
+    return p_block;
+}
+
+void graph_arena_free(graph_arena* p_arena, void* p_block, size_t size)
+{
+    free_block* p_free_block = p_block;
+    block_header* p_header;
+    size_t class_index;
+
+    if (!p_arena)
+    {
+        allocator_free(p_block);
+        return;
+    }
+
+    if (!p_block)
+    {
+        return;
+    }
+
+    if (size > GRAPH_ARENA_MAX_SMALL_SIZE)
+    {
+        p_header = (block_header*) p_block - 1;
+        unlink_large(p_arena, p_header);
+        p_arena->reserved_size -= sizeof(block_header) + size;
+        allocator_free(p_header);
+        return;
+    }
+
+    class_index = get_class(size);
+    p_free_block->next = p_arena->free_lists[class_index];
+    p_arena->free_lists[class_index] = p_free_block;
+}
+
+void* graph_arena_realloc(graph_arena* p_arena,
+                          void* p_block,
+                          size_t old_size,
+                          size_t new_size)
+{
+    void* p_new_block;
+
+    if (!p_arena)
+    {
+        return allocator_realloc(p_block, new_size);
+    }
+
+    if (!p_block)
+    {
+        return graph_arena_malloc(p_arena, new_size);
+    }
+
+    if (old_size <= GRAPH_ARENA_MAX_SMALL_SIZE &&
+        new_size <= GRAPH_ARENA_MAX_SMALL_SIZE &&
+        get_class(old_size) == get_class(new_size))
+    {
+        return p_block;
+    }
+
+    p_new_block = graph_arena_malloc(p_arena, new_size);
+
+    if (!p_new_block)
+    {
+        return NULL;
+    }
+
+    memcpy(p_new_block, p_block, old_size < new_size ? old_size : new_size);
+    graph_arena_free(p_arena, p_block, old_size);
+    return p_new_block;
+}
+
+size_t graph_arena_reserved_size(graph_arena* p_arena)
+{
+    return p_arena ? p_arena->reserved_size : 0;
+}
+
+static void free_blocks(block_header* p_header)
+{
+    block_header* p_next;
+
+    while (p_header)
+    {
+        p_next = p_header->links.next;
+        allocator_free(p_header);
+        p_header = p_next;
+    }
+}
+
+void graph_arena_destroy(graph_arena* p_arena)
+{
+    if (!p_arena)
+    {
+        return;
+    }
+
+    free_blocks(p_arena->slabs);
+    free_blocks(p_arena->large_blocks);
+    allocator_free(p_arena);
+}
@@ -0,0 +1,49 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_GRAPH_ARENA_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_GRAPH_ARENA_H
+
+#include <stdlib.h>
+
+/*******************************************************************************
+* A slab allocator that owns all the storage of one graph. Requests up to      *
+* GRAPH_ARENA_MAX_SMALL_SIZE bytes are rounded up to a size class, multiples   *
+* of 8 bytes up to 128 and powers of two beyond, and carved from slabs of      *
+* GRAPH_ARENA_SLAB_SIZE bytes; a freed block goes to the free list of its      *
+* class and is handed out again before the slabs grow. Larger requests get     *
+* blocks of their own. The caller passes the size of a block back when         *
+* freeing or resizing it, so small blocks carry no header. Destroying the      *
+* arena releases the slabs and the large blocks without visiting the objects   *
+* in them.                                                                     *
+*                                                                              *
+* Every function also accepts a NULL arena, in which case it falls back to     *
+* the standard allocator, so that data structures can take an optional arena.  *
+*******************************************************************************/
+#define GRAPH_ARENA_SLAB_SIZE      (256 * 1024)
+#define GRAPH_ARENA_MAX_SMALL_SIZE (16 * 1024)
+
+typedef struct graph_arena graph_arena;
+
+graph_arena* graph_arena_alloc();
+
+void* graph_arena_malloc(graph_arena* p_arena, size_t size);
+
+void* graph_arena_calloc(graph_arena* p_arena, size_t count, size_t size);
+
+/*******************************************************************************
+* Resizes the block 'p_block' of 'old_size' bytes to 'new_size' bytes like     *
+* 'realloc'. The block stays in place if both sizes fall in the same class.    *
+*******************************************************************************/
+void* graph_arena_realloc(graph_arena* p_arena,
+                          void* p_block,
+                          size_t old_size,
+                          size_t new_size);
+
+/* Returns the block 'p_block' of 'size' bytes to the arena: */
+void graph_arena_free(graph_arena* p_arena, void* p_block, size_t size);
+
+/* The bytes the arena has taken from the system: */
+size_t graph_arena_reserved_size(graph_arena* p_arena);
+
+/* Releases the arena together with every block allocated from it: */
+void graph_arena_destroy(graph_arena* p_arena);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_GRAPH_ARENA_H */
@@ -0,0 +1,392 @@
+#include "allocator.h"
+#include "edge_list.h"
+#include "frozen_graph.h"
+#include "frozen_graph_builder.h"
+#include "graph_import.h"
+#include "types.h"
+#include "util.h"
+#include <float.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRY_REPORT_RETURN_STATUS(RETURN_STATUS) \
+if (p_return_status) {                          \
+    *p_return_status = RETURN_STATUS;           \
+}
+
+static const size_t READ_BLOCK_SIZE = 1 << 20;
+
+/* A decimal with at most this many digits is an exact double mantissa: */
+#define MAX_FAST_WEIGHT_DIGITS 15
+
+static const double POWERS_OF_TEN[MAX_FAST_WEIGHT_DIGITS + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+    1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+};
+
+static const char* skip_blanks(const char* p)
+{
+    while (*p == ' ' || *p == '\t' || *p == '\r')
+    {
+        ++p;
+    }
+
+    return p;
+}
+
+static int scan_vertex_id(const char** pp, vertex_id_t* p_vertex_id)
+{
+    const char* p = skip_blanks(*pp);
+    vertex_id_t vertex_id = 0;
+    vertex_id_t digit;
+
+    if (*p < '0' || *p > '9')
+    {
+        return FALSE;
+    }
+
+    do
+    {
+        digit = (vertex_id_t)(*p - '0');
+
+        if (vertex_id > (VERTEX_ID_MAX - digit) / 10)
+        {
+            return FALSE;
+        }
+
+        vertex_id = 10 * vertex_id + digit;
+        ++p;
+    }
+    while (*p >= '0' && *p <= '9');
+
+    *pp = p;
+    *p_vertex_id = vertex_id;
+    return TRUE;
+}
+
+/*******************************************************************************
+* Scans a non-negative decimal such as '12', '0.25' or '.5'. Short decimals    *
+* are assembled from their digits: the mantissa and the power of ten are both  *
+* exact, so the one division rounds just as 'strtod' would. Long decimals and  *
+* exponents are left to 'strtod'.                                              *
+*******************************************************************************/
+static int scan_weight(const char** pp, double* p_weight)
+{
+    const char* p = skip_blanks(*pp);
+    const char* p_start = p;
+    char* p_end;
+    double mantissa = 0.0;
+    int digit_count = 0;
+    int fraction_digit_count = 0;
+
+    while (*p >= '0' && *p <= '9')
+    {
+        mantissa = 10.0 * mantissa + (*p++ - '0');
+        digit_count++;
+    }
+
+    if (*p == '.')
+    {
+        ++p;
+
+        while (*p >= '0' && *p <= '9')
+        {
+            mantissa = 10.0 * mantissa + (*p++ - '0');
+            digit_count++;
+            fraction_digit_count++;
+        }
+    }
+
+    if (digit_count == 0)
+    {
+        return FALSE;
+    }
+
+    if (digit_count > MAX_FAST_WEIGHT_DIGITS || *p == 'e' || *p == 'E')
+    {
+        *p_weight = strtod(p_start, &p_end);
+        *pp = p_end;
+        return TRUE;
+    }
+
+    *p_weight = mantissa / POWERS_OF_TEN[fraction_digit_count];
+    *pp = p;
+    return TRUE;
+}
+
+static int convert_weight(double value, weight_t* p_weight)
+{
+#if defined(BIDIR_SEARCH_WEIGHT_UINT32)
+    if (value > UINT_MAX)
+    {
+        return RETURN_STATUS_PARSE_ERROR;
+    }
+
+    if ((double)(weight_t) value != value)
+    {
+        return RETURN_STATUS_NON_INTEGER_WEIGHT;
+    }
+#elif defined(BIDIR_SEARCH_WEIGHT_FLOAT)
+    /* Also false for the infinity 'strtod' returns on overflow: */
+    if (!(value <= FLT_MAX))
+    {
+        return RETURN_STATUS_PARSE_ERROR;
+    }
+#else
+    if (!(value <= DBL_MAX))
+    {
+        return RETURN_STATUS_PARSE_ERROR;
+    }
+#endif
+    *p_weight = (weight_t) value;
+    return RETURN_STATUS_OK;
+}
+
+/* Parses the fields 'u v w' of an arc line, where 'w' may be optional: */
+static int parse_arc(const char* p,
+                     int weight_is_optional,
+                     edge_list* p_edge_list)
+{
+    vertex_id_t tail_vertex_id;
+    vertex_id_t head_vertex_id;
+    double value = 1.0;
+    weight_t weight;
+    int status;
+
+    if (!scan_vertex_id(&p, &tail_vertex_id) ||
+        !scan_vertex_id(&p, &head_vertex_id))
+    {
+        return RETURN_STATUS_PARSE_ERROR;
+    }
+
+    p = skip_blanks(p);
+
+    if (*p != '\n' || !weight_is_optional)
+    {
+        if (!scan_weight(&p, &value))
+        {
+            return RETURN_STATUS_PARSE_ERROR;
+        }
+
+        p = skip_blanks(p);
+    }
+
+    if (*p != '\n')
+    {
+        return RETURN_STATUS_PARSE_ERROR;
+    }
+
+    status = convert_weight(value, &weight);
+
+    if (status != RETURN_STATUS_OK)
+    {
+        return status;
+    }
+
+    return edge_list_add(p_edge_list, tail_vertex_id, head_vertex_id, weight);
+}
+
+/* Parses one line, which must end with a newline character: */
+static int parse_line(const char* p_line, int format, edge_list* p_edge_list)
+{
+    const char* p = skip_blanks(p_line);
+
+    if (*p == '\n')
+    {
+        return RETURN_STATUS_OK;
+    }
+
+    if (format == GRAPH_IMPORT_DIMACS)
+    {
+        if (*p == 'a')
+        {
+            return parse_arc(p + 1, FALSE, p_edge_list);
+        }
+
+        return *p == 'c' || *p == 'p' ? RETURN_STATUS_OK :
+                                        RETURN_STATUS_PARSE_ERROR;
+    }
+
+    if (*p == '#' || *p == '%')
+    {
+        return RETURN_STATUS_OK;
+    }
+
+    return parse_arc(p, TRUE, p_edge_list);
+}
+
+/* Parses the lines in [p_begin, p_end), where 'p_end' follows a newline: */
+static int parse_lines(const char* p_begin,
+                       const char* p_end,
+                       int format,
+                       edge_list* p_edge_list)
+{
+    int status;
+
+    while (p_begin < p_end)
+    {
+        status = parse_line(p_begin, format, p_edge_list);
+
+        if (status != RETURN_STATUS_OK)
+        {
+            return status;
+        }
+
+        p_begin = (const char*) memchr(p_begin, '\n', p_end - p_begin) + 1;
+    }
+
+    return RETURN_STATUS_OK;
+}
+
+/* Returns one past the last newline in the first 'size' bytes, or NULL: */
+static char* find_end_of_lines(char* buffer, size_t size)
+{
+    while (size > 0)
+    {
+        if (buffer[--size] == '\n')
+        {
+            return buffer + size + 1;
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Reads the file block by block. Only whole lines are parsed; the unfinished   *
+* line at the end of a block is moved to the front of the buffer and           *
+* completed by the next read. A short read marks the end of the file, which    *
+* leaves room to end its last line with a newline if it lacks one.             *
+*******************************************************************************/
+static int read_lines(FILE* file, int format, edge_list* p_edge_list)
+{
+    size_t capacity = READ_BLOCK_SIZE;
+    char* buffer = allocator_malloc(capacity);
+    char* new_buffer;
+    char* p_end_of_lines;
+    size_t pending_size = 0;
+    size_t size;
+    int at_end = FALSE;
+    int status = RETURN_STATUS_OK;
+
+    if (!buffer)
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    while (status == RETURN_STATUS_OK && !at_end)
+    {
+        /* Make room for a line longer than the buffer: */
+        if (pending_size == capacity)
+        {
+            new_buffer = allocator_realloc(buffer, 2 * capacity);
+
+            if (!new_buffer)
+            {
+                status = RETURN_STATUS_NO_MEMORY;
+                break;
+            }
+
+            buffer = new_buffer;
+            capacity *= 2;
+        }
+
+        size = pending_size + fread(buffer + pending_size,
+                                    1,
+                                    capacity - pending_size,
+                                    file);
+
+        if (size < capacity)
+        {
+            if (ferror(file))
+            {
+                status = RETURN_STATUS_IO_ERROR;
+                break;
+            }
+
+            at_end = TRUE;
+
+            if (size > 0 && buffer[size - 1] != '\n')
+            {
+                buffer[size++] = '\n';
+            }
+        }
+
+        p_end_of_lines = find_end_of_lines(buffer, size);
+
+        if (!p_end_of_lines)
+        {
+            pending_size = size;
+            continue;
+        }
+
+        status = parse_lines(buffer, p_end_of_lines, format, p_edge_list);
+        pending_size = size - (size_t)(p_end_of_lines - buffer);
+        memmove(buffer, p_end_of_lines, pending_size);
+    }
+
+    allocator_free(buffer);
+    return status;
+}
+
+int edge_list_import(edge_list* p_edge_list, const char* file_name, int format)
+{
+    FILE* file;
+    int status;
+
+    if (format != GRAPH_IMPORT_DIMACS && format != GRAPH_IMPORT_EDGE_LIST)
+    {
+        abort();
+    }
+
+    if (!p_edge_list)
+    {
+        return RETURN_STATUS_NO_GRAPH;
+    }
+
+    file = fopen(file_name, "rb");
+
+    if (!file)
+    {
+        return RETURN_STATUS_IO_ERROR;
+    }
+
+    status = read_lines(file, format, p_edge_list);
+    fclose(file);
+    return status;
+}
+
+frozen_graph* frozen_graph_import(const char* file_name,
+                                  int format,
+                                  int* p_return_status)
+{
+    edge_list* p_edge_list = edge_list_alloc(0);
+    frozen_graph* p_frozen_graph;
+    int status;
+
+    if (!p_edge_list)
+    {
+        TRY_REPORT_RETURN_STATUS(RETURN_STATUS_NO_MEMORY);
+        return NULL;
+    }
+
+    status = edge_list_import(p_edge_list, file_name, format);
+
+    if (status != RETURN_STATUS_OK)
+    {
+        edge_list_free(p_edge_list);
+        TRY_REPORT_RETURN_STATUS(status);
+        return NULL;
+    }
+
+    p_frozen_graph = frozen_graph_build(p_edge_list->tails,
+                                        p_edge_list->heads,
+                                        p_edge_list->weights,
+                                        p_edge_list->size,
+                                        p_return_status);
+
+    edge_list_free(p_edge_list);
+    return p_frozen_graph;
+}
@@ -0,0 +1,42 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_GRAPH_IMPORT_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_GRAPH_IMPORT_H
+
+#include "edge_list.h"
+#include "frozen_graph.h"
+
+/*******************************************************************************
+* The text formats understood by the importer:                                 *
+*   GRAPH_IMPORT_DIMACS    - the '.gr' format of the 9th DIMACS Implementation *
+*                            Challenge: 'c' comment lines, a 'p sp n m'        *
+*                            problem line and 'a u v w' arc lines.             *
+*   GRAPH_IMPORT_EDGE_LIST - one 'u v' or 'u v w' arc per line, where a        *
+*                            missing weight is 1. Lines starting with '#' or   *
+*                            '%' are comments.                                 *
+* In both formats blank lines are skipped, vertex IDs are unsigned integers    *
+* and weights are non-negative decimal numbers. A weight too large for the     *
+* weight type, such as '1e400', is a parse error.                              *
+*******************************************************************************/
+#define GRAPH_IMPORT_DIMACS    0
+#define GRAPH_IMPORT_EDGE_LIST 1
+
+/*******************************************************************************
+* Appends the arcs of the file 'file_name' in the given format to              *
+* 'p_edge_list'. The file is read in large blocks and the numbers are scanned  *
+* in place. Returns RETURN_STATUS_OK, RETURN_STATUS_NO_GRAPH,                  *
+* RETURN_STATUS_IO_ERROR, RETURN_STATUS_PARSE_ERROR, RETURN_STATUS_NO_MEMORY,  *
+* or RETURN_STATUS_NON_INTEGER_WEIGHT if the weights are stored as integers    *
+* and the file has a fractional one. On failure, the arcs read before the      *
+* offending line stay in the list.                                             *
+*******************************************************************************/
+int edge_list_import(edge_list* p_edge_list, const char* file_name, int format);
+
+/*******************************************************************************
+* Reads the file 'file_name' in the given format and builds a frozen graph of  *
+* its arcs with 'frozen_graph_build'. Returns NULL on failure, storing the     *
+* status in '*p_return_status' if it is not NULL.                              *
+*******************************************************************************/
+frozen_graph* frozen_graph_import(const char* file_name,
+                                  int format,
+                                  int* p_return_status);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_GRAPH_IMPORT_H */
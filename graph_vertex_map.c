@@ -1,325 +1,108 @@
 #include "graph_vertex_map.h"
+#include "allocator.h"
 #include "util.h"
 #include <stdlib.h>
 
-graph_vertex_map_entry*
-graph_vertex_map_entry_alloc(size_t vertex_id,
-                             struct GraphVertex* vertex)
-{
-    graph_vertex_map_entry* entry = malloc(sizeof(*entry));
-
-    if (!entry)
-    {
-        return NULL;
-    }
-
-    entry->vertex_id = vertex_id;
-    entry->vertex = vertex;
-    entry->chain_next = NULL;
-    entry->next = NULL;
-    entry->prev = NULL;
-
-    return entry;
-}
-
-static const float  MINIMUM_LOAD_FACTOR = 0.2f;
-static const size_t MINIMUM_INITIAL_CAPACITY = 16;
-
-static float maxf(float a, float b)
-{
-    return a < b ? b : a;
-}
-
-static int maxi(int a, int b)
-{
-    return a < b ? b : a;
-}
-
-/*******************************************************************************
-* Makes sure that the load factor is no less than a minimum threshold.         *
-*******************************************************************************/
-static float fix_load_factor(float load_factor)
-{
-    return maxf(load_factor, MINIMUM_LOAD_FACTOR);
-}
-
-/*******************************************************************************
-* Makes sure that the initial capacity is no less than a minimum allowed and   *
-* is a power of two.                                                           *
-*******************************************************************************/
-static size_t fix_initial_capacity(size_t initial_capacity)
+graph_vertex_map* graph_vertex_map_alloc(size_t initial_capacity,
+                                         float load_factor)
 {
-    size_t ret;
-
-    initial_capacity = maxi(initial_capacity, MINIMUM_INITIAL_CAPACITY);
-    ret = 1;
-
-    while (ret < initial_capacity)
-    {
-        ret <<= 1;
-    }
-
-    return ret;
+    return graph_vertex_map_alloc_in_arena(NULL,
+                                           initial_capacity,
+                                           load_factor);
 }
 
-graph_vertex_map* graph_vertex_map_alloc(size_t initial_capacity,
-                                         float load_factor)
+graph_vertex_map* graph_vertex_map_alloc_in_arena(graph_arena* p_arena,
+                                                  size_t initial_capacity,
+                                                  float load_factor)
 {
-    graph_vertex_map* map = malloc(sizeof(*map));
+    graph_vertex_map* map = graph_arena_malloc(p_arena, sizeof(*map));
 
     if (!map)
     {
         return NULL;
     }
 
-    load_factor = fix_load_factor(load_factor);
-    initial_capacity = fix_initial_capacity(initial_capacity);
-
-    map->load_factor = load_factor;
-    map->table_capacity = initial_capacity;
-    map->size = 0;
-    map->head = NULL;
-    map->tail = NULL;
-    map->table = calloc(initial_capacity,
-                        sizeof(graph_vertex_map_entry*));
-
-    map->mask = initial_capacity - 1;
-    map->max_allowed_size = (size_t)(initial_capacity * load_factor);
-
+    vertex_hash_table_init(&map->table,
+                           p_arena,
+                           sizeof(struct GraphVertex*),
+                           initial_capacity,
+                           load_factor);
     return map;
 }
 
-static int ensure_capacity(graph_vertex_map* map)
+/*******************************************************************************
+* Grows the table once so that it holds 'size' entries in total without        *
+* rehashing.                                                                   *
+*******************************************************************************/
+int graph_vertex_map_reserve(graph_vertex_map* map, size_t size)
 {
-    size_t new_capacity;
-    size_t new_mask;
-    size_t index;
-    graph_vertex_map_entry* entry;
-    graph_vertex_map_entry** new_table;
-
-    if (map->size < map->max_allowed_size)
-    {
-        return RETURN_STATUS_OK;
-    }
-
-    new_capacity = 2 * map->table_capacity;
-    new_mask = new_capacity - 1;
-    new_table = calloc(new_capacity,
-                       sizeof(graph_vertex_map_entry*));
-
-    if (!new_table)
-    {
-        return RETURN_STATUS_NO_MEMORY;
-    }
-
-    /* Rehash the entries. */
-    for (entry = map->head; entry; entry = entry->next)
+    if (!map)
     {
-        index = entry->vertex_id & new_mask;
-        entry->chain_next = new_table[index];
-        new_table[index] = entry;
+        return RETURN_STATUS_NO_MAP;
     }
 
-    free(map->table);
-
-    map->table = new_table;
-    map->table_capacity = new_capacity;
-    map->mask = new_mask;
-    map->max_allowed_size = (size_t)(new_capacity * map->load_factor);
-
-    return RETURN_STATUS_OK;
+    return vertex_hash_table_reserve(&map->table, size);
 }
 
 int graph_vertex_map_put(graph_vertex_map* map,
-                         size_t vertex_id,
+                         vertex_id_t vertex_id,
                          struct GraphVertex* vertex)
 {
-    size_t index;
-    size_t hash_value;
-    graph_vertex_map_entry* entry;
+    size_t slot;
 
     if (!map)
     {
         return RETURN_STATUS_NO_MAP;
     }
 
-    hash_value = vertex_id;
-    index = hash_value & map->mask;
-
-    for (entry = map->table[index]; entry; entry = entry->chain_next)
+    if (vertex_hash_table_insert(&map->table,
+                                 vertex_id,
+                                 &slot) != RETURN_STATUS_OK)
     {
-        if (entry->vertex_id == vertex_id)
-        {
-            entry->vertex = vertex;
-            return RETURN_STATUS_OK;
-        }
-    }
-
-    if (ensure_capacity(map) != RETURN_STATUS_OK) {
-        return RETURN_STATUS_NO_MEMORY;
-    }
-
-    /* Recompute the index since it is possibly changed by
-       'ensure_capacity' */
-    index = hash_value & map->mask;
-    entry = graph_vertex_map_entry_alloc(vertex_id, vertex);
-
-    if (!entry) {
         return RETURN_STATUS_NO_MEMORY;
     }
 
-    entry->chain_next = map->table[index];
-    map->table[index] = entry;
-
-    /* Link the new entry to the tail of the list. */
-    if (!map->tail)
-    {
-        map->head = entry;
-        map->tail = entry;
-    }
-    else
-    {
-        map->tail->next = entry;
-        entry->prev = map->tail;
-        map->tail = entry;
-    }
-
-    map->size++;
+    ((struct GraphVertex**) map->table.values)[slot] = vertex;
     return RETURN_STATUS_OK;
 }
 
-int graph_vertex_map_contains_key(graph_vertex_map* map, size_t vertex_id)
+int graph_vertex_map_contains_key(graph_vertex_map* map, vertex_id_t vertex_id)
 {
-    size_t index;
-    graph_vertex_map_entry* entry;
-
     if (!map)
     {
         return 0;
     }
 
-    index = vertex_id & map->mask;
-
-    for (entry = map->table[index]; entry; entry = entry->chain_next)
-    {
-        if (vertex_id == entry->vertex_id)
-        {
-            return 1;
-        }
-    }
-
-    return 0;
+    return vertex_hash_table_find(&map->table, vertex_id) !=
+           VERTEX_HASH_TABLE_NO_SLOT;
 }
 
 struct GraphVertex* graph_vertex_map_get(graph_vertex_map* map,
-                                  size_t vertex_id)
+                                  vertex_id_t vertex_id)
 {
-    size_t index;
-    graph_vertex_map_entry* p_entry;
+    size_t slot;
 
     if (!map)
     {
         return NULL;
     }
 
-    index = vertex_id & map->mask;
+    slot = vertex_hash_table_find(&map->table, vertex_id);
 
-    for (p_entry = map->table[index]; p_entry; p_entry = p_entry->chain_next)
-    {
-        if (vertex_id == p_entry->vertex_id)
-        {
-            return p_entry->vertex;
-        }
-    }
-
-    return NULL;
+    return slot == VERTEX_HASH_TABLE_NO_SLOT ?
+           NULL :
+           ((struct GraphVertex**) map->table.values)[slot];
 }
 
 void graph_vertex_map_remove(graph_vertex_map* map,
-                             size_t vertex_id)
-{
-    size_t index;
-    graph_vertex_map_entry* prev_entry;
-    graph_vertex_map_entry* current_entry;
-
-    if (!map)
-    {
-        return;
-    }
-
-    index = vertex_id & map->mask;
-
-    prev_entry = NULL;
-
-    for (current_entry = map->table[index];
-         current_entry;
-         current_entry = current_entry->chain_next)
-    {
-        if (vertex_id == current_entry->vertex_id)
-        {
-            if (prev_entry)
-            {
-                /* Omit the 'p_current_entry' in the collision chain. */
-                prev_entry->chain_next = current_entry->chain_next;
-            }
-            else
-            {
-                map->table[index] = current_entry->chain_next;
-            }
-
-            /* Unlink from the global iteration chain. */
-            if (current_entry->prev)
-            {
-                current_entry->prev->next = current_entry->next;
-            }
-            else
-            {
-                map->head = current_entry->next;
-            }
-
-            if (current_entry->next)
-            {
-                current_entry->next->prev = current_entry->prev;
-            }
-            else
-            {
-                map->tail = current_entry->prev;
-            }
-
-            map->size--;
-            free(current_entry);
-            return;
-        }
-
-        prev_entry = current_entry;
-    }
-}
-
-static void graph_vertex_map_clear(graph_vertex_map* map)
+                             vertex_id_t vertex_id)
 {
-    graph_vertex_map_entry* entry;
-    graph_vertex_map_entry* next_entry;
-    size_t index;
-
     if (!map)
     {
         return;
     }
 
-    entry = map->head;
-
-    while (entry)
-    {
-        index = entry->vertex_id & map->mask;
-        next_entry = entry->next;
-        free(entry);
-        entry = next_entry;
-        map->table[index] = NULL;
-    }
-
-    map->size = 0;
-    map->head = NULL;
-    map->tail = NULL;
+    vertex_hash_table_remove(&map->table, vertex_id);
 }
 
 void graph_vertex_map_free(graph_vertex_map* map)
@@ -329,9 +112,8 @@ void graph_vertex_map_free(graph_vertex_map* map)
         return;
     }
 
-    graph_vertex_map_clear(map);
-    free(map->table);
-    free(map);
+    vertex_hash_table_destroy(&map->table);
+    graph_arena_free(map->table.p_arena, map, sizeof(*map));
 }
 
 graph_vertex_map_iterator*
@@ -344,7 +126,7 @@ graph_vertex_map_iterator_alloc(graph_vertex_map* map)
         return NULL;
     }
 
-    p_ret = malloc(sizeof(*p_ret));
+    p_ret = allocator_malloc(sizeof(*p_ret));
 
     if (!p_ret)
     {
@@ -352,8 +134,7 @@ graph_vertex_map_iterator_alloc(graph_vertex_map* map)
     }
 
     p_ret->map = map;
-    p_ret->iterated_count = 0;
-    p_ret->next_entry = map->head;
+    p_ret->slot = vertex_hash_table_next_slot(&map->table, 0);
     return p_ret;
 }
 
@@ -365,19 +146,20 @@ int graph_vertex_map_iterator_has_next(
         return 0;
     }
 
-    return iterator->map->size - iterator->iterated_count;
+    return iterator->slot < iterator->map->table.capacity;
 }
 
 void graph_vertex_map_iterator_next(
         graph_vertex_map_iterator* iterator,
-        size_t* vertex_id_pointer,
+        vertex_id_t* vertex_id_pointer,
         GraphVertex** vertex_pointer)
 {
-    *vertex_id_pointer = iterator->next_entry->vertex_id;
-    *vertex_pointer = iterator->next_entry->vertex;
+    vertex_hash_table* p_table = &iterator->map->table;
+
+    *vertex_id_pointer = p_table->keys[iterator->slot];
+    *vertex_pointer = ((GraphVertex**) p_table->values)[iterator->slot];
 
-    iterator->iterated_count++;
-    iterator->next_entry = iterator->next_entry->next;
+    iterator->slot = vertex_hash_table_next_slot(p_table, iterator->slot + 1);
 }
 
 void graph_vertex_map_iterator_free(graph_vertex_map_iterator* iterator)
@@ -388,6 +170,5 @@ void graph_vertex_map_iterator_free(graph_vertex_map_iterator* iterator)
     }
 
     iterator->map = NULL;
-    iterator->next_entry = NULL;
-    free(iterator);
+    allocator_free(iterator);
 }
\ No newline at end of file
@@ -2,47 +2,46 @@
 #define	COM_GITHUB_CODERODDE_BIDIR_SEARCH_GRAPH_VERTEX_MAP_H
 
 #include "graph.h"
+#include "graph_arena.h"
+#include "types.h"
+#include "vertex_hash_table.h"
 #include <stdlib.h>
 
-typedef struct graph_vertex_map_entry {
-    size_t                         vertex_id;
-    struct GraphVertex*            vertex;
-    struct graph_vertex_map_entry* chain_next;
-    struct graph_vertex_map_entry* prev;
-    struct graph_vertex_map_entry* next;
-} graph_vertex_map_entry;
+struct GraphVertex;
 
+/* Maps vertex IDs to vertices; 'table.values' holds 'GraphVertex*'s: */
 typedef struct graph_vertex_map {
-    graph_vertex_map_entry** table;
-    graph_vertex_map_entry* head;
-    graph_vertex_map_entry* tail;
-    size_t                   table_capacity;
-    size_t                   size;
-    size_t                   max_allowed_size;
-    size_t                   mask;
-    float                    load_factor;
+    vertex_hash_table table;
 } graph_vertex_map;
 
 typedef struct graph_vertex_map_iterator {
-    graph_vertex_map*       map;
-    graph_vertex_map_entry* next_entry;
-    size_t                  iterated_count;
+    graph_vertex_map* map;
+    size_t            slot;
 } graph_vertex_map_iterator;
 
 graph_vertex_map* graph_vertex_map_alloc(
         size_t initial_capacity,
         float load_factor);
 
+/* Allocates a map whose storage, including the map itself, is in 'p_arena': */
+graph_vertex_map* graph_vertex_map_alloc_in_arena(
+        graph_arena* p_arena,
+        size_t initial_capacity,
+        float load_factor);
+
 int graph_vertex_map_put(graph_vertex_map* map,
-                         size_t vertex_id,
+                         vertex_id_t vertex_id,
                          struct GraphVertex* vertex);
 
-int graph_vertex_map_contains_key(graph_vertex_map* map, size_t vertex_id);
+int graph_vertex_map_reserve(graph_vertex_map* map, size_t size);
+
+int graph_vertex_map_contains_key(graph_vertex_map* map,
+                                  vertex_id_t vertex_id);
 
 struct GraphVertex* graph_vertex_map_get(graph_vertex_map * map,
-                                         size_t vertex_id);
+                                         vertex_id_t vertex_id);
 
-void graph_vertex_map_remove(graph_vertex_map* map, size_t vertex_id);
+void graph_vertex_map_remove(graph_vertex_map* map, vertex_id_t vertex_id);
 
 void graph_vertex_map_free(graph_vertex_map* map);
 
@@ -53,7 +52,7 @@ int graph_vertex_map_iterator_has_next
         (graph_vertex_map_iterator* iterator);
 
 void graph_vertex_map_iterator_next(graph_vertex_map_iterator* iterator,
-                                    size_t* p_vertex_id,
+                                    vertex_id_t* p_vertex_id,
                                     struct GraphVertex** p_graph_vertex);
 
 void graph_vertex_map_iterator_free(
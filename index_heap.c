@@ -0,0 +1,412 @@
+#include "index_heap.h"
+#include "allocator.h"
+#include "util.h"
+
+/* The SIMD kernels need GCC-style target attributes and CPU detection: */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define INDEX_HEAP_X86_SIMD
+#include <immintrin.h>
+#endif
+
+#define MIN_CHILD_SCALAR 0
+#define MIN_CHILD_SSE2   1
+#define MIN_CHILD_AVX2   2
+
+static const size_t MINIMUM_INITIAL_CAPACITY = 4;
+
+static size_t fix_degree(size_t degree) {
+    return degree < 2 ? 2 : degree;
+}
+
+static size_t fix_initial_capacity(size_t initial_capacity) {
+    return initial_capacity < MINIMUM_INITIAL_CAPACITY ?
+           MINIMUM_INITIAL_CAPACITY :
+           initial_capacity;
+}
+
+/* Returns the index of the first minimum among 'count' priorities: */
+static size_t min_child_scalar(const double* priorities, size_t count)
+{
+    size_t min_index = 0;
+    size_t i;
+
+    for (i = 1; i < count; ++i)
+    {
+        if (priorities[min_index] > priorities[i])
+        {
+            min_index = i;
+        }
+    }
+
+    return min_index;
+}
+
+#ifdef INDEX_HEAP_X86_SIMD
+
+/*******************************************************************************
+* Same as 'min_child_scalar' for a 'count' that is a multiple of 2: reduces    *
+* the priorities to their minimum in registers, and then finds the first       *
+* lane equal to it.                                                            *
+*******************************************************************************/
+__attribute__((target("sse2")))
+static size_t min_child_sse2(const double* priorities, size_t count)
+{
+    __m128d minimum = _mm_loadu_pd(priorities);
+    size_t i;
+    int mask;
+
+    for (i = 2; i < count; i += 2)
+    {
+        minimum = _mm_min_pd(minimum, _mm_loadu_pd(priorities + i));
+    }
+
+    minimum = _mm_min_pd(minimum, _mm_shuffle_pd(minimum, minimum, 1));
+
+    for (i = 0;; i += 2)
+    {
+        mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(priorities + i),
+                                            minimum));
+        if (mask)
+        {
+            return i + ((mask & 1) ? 0 : 1);
+        }
+    }
+}
+
+/* Same as 'min_child_sse2' for a 'count' that is a multiple of 4: */
+__attribute__((target("avx2")))
+static size_t min_child_avx2(const double* priorities, size_t count)
+{
+    __m256d minimum = _mm256_loadu_pd(priorities);
+    size_t i;
+    int mask;
+
+    for (i = 4; i < count; i += 4)
+    {
+        minimum = _mm256_min_pd(minimum, _mm256_loadu_pd(priorities + i));
+    }
+
+    minimum = _mm256_min_pd(minimum,
+                            _mm256_permute2f128_pd(minimum, minimum, 1));
+    minimum = _mm256_min_pd(minimum, _mm256_permute_pd(minimum, 5));
+
+    for (i = 0;; i += 4)
+    {
+        mask = _mm256_movemask_pd(
+                _mm256_cmp_pd(_mm256_loadu_pd(priorities + i),
+                              minimum,
+                              _CMP_EQ_OQ));
+        if (mask)
+        {
+            return i + (size_t) __builtin_ctz((unsigned int) mask);
+        }
+    }
+}
+
+#endif
+
+/* Chooses the fastest kernel the CPU supports for full child groups: */
+static int select_min_child_kernel(size_t degree)
+{
+#ifdef INDEX_HEAP_X86_SIMD
+    __builtin_cpu_init();
+
+    if (degree % 4 == 0 && __builtin_cpu_supports("avx2"))
+    {
+        return MIN_CHILD_AVX2;
+    }
+
+    if (degree % 2 == 0 && __builtin_cpu_supports("sse2"))
+    {
+        return MIN_CHILD_SSE2;
+    }
+#else
+    (void) degree;
+#endif
+    return MIN_CHILD_SCALAR;
+}
+
+/*******************************************************************************
+* Returns the index of the minimum child among the 'count' children starting   *
+* at 'first_child_index'. Only full groups of 'degree' children go through the *
+* SIMD kernels; the last, partial group of the heap is scanned by scalar code. *
+*******************************************************************************/
+static size_t get_min_child_index(index_heap* my_heap,
+                                  size_t first_child_index,
+                                  size_t count)
+{
+    const double* priorities = my_heap->priorities + first_child_index;
+
+    if (count == my_heap->degree)
+    {
+        switch (my_heap->min_child_kernel)
+        {
+#ifdef INDEX_HEAP_X86_SIMD
+            case MIN_CHILD_AVX2:
+                return first_child_index + min_child_avx2(priorities, count);
+
+            case MIN_CHILD_SSE2:
+                return first_child_index + min_child_sse2(priorities, count);
+#endif
+            default:
+                break;
+        }
+    }
+
+    return first_child_index + min_child_scalar(priorities, count);
+}
+
+static vertex_id_t* get_position(index_heap* my_heap,
+                                 vertex_id_t vertex_index)
+{
+    return (vertex_id_t*)(my_heap->p_positions +
+                          vertex_index * my_heap->position_stride);
+}
+
+/* Puts the entry at 'index' and records its new position: */
+static void place_entry(index_heap* my_heap,
+                        size_t index,
+                        vertex_id_t vertex_index,
+                        double priority)
+{
+    my_heap->priorities[index] = priority;
+    my_heap->vertex_indices[index] = vertex_index;
+
+    if (my_heap->p_positions)
+    {
+        *get_position(my_heap, vertex_index) = index;
+    }
+}
+
+index_heap* index_heap_alloc(size_t degree, size_t initial_capacity)
+{
+    index_heap* my_heap = allocator_malloc(sizeof(*my_heap));
+
+    if (!my_heap)
+    {
+        return NULL;
+    }
+
+    initial_capacity = fix_initial_capacity(initial_capacity);
+    my_heap->priorities = allocator_malloc(sizeof(double) * initial_capacity);
+    my_heap->vertex_indices =
+            allocator_malloc(sizeof(vertex_id_t) * initial_capacity);
+
+    if (!my_heap->priorities || !my_heap->vertex_indices)
+    {
+        allocator_free(my_heap->priorities);
+        allocator_free(my_heap->vertex_indices);
+        allocator_free(my_heap);
+        return NULL;
+    }
+
+    my_heap->size = 0;
+    my_heap->capacity = initial_capacity;
+    my_heap->p_positions = NULL;
+    my_heap->position_stride = 0;
+    index_heap_set_degree(my_heap, degree);
+    return my_heap;
+}
+
+void index_heap_set_degree(index_heap* my_heap, size_t degree)
+{
+    if (my_heap->size > 0)
+    {
+        abort();
+    }
+
+    my_heap->degree = fix_degree(degree);
+    my_heap->min_child_kernel = select_min_child_kernel(my_heap->degree);
+}
+
+void index_heap_set_positions(index_heap* my_heap,
+                              void* p_positions,
+                              size_t position_stride)
+{
+    my_heap->p_positions = p_positions;
+    my_heap->position_stride = position_stride;
+}
+
+static void sift_up(index_heap* my_heap, size_t index)
+{
+    double target_priority = my_heap->priorities[index];
+    vertex_id_t target_vertex_index = my_heap->vertex_indices[index];
+    size_t parent_index;
+
+    while (index > 0)
+    {
+        parent_index = (index - 1) / my_heap->degree;
+
+        if (my_heap->priorities[parent_index] <= target_priority)
+        {
+            break;
+        }
+
+        place_entry(my_heap,
+                    index,
+                    my_heap->vertex_indices[parent_index],
+                    my_heap->priorities[parent_index]);
+
+        index = parent_index;
+    }
+
+    place_entry(my_heap, index, target_vertex_index, target_priority);
+}
+
+static void sift_down_root(index_heap* my_heap)
+{
+    double target_priority = my_heap->priorities[0];
+    vertex_id_t target_vertex_index = my_heap->vertex_indices[0];
+    size_t degree = my_heap->degree;
+    size_t size = my_heap->size;
+    size_t index = 0;
+    size_t first_child_index;
+    size_t child_count;
+    size_t min_child_index;
+
+    for (;;)
+    {
+        first_child_index = degree * index + 1;
+
+        if (first_child_index >= size)
+        {
+            break;
+        }
+
+        child_count = size - first_child_index;
+
+        if (child_count > degree)
+        {
+            child_count = degree;
+        }
+
+        min_child_index = get_min_child_index(my_heap,
+                                              first_child_index,
+                                              child_count);
+
+        if (my_heap->priorities[min_child_index] >= target_priority)
+        {
+            break;
+        }
+
+        place_entry(my_heap,
+                    index,
+                    my_heap->vertex_indices[min_child_index],
+                    my_heap->priorities[min_child_index]);
+
+        index = min_child_index;
+    }
+
+    place_entry(my_heap, index, target_vertex_index, target_priority);
+}
+
+static int ensure_capacity_before_add(index_heap* my_heap)
+{
+    double* new_priorities;
+    vertex_id_t* new_vertex_indices;
+    size_t new_capacity;
+
+    if (my_heap->size < my_heap->capacity)
+    {
+        return TRUE;
+    }
+
+    new_capacity = 3 * my_heap->capacity / 2;
+    new_priorities = allocator_realloc(my_heap->priorities,
+                                       sizeof(double) * new_capacity);
+
+    if (!new_priorities)
+    {
+        return FALSE;
+    }
+
+    my_heap->priorities = new_priorities;
+    new_vertex_indices = allocator_realloc(my_heap->vertex_indices,
+                                           sizeof(vertex_id_t) * new_capacity);
+
+    if (!new_vertex_indices)
+    {
+        return FALSE;
+    }
+
+    my_heap->vertex_indices = new_vertex_indices;
+    my_heap->capacity = new_capacity;
+    return TRUE;
+}
+
+int index_heap_add(index_heap* my_heap,
+                   vertex_id_t vertex_index,
+                   double priority)
+{
+    if (!ensure_capacity_before_add(my_heap))
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    my_heap->priorities[my_heap->size] = priority;
+    my_heap->vertex_indices[my_heap->size] = vertex_index;
+    sift_up(my_heap, my_heap->size);
+    my_heap->size++;
+    return RETURN_STATUS_OK;
+}
+
+void index_heap_decrease_key(index_heap* my_heap,
+                             vertex_id_t vertex_index,
+                             double priority)
+{
+    size_t index = *get_position(my_heap, vertex_index);
+
+    if (priority < my_heap->priorities[index])
+    {
+        my_heap->priorities[index] = priority;
+        sift_up(my_heap, index);
+    }
+}
+
+vertex_id_t index_heap_extract_min(index_heap* my_heap)
+{
+    vertex_id_t vertex_index = my_heap->vertex_indices[0];
+
+    my_heap->size--;
+
+    if (my_heap->size > 0)
+    {
+        my_heap->priorities[0] = my_heap->priorities[my_heap->size];
+        my_heap->vertex_indices[0] = my_heap->vertex_indices[my_heap->size];
+        sift_down_root(my_heap);
+    }
+
+    return vertex_index;
+}
+
+vertex_id_t index_heap_min(index_heap* my_heap)
+{
+    return my_heap->vertex_indices[0];
+}
+
+double index_heap_min_priority(index_heap* my_heap)
+{
+    return my_heap->priorities[0];
+}
+
+size_t index_heap_size(index_heap* my_heap)
+{
+    return my_heap->size;
+}
+
+void index_heap_clear(index_heap* my_heap)
+{
+    my_heap->size = 0;
+}
+
+void index_heap_free(index_heap* my_heap)
+{
+    if (!my_heap)
+    {
+        return;
+    }
+
+    allocator_free(my_heap->priorities);
+    allocator_free(my_heap->vertex_indices);
+    allocator_free(my_heap);
+}
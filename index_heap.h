@@ -0,0 +1,64 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_INDEX_HEAP_H
+#define	COM_GITHUB_CODERODDE_BIDIR_SEARCH_INDEX_HEAP_H
+
+#include "types.h"
+#include <stdlib.h>
+
+/*******************************************************************************
+* An array-backed d-ary heap over dense vertex indices. The entries are stored *
+* as a structure of arrays: the priorities are contiguous in 'priorities' and  *
+* the vertices in 'vertex_indices', so that the children of a node can be      *
+* compared with SIMD instructions. No heap operation allocates memory unless   *
+* the arrays have to grow. The heap does not own the positions of the          *
+* vertices: it writes the position of vertex 'v' to the vertex_id_t at         *
+* 'p_positions + v * position_stride', which lets a caller keep the positions  *
+* inside its own per-vertex records. The caller is responsible for knowing     *
+* whether a vertex is in the heap; adding a vertex twice is not detected.      *
+* Without a position store (the default), the heap does not track positions    *
+* at all and 'index_heap_decrease_key' must not be called; a vertex may then   *
+* be added any number of times, which suits lazy deletion.                     *
+*******************************************************************************/
+typedef struct index_heap {
+    double*      priorities;
+    vertex_id_t* vertex_indices;
+    size_t       size;
+    size_t       capacity;
+    size_t       degree;
+    int          min_child_kernel;
+    char*        p_positions;
+    size_t       position_stride;
+} index_heap;
+
+index_heap* index_heap_alloc(size_t degree, size_t initial_capacity);
+
+/*******************************************************************************
+* Changes the degree of an empty heap. The minimum child of a node is picked   *
+* with AVX2 if the CPU supports it and the degree is a multiple of 4, or with  *
+* SSE2 if the degree is even; otherwise with scalar code.                      *
+*******************************************************************************/
+void index_heap_set_degree(index_heap* heap, size_t degree);
+
+/*******************************************************************************
+* Tells the heap where to store the positions. Must be called again whenever   *
+* the position storage moves. Passing NULL stops position tracking.            *
+*******************************************************************************/
+void index_heap_set_positions(index_heap* heap,
+                              void* p_positions,
+                              size_t position_stride);
+
+int index_heap_add(index_heap* heap,
+                   vertex_id_t vertex_index,
+                   double priority);
+
+void index_heap_decrease_key(index_heap* heap,
+                             vertex_id_t vertex_index,
+                             double priority);
+
+vertex_id_t index_heap_extract_min  (index_heap* heap);
+vertex_id_t index_heap_min          (index_heap* heap);
+double      index_heap_min_priority (index_heap* heap);
+size_t      index_heap_size         (index_heap* heap);
+void        index_heap_clear        (index_heap* heap);
+void        index_heap_free         (index_heap* heap);
+
+#endif	/* COM_GITHUB_CODERODDE_BIDIR_SEARCH_INDEX_HEAP_H */
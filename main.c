@@ -1,7 +1,28 @@
+/* clock_gettime is POSIX, not ANSI C; request it before any system header: */
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200112L
+#define DEMO_WALL_CLOCK
+#endif
+
 #include "algorithm.h"
+#include "allocator.h"
+#include "compressed_graph.h"
+#include "distance_bound.h"
+#include "edge_list.h"
+#include "frozen_graph.h"
+#include "frozen_graph_builder.h"
+#include "frozen_graph_landmarks.h"
+#include "frozen_graph_order.h"
+#include "frozen_graph_snapshot.h"
 #include "graph.h"
+#include "graph_arena.h"
+#include "graph_import.h"
+#include "search_context.h"
+#include "util.h"
+#include "vertex_hash_table.h"
 #include "vertex_list.h"
-#include "vertex_set.h"
+#include "worker_pool.h"
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -11,8 +32,24 @@ static clock_t milliseconds()
     return clock() / (CLOCKS_PER_SEC / 1000);
 }
 
+/* Measures elapsed time, unlike clock(), which adds up all threads: */
+static long wall_milliseconds()
+{
+#ifdef DEMO_WALL_CLOCK
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long) now.tv_sec * 1000 + now.tv_nsec / 1000000;
+#else
+    return (long) milliseconds();
+#endif
+}
+
 static const size_t NODES = 100 * 1000;
 static const size_t EDGES = 500 * 1000;
+static const size_t QUERIES = 1000;
+
+/* Unidirectional queries usually explore most of the graph, so run fewer: */
+static const size_t UNIDIRECTIONAL_QUERIES = 100;
 
 static int paths_are_equal(vertex_list* path_1,
                            vertex_list* path_2) {
@@ -63,7 +100,1196 @@ double get_path_length(vertex_list* path,
     return length;
 }
 
-Graph* buildGraph() {
+/* Passes the calls on to the standard library, counting the allocations: */
+static void* counting_malloc(void* p_context, size_t size) {
+    ++*(size_t*) p_context;
+    return malloc(size);
+}
+
+static void* counting_realloc(void* p_context, void* p_block, size_t size) {
+    ++*(size_t*) p_context;
+    return realloc(p_block, size);
+}
+
+static void counting_free(void* p_context, void* p_block) {
+    (void) p_context;
+    free(p_block);
+}
+
+/* Runs the same random queries with and without a shared search context: */
+static void benchmark_search_context(Graph* p_graph) {
+    size_t i;
+    size_t* source_vertex_ids = malloc(sizeof(size_t) * QUERIES);
+    size_t* target_vertex_ids = malloc(sizeof(size_t) * QUERIES);
+    clock_t milliseconds_a;
+    clock_t milliseconds_b;
+    vertex_list* path;
+    search_context* p_search_context = search_context_alloc();
+    size_t allocation_count = 0;
+    allocator counting_allocator;
+    int rs;
+
+    for (i = 0; i < QUERIES; ++i) {
+        source_vertex_ids[i] = intrand() % NODES;
+        target_vertex_ids[i] = intrand() % NODES;
+    }
+
+    /* The hooks wrap the standard heap, so blocks may cross the switch: */
+    counting_allocator.malloc_function = counting_malloc;
+    counting_allocator.realloc_function = counting_realloc;
+    counting_allocator.free_function = counting_free;
+    counting_allocator.p_context = &allocation_count;
+    allocator_set(&counting_allocator);
+
+    milliseconds_a = milliseconds();
+
+    for (i = 0; i < QUERIES; ++i) {
+        path = find_shortest_path(p_graph,
+                                  source_vertex_ids[i],
+                                  target_vertex_ids[i],
+                                  &rs);
+
+        if (path) {
+            vertex_list_free(path);
+        }
+    }
+
+    milliseconds_b = milliseconds();
+    printf("%d queries without a search context: %ld milliseconds, "
+           "%lu allocations.\n",
+           (int) QUERIES,
+           (milliseconds_b - milliseconds_a),
+           (unsigned long) allocation_count);
+
+    allocation_count = 0;
+    milliseconds_a = milliseconds();
+
+    for (i = 0; i < QUERIES; ++i) {
+        path = find_shortest_path_with_context(p_search_context,
+                                               p_graph,
+                                               source_vertex_ids[i],
+                                               target_vertex_ids[i],
+                                               &rs);
+
+        if (path) {
+            vertex_list_free(path);
+        }
+    }
+
+    milliseconds_b = milliseconds();
+    allocator_set(NULL);
+    printf("%d queries with a shared search context: %ld milliseconds, "
+           "%lu allocations.\n",
+           (int) QUERIES,
+           (milliseconds_b - milliseconds_a),
+           (unsigned long) allocation_count);
+
+    search_context_free(p_search_context);
+    free(source_vertex_ids);
+    free(target_vertex_ids);
+}
+
+/* Runs the first 'query_count' queries in 'p_search_context' and returns the
+sum of the path lengths: */
+static double run_queries(search_context* p_search_context,
+                          Graph* p_graph,
+                          size_t* source_vertex_ids,
+                          size_t* target_vertex_ids,
+                          size_t query_count,
+                          int bidirectional,
+                          clock_t* p_duration) {
+    size_t i;
+    clock_t milliseconds_a;
+    double total_length = 0.0;
+    vertex_list* path;
+    int rs;
+
+    milliseconds_a = milliseconds();
+
+    for (i = 0; i < query_count; ++i) {
+        if (bidirectional) {
+            path = find_shortest_path_with_context(p_search_context,
+                                                   p_graph,
+                                                   source_vertex_ids[i],
+                                                   target_vertex_ids[i],
+                                                   &rs);
+        } else {
+            path = find_shortest_path_2_with_context(p_search_context,
+                                                     p_graph,
+                                                     source_vertex_ids[i],
+                                                     target_vertex_ids[i],
+                                                     &rs);
+        }
+
+        if (path) {
+            total_length += get_path_length(path, p_graph);
+            vertex_list_free(path);
+        }
+    }
+
+    *p_duration = milliseconds() - milliseconds_a;
+    return total_length;
+}
+
+/* Compares the priority queues, with and without lazy deletion, on a sparse
+graph with integer weights: */
+static void benchmark_queues() {
+    static const char* queue_names[] = { "d-ary heap",
+                                         "d-ary heap, lazy deletion",
+                                         "radix heap",
+                                         "radix heap, lazy deletion" };
+    static const int queue_kinds[] = { SEARCH_QUEUE_DARY_HEAP,
+                                       SEARCH_QUEUE_DARY_HEAP,
+                                       SEARCH_QUEUE_RADIX_HEAP,
+                                       SEARCH_QUEUE_RADIX_HEAP };
+    static const int lazy_deletion[] = { FALSE, TRUE, FALSE, TRUE };
+    static const size_t heap_degrees[] = { 2, 4, 8, 16 };
+    size_t i;
+    size_t* source_vertex_ids = malloc(sizeof(size_t) * QUERIES);
+    size_t* target_vertex_ids = malloc(sizeof(size_t) * QUERIES);
+    double total_length;
+    clock_t duration;
+    Graph* p_graph = allocGraph();
+    search_context* p_search_context = search_context_alloc();
+
+    for (i = 0; i < EDGES; ++i) {
+        addEdge(p_graph,
+                intrand() % NODES,
+                intrand() % NODES,
+                (double)(1 + intrand() % 3600));
+    }
+
+    for (i = 0; i < QUERIES; ++i) {
+        source_vertex_ids[i] = intrand() % NODES;
+        target_vertex_ids[i] = intrand() % NODES;
+    }
+
+    puts("--- Priority queues on integer weights:");
+
+    for (i = 0; i < sizeof(queue_kinds) / sizeof(queue_kinds[0]); ++i) {
+        search_context_set_queue(p_search_context, queue_kinds[i]);
+        search_context_set_lazy_deletion(p_search_context, lazy_deletion[i]);
+
+        total_length = run_queries(p_search_context,
+                                   p_graph,
+                                   source_vertex_ids,
+                                   target_vertex_ids,
+                                   QUERIES,
+                                   TRUE,
+                                   &duration);
+
+        printf("%s, %d bidirectional queries: %ld milliseconds, "
+               "total length %.0f.\n",
+               queue_names[i],
+               (int) QUERIES,
+               duration,
+               total_length);
+
+        total_length = run_queries(p_search_context,
+                                   p_graph,
+                                   source_vertex_ids,
+                                   target_vertex_ids,
+                                   UNIDIRECTIONAL_QUERIES,
+                                   FALSE,
+                                   &duration);
+
+        printf("%s, %d unidirectional queries: %ld milliseconds, "
+               "total length %.0f.\n",
+               queue_names[i],
+               (int) UNIDIRECTIONAL_QUERIES,
+               duration,
+               total_length);
+    }
+
+    puts("--- d-ary heap degrees:");
+    search_context_set_queue(p_search_context, SEARCH_QUEUE_DARY_HEAP);
+    search_context_set_lazy_deletion(p_search_context, FALSE);
+
+    for (i = 0; i < sizeof(heap_degrees) / sizeof(heap_degrees[0]); ++i) {
+        search_context_set_heap_degree(p_search_context, heap_degrees[i]);
+
+        total_length = run_queries(p_search_context,
+                                   p_graph,
+                                   source_vertex_ids,
+                                   target_vertex_ids,
+                                   UNIDIRECTIONAL_QUERIES,
+                                   FALSE,
+                                   &duration);
+
+        printf("Degree %d, %d unidirectional queries: %ld milliseconds, "
+               "total length %.0f.\n",
+               (int) heap_degrees[i],
+               (int) UNIDIRECTIONAL_QUERIES,
+               duration,
+               total_length);
+    }
+
+    search_context_free(p_search_context);
+    freeGraph(p_graph);
+    free(p_graph);
+    free(source_vertex_ids);
+    free(target_vertex_ids);
+}
+
+/* Compares the hash functions of the vertex map on IDs with and without
+common low bits: */
+static void benchmark_hashes() {
+    static const char* hash_names[] = { "multiply-shift", "fmix64" };
+    static const int hash_functions[] = { VERTEX_HASH_MULTIPLY_SHIFT,
+                                          VERTEX_HASH_FMIX64 };
+    static const size_t id_strides[] = { 1, 4096, 40960 };
+    static const size_t lookup_rounds = 10;
+    size_t i;
+    size_t j;
+    size_t k;
+    size_t found;
+    clock_t milliseconds_a;
+    clock_t milliseconds_b;
+    vertex_hash_table_stats stats;
+    Graph graph;
+
+    puts("--- Vertex map hash functions:");
+
+    for (i = 0; i < sizeof(hash_functions) / sizeof(hash_functions[0]); ++i) {
+        vertex_hash_table_set_default_hash(hash_functions[i]);
+
+        for (j = 0; j < sizeof(id_strides) / sizeof(id_strides[0]); ++j) {
+            initGraph(&graph);
+
+            for (k = 0; k < NODES; ++k) {
+                addVertex(&graph, k * id_strides[j]);
+            }
+
+            found = 0;
+            milliseconds_a = milliseconds();
+
+            for (k = 0; k < lookup_rounds * NODES; ++k) {
+                found += hasVertex(&graph, (k % NODES) * id_strides[j]);
+            }
+
+            milliseconds_b = milliseconds();
+            getVertexMapStats(&graph, &stats);
+
+            printf("%s, ID stride %d: %d lookups in %ld milliseconds, "
+                   "probe length mean %.3f, max %d.\n",
+                   hash_names[i],
+                   (int) id_strides[j],
+                   (int) found,
+                   (milliseconds_b - milliseconds_a),
+                   stats.mean_probe_length,
+                   (int) stats.max_probe_length);
+
+            freeGraph(&graph);
+        }
+    }
+
+    vertex_hash_table_set_default_hash(VERTEX_HASH_MULTIPLY_SHIFT);
+}
+
+/* The side of the grid of the goal-directed search benchmark: */
+static const size_t GRID_SIDE = 400;
+
+/* The number of landmarks of the ALT queries of the same benchmark: */
+static const size_t LANDMARK_COUNT = 16;
+
+/* The side of the grid of the vertex order benchmark, its number of queries
+and the number of times they are timed: */
+static const size_t ORDER_GRID_SIDE = 1000;
+static const size_t ORDER_QUERIES = 10;
+static const size_t ORDER_REPEATS = 3;
+
+/* Runs the queries on 'p_frozen_graph' with the bound 'p_bound', which may be
+NULL, and returns the sum of the path lengths. Stores the mean number of
+vertices settled per query in '*p_settled_count': */
+static double run_goal_directed_queries(search_context* p_search_context,
+                                        frozen_graph* p_frozen_graph,
+                                        Graph* p_graph,
+                                        const distance_bound* p_bound,
+                                        size_t* source_vertex_ids,
+                                        size_t* target_vertex_ids,
+                                        double* p_settled_count,
+                                        clock_t* p_duration) {
+    size_t i;
+    size_t settled_count = 0;
+    clock_t milliseconds_a;
+    double total_length = 0.0;
+    vertex_list* path;
+    int rs;
+
+    milliseconds_a = milliseconds();
+
+    for (i = 0; i < UNIDIRECTIONAL_QUERIES; ++i) {
+        path = find_shortest_path_astar_frozen_with_context(
+                p_search_context,
+                p_frozen_graph,
+                p_bound,
+                source_vertex_ids[i],
+                target_vertex_ids[i],
+                &rs);
+
+        settled_count += p_search_context->forward.settled_count +
+                         p_search_context->backward.settled_count;
+
+        if (path) {
+            total_length += get_path_length(path, p_graph);
+            vertex_list_free(path);
+        }
+    }
+
+    *p_duration = milliseconds() - milliseconds_a;
+    *p_settled_count = (double) settled_count / UNIDIRECTIONAL_QUERIES;
+    return total_length;
+}
+
+/* Runs the queries on 'p_compressed_graph' with the bound 'p_bound', or with
+plain bidirectional Dijkstra if it is NULL, and returns the sum of the path
+lengths. Stores the mean number of vertices settled per query in
+'*p_settled_count': */
+static double run_compressed_goal_directed_queries(
+        search_context* p_search_context,
+        compressed_graph* p_compressed_graph,
+        Graph* p_graph,
+        const distance_bound* p_bound,
+        size_t* source_vertex_ids,
+        size_t* target_vertex_ids,
+        double* p_settled_count) {
+    size_t i;
+    size_t settled_count = 0;
+    double total_length = 0.0;
+    vertex_list* path;
+    int rs;
+
+    for (i = 0; i < UNIDIRECTIONAL_QUERIES; ++i) {
+        if (p_bound) {
+            path = find_shortest_path_astar_compressed_with_context(
+                    p_search_context,
+                    p_compressed_graph,
+                    p_bound,
+                    source_vertex_ids[i],
+                    target_vertex_ids[i],
+                    &rs);
+        } else {
+            path = find_shortest_path_compressed_with_context(
+                    p_search_context,
+                    p_compressed_graph,
+                    source_vertex_ids[i],
+                    target_vertex_ids[i],
+                    &rs);
+        }
+
+        settled_count += p_search_context->forward.settled_count +
+                         p_search_context->backward.settled_count;
+
+        if (path) {
+            total_length += get_path_length(path, p_graph);
+            vertex_list_free(path);
+        }
+    }
+
+    *p_settled_count = (double) settled_count / UNIDIRECTIONAL_QUERIES;
+    return total_length;
+}
+
+/* Runs the queries of the goal-direction benchmark on 'p_frozen_graph'
+compressed with weights quantized to 1/256, with the bounds made for the
+exact weights, and checks the lengths against bidirectional Dijkstra: */
+static void benchmark_quantized_goal_direction(
+        search_context* p_search_context,
+        frozen_graph* p_frozen_graph,
+        Graph* p_graph,
+        const coordinate_bound* p_euclidean_bound,
+        size_t* source_vertex_ids,
+        size_t* target_vertex_ids) {
+    static const char* bound_names[] = { "Euclidean", "landmark" };
+    const distance_bound* bounds[2];
+    compressed_graph* p_compressed_graph;
+    landmark_bound bound;
+    double dijkstra_length;
+    double length;
+    double settled_count;
+    size_t i;
+    int rs;
+
+    p_compressed_graph = frozen_graph_compress(p_frozen_graph,
+                                               1.0 / 256,
+                                               &rs);
+
+    if (!p_compressed_graph) {
+        printf("Compression failed with status %d.\n", rs);
+        return;
+    }
+
+    landmark_bound_init(&bound, p_frozen_graph);
+    bounds[0] = &p_euclidean_bound->bound;
+    bounds[1] = &bound.bound;
+
+    dijkstra_length = run_compressed_goal_directed_queries(p_search_context,
+                                                           p_compressed_graph,
+                                                           p_graph,
+                                                           NULL,
+                                                           source_vertex_ids,
+                                                           target_vertex_ids,
+                                                           &settled_count);
+
+    printf("Quantized compressed graph, bidirectional Dijkstra: %.0f settled "
+           "vertices per query, total length %.0f.\n",
+           settled_count,
+           dijkstra_length);
+
+    for (i = 0; i < 2; ++i) {
+        length = run_compressed_goal_directed_queries(p_search_context,
+                                                      p_compressed_graph,
+                                                      p_graph,
+                                                      bounds[i],
+                                                      source_vertex_ids,
+                                                      target_vertex_ids,
+                                                      &settled_count);
+
+        printf("Quantized compressed graph, bidirectional A*, %s bound: %.0f "
+               "settled vertices per query, total length %.0f, agrees: %d\n",
+               bound_names[i],
+               settled_count,
+               length,
+               fabs(length - dijkstra_length) <= 1e-9 * dijkstra_length);
+    }
+
+    compressed_graph_free(p_compressed_graph);
+}
+
+/* Builds a 'side' x 'side' grid of vertices moved off their grid points at
+random, with arcs both ways between the horizontal and vertical neighbors.
+The vertex at grid point 'i', counted row by row, gets the ID
+vertex_ids[i], or 'i' if 'vertex_ids' is NULL, and its position is stored
+at 2i and 2i + 1 in 'coordinates'. Each arc is longer than the distance
+between its end points: */
+static Graph* build_jittered_grid(size_t side,
+                                  const size_t* vertex_ids,
+                                  double* coordinates) {
+    size_t vertex_count = side * side;
+    Graph* p_graph = allocGraph();
+    double dx;
+    double dy;
+    size_t neighbors[2];
+    size_t i;
+    size_t j;
+    weight_t weight;
+
+    for (i = 0; i < vertex_count; ++i) {
+        coordinates[2 * i] = (double)(i % side) + randfrom(-0.3, 0.3);
+        coordinates[2 * i + 1] = (double)(i / side) + randfrom(-0.3, 0.3);
+    }
+
+    for (i = 0; i < vertex_count; ++i) {
+        neighbors[0] = i % side + 1 < side ? i + 1 : i;
+        neighbors[1] = i + side < vertex_count ? i + side : i;
+
+        for (j = 0; j < 2; ++j) {
+            if (neighbors[j] == i) {
+                continue;
+            }
+
+            dx = coordinates[2 * neighbors[j]] - coordinates[2 * i];
+            dy = coordinates[2 * neighbors[j] + 1] - coordinates[2 * i + 1];
+
+            /* Weights in hundredths, rounded up, also for integer weights: */
+            weight = (weight_t) ceil(100.0 * sqrt(dx * dx + dy * dy) *
+                                     randfrom(1.0, 1.5));
+
+            addEdge(p_graph,
+                    vertex_ids ? vertex_ids[i] : i,
+                    vertex_ids ? vertex_ids[neighbors[j]] : neighbors[j],
+                    weight);
+
+            addEdge(p_graph,
+                    vertex_ids ? vertex_ids[neighbors[j]] : neighbors[j],
+                    vertex_ids ? vertex_ids[i] : i,
+                    weight);
+        }
+    }
+
+    return p_graph;
+}
+
+/* Adds landmarks to 'p_frozen_graph' with each selection strategy and runs
+the queries of the goal-direction benchmark with the landmark bound: */
+static void benchmark_landmarks(search_context* p_search_context,
+                                frozen_graph* p_frozen_graph,
+                                Graph* p_graph,
+                                size_t* source_vertex_ids,
+                                size_t* target_vertex_ids) {
+    static const char* selection_names[] = { "farthest", "avoid" };
+    worker_pool* p_pool = worker_pool_alloc(0);
+    landmark_bound bound;
+    double length;
+    double settled_count;
+    clock_t duration;
+    long milliseconds_a;
+    long milliseconds_b;
+    int selection;
+    int rs;
+
+    landmark_bound_init(&bound, p_frozen_graph);
+
+    for (selection = LANDMARK_SELECTION_FARTHEST;
+         selection <= LANDMARK_SELECTION_AVOID;
+         ++selection) {
+        milliseconds_a = wall_milliseconds();
+        rs = frozen_graph_add_landmarks(p_frozen_graph,
+                                        LANDMARK_COUNT,
+                                        selection,
+                                        p_pool);
+        milliseconds_b = wall_milliseconds();
+
+        printf("Added %d %s landmarks with %d workers in %ld milliseconds, "
+               "status %d.\n",
+               (int) p_frozen_graph->landmark_count,
+               selection_names[selection],
+               p_pool ? (int) worker_pool_size(p_pool) : 1,
+               (milliseconds_b - milliseconds_a),
+               rs);
+
+        length = run_goal_directed_queries(p_search_context,
+                                           p_frozen_graph,
+                                           p_graph,
+                                           &bound.bound,
+                                           source_vertex_ids,
+                                           target_vertex_ids,
+                                           &settled_count,
+                                           &duration);
+
+        printf("Bidirectional ALT, %s landmarks, %d queries: %ld "
+               "milliseconds, %.0f settled vertices per query, total length "
+               "%.0f.\n",
+               selection_names[selection],
+               (int) UNIDIRECTIONAL_QUERIES,
+               duration,
+               settled_count,
+               length);
+    }
+
+    worker_pool_free(p_pool);
+}
+
+/* Compares bidirectional Dijkstra with bidirectional A* on a jittered grid,
+whose arcs are longer than the distances between their end points, so the
+Euclidean bound is consistent. Then compares both with the landmark
+bounds, and runs the bounds on the graph compressed with quantized
+weights: */
+static void benchmark_goal_direction() {
+    size_t vertex_count = GRID_SIDE * GRID_SIDE;
+    size_t* source_vertex_ids = malloc(sizeof(size_t) *
+                                       UNIDIRECTIONAL_QUERIES);
+    size_t* target_vertex_ids = malloc(sizeof(size_t) *
+                                       UNIDIRECTIONAL_QUERIES);
+    double* coordinates = malloc(sizeof(double) * 2 * vertex_count);
+    Graph* p_graph = build_jittered_grid(GRID_SIDE, NULL, coordinates);
+    frozen_graph* p_frozen_graph;
+    search_context* p_search_context = search_context_alloc();
+    coordinate_bound euclidean_bound;
+    double dijkstra_length;
+    double astar_length;
+    double dijkstra_settled_count;
+    double astar_settled_count;
+    clock_t dijkstra_duration;
+    clock_t astar_duration;
+    size_t i;
+
+    p_frozen_graph = graph_freeze(p_graph);
+
+    for (i = 0; i < vertex_count; ++i) {
+        frozen_graph_set_coordinates(p_frozen_graph,
+                                     i,
+                                     coordinates[2 * i],
+                                     coordinates[2 * i + 1]);
+    }
+
+    /* A scale slightly below 100 absorbs the rounding of float weights: */
+    coordinate_bound_init(&euclidean_bound,
+                          DISTANCE_BOUND_EUCLIDEAN,
+                          p_frozen_graph->coordinates,
+                          99.9);
+
+    for (i = 0; i < UNIDIRECTIONAL_QUERIES; ++i) {
+        source_vertex_ids[i] = intrand() % vertex_count;
+        target_vertex_ids[i] = intrand() % vertex_count;
+    }
+
+    dijkstra_length = run_goal_directed_queries(p_search_context,
+                                                p_frozen_graph,
+                                                p_graph,
+                                                NULL,
+                                                source_vertex_ids,
+                                                target_vertex_ids,
+                                                &dijkstra_settled_count,
+                                                &dijkstra_duration);
+
+    astar_length = run_goal_directed_queries(p_search_context,
+                                             p_frozen_graph,
+                                             p_graph,
+                                             &euclidean_bound.bound,
+                                             source_vertex_ids,
+                                             target_vertex_ids,
+                                             &astar_settled_count,
+                                             &astar_duration);
+
+    printf("--- Goal direction on a %d x %d grid:\n",
+           (int) GRID_SIDE,
+           (int) GRID_SIDE);
+
+    printf("Bidirectional Dijkstra, %d queries: %ld milliseconds, "
+           "%.0f settled vertices per query, total length %.0f.\n",
+           (int) UNIDIRECTIONAL_QUERIES,
+           dijkstra_duration,
+           dijkstra_settled_count,
+           dijkstra_length);
+
+    printf("Bidirectional A*, Euclidean bound, %d queries: %ld "
+           "milliseconds, %.0f settled vertices per query, total length "
+           "%.0f.\n",
+           (int) UNIDIRECTIONAL_QUERIES,
+           astar_duration,
+           astar_settled_count,
+           astar_length);
+
+    benchmark_landmarks(p_search_context,
+                        p_frozen_graph,
+                        p_graph,
+                        source_vertex_ids,
+                        target_vertex_ids);
+
+    benchmark_quantized_goal_direction(p_search_context,
+                                       p_frozen_graph,
+                                       p_graph,
+                                       &euclidean_bound,
+                                       source_vertex_ids,
+                                       target_vertex_ids);
+
+    search_context_free(p_search_context);
+    frozen_graph_free(p_frozen_graph);
+    freeGraph(p_graph);
+    free(p_graph);
+    free(coordinates);
+    free(source_vertex_ids);
+    free(target_vertex_ids);
+}
+
+/* Saves 'p_frozen_graph', loads it back and queries the loaded copy: */
+static void benchmark_snapshot(frozen_graph* p_frozen_graph,
+                               size_t source_vertex_id,
+                               size_t target_vertex_id,
+                               vertex_list* p_expected_path) {
+    static const char* file_name = "bidir_search_demo.snapshot";
+    frozen_graph* p_loaded_graph;
+    vertex_list* p_path;
+    clock_t milliseconds_a;
+    clock_t milliseconds_b;
+    int rs;
+
+    milliseconds_a = milliseconds();
+    rs = frozen_graph_save(p_frozen_graph, file_name);
+    milliseconds_b = milliseconds();
+
+    printf("Saved the snapshot in %ld milliseconds, status %d.\n",
+           (milliseconds_b - milliseconds_a),
+           rs);
+
+    milliseconds_a = milliseconds();
+    p_loaded_graph = frozen_graph_load(file_name, &rs);
+    milliseconds_b = milliseconds();
+
+    printf("Loaded the snapshot in %ld milliseconds, status %d.\n",
+           (milliseconds_b - milliseconds_a),
+           rs);
+
+    if (p_loaded_graph) {
+        p_path = find_shortest_path_frozen(p_loaded_graph,
+                                           source_vertex_id,
+                                           target_vertex_id,
+                                           &rs);
+
+        if (p_path) {
+            printf("Snapshot path agrees: %d\n",
+                   paths_are_equal(p_expected_path, p_path));
+
+            vertex_list_free(p_path);
+        }
+
+        frozen_graph_free(p_loaded_graph);
+    }
+
+    remove(file_name);
+}
+
+/* Writes 'p_frozen_graph' as a DIMACS file, imports it and queries it: */
+static void benchmark_import(frozen_graph* p_frozen_graph,
+                             size_t source_vertex_id,
+                             size_t target_vertex_id,
+                             vertex_list* p_expected_path) {
+    static const char* file_name = "bidir_search_demo.gr";
+    FILE* file = fopen(file_name, "w");
+    frozen_graph* p_imported_graph;
+    vertex_list* p_path;
+    clock_t milliseconds_a;
+    clock_t milliseconds_b;
+    size_t i;
+    size_t arc;
+    int rs;
+
+    if (!file) {
+        puts("Could not write the DIMACS file.");
+        return;
+    }
+
+    fprintf(file,
+            "c Written by the demo.\np sp %lu %lu\n",
+            (unsigned long) p_frozen_graph->vertex_count,
+            (unsigned long) p_frozen_graph->edge_count);
+
+    for (i = 0; i < p_frozen_graph->vertex_count; ++i) {
+        for (arc = p_frozen_graph->forward_offsets[i];
+             arc < p_frozen_graph->forward_offsets[i + 1];
+             ++arc) {
+            fprintf(file,
+                    "a %lu %lu %.17g\n",
+                    (unsigned long) frozen_graph_get_vertex_id(p_frozen_graph,
+                                                               i),
+                    (unsigned long) frozen_graph_get_vertex_id(
+                            p_frozen_graph,
+                            p_frozen_graph->forward_heads[arc]),
+                    (double) p_frozen_graph->forward_weights[arc]);
+        }
+    }
+
+    fclose(file);
+
+    milliseconds_a = milliseconds();
+    p_imported_graph = frozen_graph_import(file_name,
+                                           GRAPH_IMPORT_DIMACS,
+                                           &rs);
+    milliseconds_b = milliseconds();
+
+    printf("Imported the DIMACS file in %ld milliseconds, status %d.\n",
+           (milliseconds_b - milliseconds_a),
+           rs);
+
+    if (p_imported_graph) {
+        p_path = find_shortest_path_frozen(p_imported_graph,
+                                           source_vertex_id,
+                                           target_vertex_id,
+                                           &rs);
+
+        if (p_path) {
+            printf("Imported path agrees: %d\n",
+                   paths_are_equal(p_expected_path, p_path));
+
+            vertex_list_free(p_path);
+        }
+
+        frozen_graph_free(p_imported_graph);
+    }
+
+    remove(file_name);
+}
+
+/* Loads the arcs of 'p_edge_list' with 'addEdges' and queries the result: */
+static void benchmark_add_edges(edge_list* p_edge_list,
+                                size_t source_vertex_id,
+                                size_t target_vertex_id,
+                                vertex_list* p_expected_path) {
+    Graph* p_graph = allocGraph();
+    vertex_list* p_path;
+    clock_t milliseconds_a;
+    clock_t milliseconds_b;
+    int rs;
+
+    milliseconds_a = milliseconds();
+    rs = addEdges(p_graph,
+                  p_edge_list->tails,
+                  p_edge_list->heads,
+                  p_edge_list->weights,
+                  p_edge_list->size,
+                  NODES);
+    milliseconds_b = milliseconds();
+
+    printf("Bulk-loaded the graph in %ld milliseconds, status %d.\n",
+           (milliseconds_b - milliseconds_a),
+           rs);
+
+    p_path = find_shortest_path(p_graph,
+                                source_vertex_id,
+                                target_vertex_id,
+                                &rs);
+
+    if (p_path) {
+        printf("Bulk-loaded path agrees: %d\n",
+               paths_are_equal(p_expected_path, p_path));
+
+        vertex_list_free(p_path);
+    }
+
+    freeGraph(p_graph);
+    free(p_graph);
+}
+
+/* Builds frozen graphs from 'p_edge_list' serially and in parallel: */
+static void benchmark_csr_build(edge_list* p_edge_list,
+                                size_t source_vertex_id,
+                                size_t target_vertex_id,
+                                vertex_list* p_expected_path) {
+    worker_pool* p_pool = worker_pool_alloc(0);
+    frozen_graph* p_frozen_graph;
+    vertex_list* p_path;
+    long milliseconds_a;
+    long milliseconds_b;
+    int rs;
+
+    milliseconds_a = wall_milliseconds();
+    p_frozen_graph = frozen_graph_build(p_edge_list->tails,
+                                        p_edge_list->heads,
+                                        p_edge_list->weights,
+                                        p_edge_list->size,
+                                        &rs);
+    milliseconds_b = wall_milliseconds();
+
+    printf("Built the CSR serially in %ld milliseconds, status %d.\n",
+           (milliseconds_b - milliseconds_a),
+           rs);
+
+    frozen_graph_free(p_frozen_graph);
+
+    if (!p_pool) {
+        return;
+    }
+
+    milliseconds_a = wall_milliseconds();
+    p_frozen_graph = frozen_graph_build_parallel(p_edge_list->tails,
+                                                 p_edge_list->heads,
+                                                 p_edge_list->weights,
+                                                 p_edge_list->size,
+                                                 p_pool,
+                                                 &rs);
+    milliseconds_b = wall_milliseconds();
+
+    printf("Built the CSR with %d workers in %ld milliseconds, status %d.\n",
+           (int) worker_pool_size(p_pool),
+           (milliseconds_b - milliseconds_a),
+           rs);
+
+    if (p_frozen_graph) {
+        p_path = find_shortest_path_frozen(p_frozen_graph,
+                                           source_vertex_id,
+                                           target_vertex_id,
+                                           &rs);
+
+        if (p_path) {
+            printf("Parallel CSR path agrees: %d\n",
+                   paths_are_equal(p_expected_path, p_path));
+
+            vertex_list_free(p_path);
+        }
+
+        frozen_graph_free(p_frozen_graph);
+    }
+
+    worker_pool_free(p_pool);
+}
+
+/* Runs the queries on 'p_frozen_graph' and returns the sum of the path
+lengths: */
+static double run_frozen_queries(search_context* p_search_context,
+                                 frozen_graph* p_frozen_graph,
+                                 Graph* p_graph,
+                                 size_t* source_vertex_ids,
+                                 size_t* target_vertex_ids,
+                                 size_t query_count,
+                                 clock_t* p_duration) {
+    size_t i;
+    clock_t milliseconds_a;
+    double total_length = 0.0;
+    vertex_list* path;
+    int rs;
+
+    milliseconds_a = milliseconds();
+
+    for (i = 0; i < query_count; ++i) {
+        path = find_shortest_path_frozen_with_context(p_search_context,
+                                                      p_frozen_graph,
+                                                      source_vertex_ids[i],
+                                                      target_vertex_ids[i],
+                                                      &rs);
+
+        if (path) {
+            total_length += get_path_length(path, p_graph);
+            vertex_list_free(path);
+        }
+    }
+
+    *p_duration = milliseconds() - milliseconds_a;
+    return total_length;
+}
+
+/* Runs the queries 'repeat_count' times and returns the sum of the path
+lengths. Stores the fastest run in '*p_duration', since the slower ones only
+add the noise of the machine: */
+static double time_frozen_queries(search_context* p_search_context,
+                                  frozen_graph* p_frozen_graph,
+                                  Graph* p_graph,
+                                  size_t* source_vertex_ids,
+                                  size_t* target_vertex_ids,
+                                  size_t repeat_count,
+                                  clock_t* p_duration) {
+    double length = 0.0;
+    clock_t duration;
+    size_t i;
+
+    for (i = 0; i < repeat_count; ++i) {
+        length = run_frozen_queries(p_search_context,
+                                    p_frozen_graph,
+                                    p_graph,
+                                    source_vertex_ids,
+                                    target_vertex_ids,
+                                    ORDER_QUERIES,
+                                    &duration);
+
+        if (i == 0 || duration < *p_duration) {
+            *p_duration = duration;
+        }
+    }
+
+    return length;
+}
+
+/* Runs the same random queries on a frozen jittered grid before and after
+each reordering. The vertex IDs are shuffled, so that the ID order, in which
+a graph is frozen, scatters the neighbors of a vertex over the arrays, as the
+IDs of an imported graph often do. The reorderings have some locality to
+recover then: */
+static void benchmark_orders() {
+    static const char* order_names[] = { "BFS order",
+                                         "reverse Cuthill-McKee order",
+                                         "degree order" };
+    static const int orders[] = { FROZEN_GRAPH_ORDER_BFS,
+                                  FROZEN_GRAPH_ORDER_RCM,
+                                  FROZEN_GRAPH_ORDER_DEGREE };
+    size_t vertex_count = ORDER_GRID_SIDE * ORDER_GRID_SIDE;
+    size_t* vertex_ids = malloc(sizeof(size_t) * vertex_count);
+    double* coordinates = malloc(sizeof(double) * 2 * vertex_count);
+    size_t* source_vertex_ids = malloc(sizeof(size_t) * ORDER_QUERIES);
+    size_t* target_vertex_ids = malloc(sizeof(size_t) * ORDER_QUERIES);
+    search_context* p_search_context = search_context_alloc();
+    Graph* p_graph;
+    frozen_graph* p_frozen_graph;
+    frozen_graph* p_reordered_graph;
+    clock_t milliseconds_a;
+    clock_t milliseconds_b;
+    clock_t duration;
+    double expected_length;
+    double length;
+    size_t swap;
+    size_t i;
+    size_t j;
+    int rs;
+
+    for (i = 0; i < vertex_count; ++i) {
+        vertex_ids[i] = i;
+    }
+
+    for (i = vertex_count - 1; i > 0; --i) {
+        j = intrand() % (i + 1);
+        swap = vertex_ids[i];
+        vertex_ids[i] = vertex_ids[j];
+        vertex_ids[j] = swap;
+    }
+
+    p_graph = build_jittered_grid(ORDER_GRID_SIDE, vertex_ids, coordinates);
+    p_frozen_graph = graph_freeze(p_graph);
+
+    for (i = 0; i < ORDER_QUERIES; ++i) {
+        source_vertex_ids[i] = intrand() % vertex_count;
+        target_vertex_ids[i] = intrand() % vertex_count;
+    }
+
+    expected_length = time_frozen_queries(p_search_context,
+                                          p_frozen_graph,
+                                          p_graph,
+                                          source_vertex_ids,
+                                          target_vertex_ids,
+                                          ORDER_REPEATS,
+                                          &duration);
+
+    printf("--- Vertex orders on a %d x %d grid with shuffled IDs, "
+           "fastest of %d runs:\n",
+           (int) ORDER_GRID_SIDE,
+           (int) ORDER_GRID_SIDE,
+           (int) ORDER_REPEATS);
+
+    printf("%d frozen queries in ID order: %ld milliseconds.\n",
+           (int) ORDER_QUERIES,
+           duration);
+
+    for (i = 0; i < sizeof(orders) / sizeof(orders[0]); ++i) {
+        milliseconds_a = milliseconds();
+        p_reordered_graph = frozen_graph_reorder(p_frozen_graph,
+                                                 orders[i],
+                                                 &rs);
+        milliseconds_b = milliseconds();
+
+        if (!p_reordered_graph) {
+            printf("Reordering failed with status %d.\n", rs);
+            continue;
+        }
+
+        length = time_frozen_queries(p_search_context,
+                                     p_reordered_graph,
+                                     p_graph,
+                                     source_vertex_ids,
+                                     target_vertex_ids,
+                                     ORDER_REPEATS,
+                                     &duration);
+
+        printf("%d frozen queries in %s: %ld milliseconds "
+               "(reordered in %ld milliseconds), lengths agree: %d.\n",
+               (int) ORDER_QUERIES,
+               order_names[i],
+               duration,
+               (milliseconds_b - milliseconds_a),
+               length == expected_length);
+
+        frozen_graph_free(p_reordered_graph);
+    }
+
+    search_context_free(p_search_context);
+    frozen_graph_free(p_frozen_graph);
+    freeGraph(p_graph);
+    free(p_graph);
+    free(vertex_ids);
+    free(coordinates);
+    free(source_vertex_ids);
+    free(target_vertex_ids);
+}
+
+/* Runs the queries on 'p_compressed_graph' and returns the sum of the path
+lengths: */
+static double run_compressed_queries(search_context* p_search_context,
+                                     compressed_graph* p_compressed_graph,
+                                     Graph* p_graph,
+                                     size_t* source_vertex_ids,
+                                     size_t* target_vertex_ids,
+                                     clock_t* p_duration) {
+    size_t i;
+    clock_t milliseconds_a;
+    double total_length = 0.0;
+    vertex_list* path;
+    int rs;
+
+    milliseconds_a = milliseconds();
+
+    for (i = 0; i < QUERIES; ++i) {
+        path = find_shortest_path_compressed_with_context(p_search_context,
+                                                          p_compressed_graph,
+                                                          source_vertex_ids[i],
+                                                          target_vertex_ids[i],
+                                                          &rs);
+
+        if (path) {
+            total_length += get_path_length(path, p_graph);
+            vertex_list_free(path);
+        }
+    }
+
+    *p_duration = milliseconds() - milliseconds_a;
+    return total_length;
+}
+
+/* Compares the memory use and the query time of frozen and compressed
+graphs: */
+static void benchmark_compression(frozen_graph* p_frozen_graph,
+                                  Graph* p_graph) {
+    static const char* variant_names[] = { "exact weights",
+                                           "weights quantized to 1/256",
+                                           "exact weights, BFS order" };
+    static const double weight_quanta[] = { 0.0, 1.0 / 256, 0.0 };
+    size_t i;
+    size_t* source_vertex_ids = malloc(sizeof(size_t) * QUERIES);
+    size_t* target_vertex_ids = malloc(sizeof(size_t) * QUERIES);
+    size_t vertex_count = p_frozen_graph->vertex_count;
+    size_t arc_count = 2 * p_frozen_graph->edge_count;
+    size_t frozen_size = sizeof(*p_frozen_graph) +
+                         2 * sizeof(size_t) * (vertex_count + 1) +
+                         arc_count * (sizeof(vertex_id_t) + sizeof(weight_t)) +
+                         sizeof(vertex_id_t) * vertex_count;
+    search_context* p_search_context = search_context_alloc();
+    frozen_graph* p_reordered_graph =
+            frozen_graph_reorder(p_frozen_graph, FROZEN_GRAPH_ORDER_BFS, NULL);
+    compressed_graph* p_compressed_graph;
+    clock_t milliseconds_a;
+    clock_t milliseconds_b;
+    clock_t duration;
+    double expected_length;
+    double length;
+    int rs;
+
+    for (i = 0; i < QUERIES; ++i) {
+        source_vertex_ids[i] = intrand() % NODES;
+        target_vertex_ids[i] = intrand() % NODES;
+    }
+
+    expected_length = run_frozen_queries(p_search_context,
+                                         p_frozen_graph,
+                                         p_graph,
+                                         source_vertex_ids,
+                                         target_vertex_ids,
+                                         QUERIES,
+                                         &duration);
+
+    printf("Frozen graph: %.2f bytes per arc, %d queries in %ld "
+           "milliseconds.\n",
+           (double) frozen_size / arc_count,
+           (int) QUERIES,
+           duration);
+
+    for (i = 0; i < sizeof(weight_quanta) / sizeof(weight_quanta[0]); ++i) {
+        milliseconds_a = milliseconds();
+        p_compressed_graph = frozen_graph_compress(i == 2 ?
+                                                   p_reordered_graph :
+                                                   p_frozen_graph,
+                                                   weight_quanta[i],
+                                                   &rs);
+        milliseconds_b = milliseconds();
+
+        if (!p_compressed_graph) {
+            printf("Compression failed with status %d.\n", rs);
+            continue;
+        }
+
+        length = run_compressed_queries(p_search_context,
+                                        p_compressed_graph,
+                                        p_graph,
+                                        source_vertex_ids,
+                                        target_vertex_ids,
+                                        &duration);
+
+        printf("Compressed graph, %s: %.2f bytes per arc, compressed in %ld "
+               "milliseconds, %d queries in %ld milliseconds, total length "
+               "%f (frozen: %f).\n",
+               variant_names[i],
+               (double) compressed_graph_size(p_compressed_graph) / arc_count,
+               (milliseconds_b - milliseconds_a),
+               (int) QUERIES,
+               duration,
+               length,
+               expected_length);
+
+        compressed_graph_free(p_compressed_graph);
+    }
+
+    frozen_graph_free(p_reordered_graph);
+    search_context_free(p_search_context);
+    free(source_vertex_ids);
+    free(target_vertex_ids);
+}
+
+void buildGraph() {
     Graph* p_graph = allocGraph();
 
     size_t i;
@@ -77,9 +1303,12 @@ Graph* buildGraph() {
     clock_t milliseconds_b;
     vertex_list* path;
     vertex_list* path_2;
+    vertex_list* path_3;
+    vertex_list* path_4;
+    frozen_graph* p_frozen_graph;
+    edge_list* p_edge_list = edge_list_alloc(EDGES);
     int rs = -1;
     unsigned random_seed;
-    initGraph(p_graph);
 
     random_seed = (unsigned) time(NULL);
     srand(random_seed);
@@ -94,6 +1323,10 @@ Graph* buildGraph() {
         weight = randfrom(0.0, 10.0);
         addEdge(p_graph, id1, id2, weight);
 
+        if (p_edge_list) {
+            edge_list_add(p_edge_list, id1, id2, weight);
+        }
+
         if (edge == 0) {
             source_vertex_id = id1;
         }
@@ -148,13 +1381,104 @@ Graph* buildGraph() {
 
     printf("Result status: %d\n", rs);
 
-    printf("Algorithms agree: %d\n", paths_are_equal(path, path_2));
+    printf("Algorithms agree: %d\n\n", paths_are_equal(path, path_2));
+
+    milliseconds_a = milliseconds();
+    p_frozen_graph = graph_freeze(p_graph);
+    milliseconds_b = milliseconds();
+
+    printf("Froze the graph in %ld milliseconds.\n\n",
+           (milliseconds_b - milliseconds_a));
+
+    puts("--- Bidirectional Dijkstra (frozen):");
+
+    milliseconds_a = milliseconds();
+    path_3 = find_shortest_path_frozen(p_frozen_graph,
+                                       source_vertex_id,
+                                       target_vertex_id,
+                                       &rs);
+
+    milliseconds_b = milliseconds();
+
+    printf("Path length: %f\n", get_path_length(path_3, p_graph));
+    printf("Duration: %ld milliseconds.\n",
+           (milliseconds_b - milliseconds_a));
+
+    printf("Result status: %d\n\n", rs);
+    puts("--- Original Dijkstra (frozen):");
+
+    milliseconds_a = milliseconds();
+    path_4 = find_shortest_path_2_frozen(p_frozen_graph,
+                                         source_vertex_id,
+                                         target_vertex_id,
+                                         &rs);
+
+    milliseconds_b = milliseconds();
+
+    printf("Path length: %f\n", get_path_length(path_4, p_graph));
+    printf("Duration: %ld milliseconds.\n",
+           (milliseconds_b - milliseconds_a));
+
+    printf("Result status: %d\n", rs);
+
+    printf("Frozen algorithms agree: %d\n",
+           paths_are_equal(path, path_3) &&
+           paths_are_equal(path_2, path_4));
+
+    puts("");
+    benchmark_snapshot(p_frozen_graph,
+                       source_vertex_id,
+                       target_vertex_id,
+                       path);
+
+    if (p_edge_list) {
+        puts("");
+        benchmark_add_edges(p_edge_list,
+                            source_vertex_id,
+                            target_vertex_id,
+                            path);
+
+        puts("");
+        benchmark_csr_build(p_edge_list,
+                            source_vertex_id,
+                            target_vertex_id,
+                            path);
+
+        edge_list_free(p_edge_list);
+    }
+
+    puts("");
+    benchmark_import(p_frozen_graph,
+                     source_vertex_id,
+                     target_vertex_id,
+                     path);
+
+    puts("");
+    benchmark_orders();
+
+    puts("");
+    benchmark_compression(p_frozen_graph, p_graph);
+
+    puts("");
+    benchmark_search_context(p_graph);
 
     vertex_list_free(path);
     vertex_list_free(path_2);
+    vertex_list_free(path_3);
+    vertex_list_free(path_4);
+    frozen_graph_free(p_frozen_graph);
 
+    printf("\nThe graph arena holds %lu bytes.\n",
+           (unsigned long) graph_arena_reserved_size(p_graph->p_arena));
+
+    milliseconds_a = milliseconds();
     freeGraph(p_graph);
-    return p_graph;
+    milliseconds_b = milliseconds();
+
+    printf("Freed the graph in %ld milliseconds.\n",
+           (milliseconds_b - milliseconds_a));
+
+    free(p_graph);
 }
 
 void testSameVertex() {
@@ -189,6 +1513,17 @@ void testSameVertex() {
 
 int main(int argc, char* argv[])
 {
+    printf("Vertex ID: %d bytes, weight: %d bytes, search record: %d bytes.\n",
+           (int) sizeof(vertex_id_t),
+           (int) sizeof(weight_t),
+           (int) sizeof(search_record));
+
     buildGraph();
+    puts("");
+    benchmark_queues();
+    puts("");
+    benchmark_hashes();
+    puts("");
+    benchmark_goal_direction();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include "radix_heap.h"
+#include "allocator.h"
+#include "util.h"
+
+static const size_t MINIMUM_INITIAL_CAPACITY = 4;
+
+/* Marks the end of a bucket list and of the free list: */
+static const size_t NIL = (size_t) -1;
+
+static size_t fix_initial_capacity(size_t initial_capacity) {
+    return initial_capacity < MINIMUM_INITIAL_CAPACITY ?
+           MINIMUM_INITIAL_CAPACITY :
+           initial_capacity;
+}
+
+/* Returns the bucket 'key' belongs to, relative to the last minimum: */
+static size_t get_bucket(radix_heap* my_heap, size_t key)
+{
+    size_t difference = key ^ my_heap->last_min;
+    size_t shift = sizeof(size_t) * CHAR_BIT / 2;
+    size_t bucket = 1;
+
+    if (difference == 0)
+    {
+        return 0;
+    }
+
+    /* Binary search for the highest set bit: */
+    while (shift > 0)
+    {
+        if (difference >> shift)
+        {
+            difference >>= shift;
+            bucket += shift;
+        }
+
+        shift >>= 1;
+    }
+
+    return bucket;
+}
+
+static void link_node(radix_heap* my_heap, size_t node_index, size_t bucket)
+{
+    radix_heap_node* p_node = &my_heap->nodes[node_index];
+    size_t head = my_heap->buckets[bucket];
+
+    p_node->prev = NIL;
+    p_node->next = head;
+
+    if (head != NIL)
+    {
+        my_heap->nodes[head].prev = node_index;
+    }
+
+    my_heap->buckets[bucket] = node_index;
+}
+
+static void unlink_node(radix_heap* my_heap, size_t node_index)
+{
+    radix_heap_node* p_node = &my_heap->nodes[node_index];
+
+    if (p_node->prev != NIL)
+    {
+        my_heap->nodes[p_node->prev].next = p_node->next;
+    }
+    else
+    {
+        my_heap->buckets[get_bucket(my_heap, p_node->key)] = p_node->next;
+    }
+
+    if (p_node->next != NIL)
+    {
+        my_heap->nodes[p_node->next].prev = p_node->prev;
+    }
+}
+
+/*******************************************************************************
+* Makes sure that bucket 0 holds the minimum keys. If it is empty, the first   *
+* nonempty bucket is emptied: its minimum key becomes the new last minimum and *
+* its nodes are spread into lower buckets. Must not be called on empty heaps.  *
+*******************************************************************************/
+static void pull_min(radix_heap* my_heap)
+{
+    size_t bucket = 1;
+    size_t node_index;
+    size_t next_node_index;
+    size_t min_key;
+
+    if (my_heap->buckets[0] != NIL)
+    {
+        return;
+    }
+
+    while (my_heap->buckets[bucket] == NIL)
+    {
+        ++bucket;
+    }
+
+    node_index = my_heap->buckets[bucket];
+    min_key = my_heap->nodes[node_index].key;
+
+    for (; node_index != NIL; node_index = my_heap->nodes[node_index].next)
+    {
+        if (min_key > my_heap->nodes[node_index].key)
+        {
+            min_key = my_heap->nodes[node_index].key;
+        }
+    }
+
+    node_index = my_heap->buckets[bucket];
+    my_heap->buckets[bucket] = NIL;
+    my_heap->last_min = min_key;
+
+    while (node_index != NIL)
+    {
+        next_node_index = my_heap->nodes[node_index].next;
+        link_node(my_heap,
+                  node_index,
+                  get_bucket(my_heap, my_heap->nodes[node_index].key));
+
+        node_index = next_node_index;
+    }
+}
+
+radix_heap* radix_heap_alloc(size_t initial_capacity)
+{
+    radix_heap* my_heap = allocator_malloc(sizeof(*my_heap));
+
+    if (!my_heap)
+    {
+        return NULL;
+    }
+
+    initial_capacity = fix_initial_capacity(initial_capacity);
+    my_heap->nodes =
+            allocator_malloc(sizeof(radix_heap_node) * initial_capacity);
+
+    if (!my_heap->nodes)
+    {
+        allocator_free(my_heap);
+        return NULL;
+    }
+
+    my_heap->capacity = initial_capacity;
+    my_heap->p_positions = NULL;
+    my_heap->position_stride = 0;
+    radix_heap_clear(my_heap);
+    return my_heap;
+}
+
+void radix_heap_set_positions(radix_heap* my_heap,
+                              void* p_positions,
+                              size_t position_stride)
+{
+    my_heap->p_positions = p_positions;
+    my_heap->position_stride = position_stride;
+}
+
+int radix_heap_add(radix_heap* my_heap,
+                   vertex_id_t vertex_index,
+                   size_t key)
+{
+    radix_heap_node* new_nodes;
+    size_t node_index;
+
+    if (my_heap->free_list != NIL)
+    {
+        node_index = my_heap->free_list;
+        my_heap->free_list = my_heap->nodes[node_index].next;
+    }
+    else
+    {
+        if (my_heap->node_count == my_heap->capacity)
+        {
+            new_nodes = allocator_realloc(my_heap->nodes,
+                                          sizeof(radix_heap_node) *
+                                          2 * my_heap->capacity);
+
+            if (!new_nodes)
+            {
+                return RETURN_STATUS_NO_MEMORY;
+            }
+
+            my_heap->nodes = new_nodes;
+            my_heap->capacity *= 2;
+        }
+
+        node_index = my_heap->node_count++;
+    }
+
+    my_heap->nodes[node_index].key = key;
+    my_heap->nodes[node_index].vertex_index = vertex_index;
+    link_node(my_heap, node_index, get_bucket(my_heap, key));
+
+    if (my_heap->p_positions)
+    {
+        *(vertex_id_t*)(my_heap->p_positions +
+                        vertex_index * my_heap->position_stride) = node_index;
+    }
+
+    my_heap->size++;
+    return RETURN_STATUS_OK;
+}
+
+void radix_heap_decrease_key(radix_heap* my_heap,
+                             vertex_id_t vertex_index,
+                             size_t key)
+{
+    size_t node_index =
+            *(vertex_id_t*)(my_heap->p_positions +
+                            vertex_index * my_heap->position_stride);
+
+    if (key < my_heap->nodes[node_index].key)
+    {
+        unlink_node(my_heap, node_index);
+        my_heap->nodes[node_index].key = key;
+        link_node(my_heap, node_index, get_bucket(my_heap, key));
+    }
+}
+
+vertex_id_t radix_heap_extract_min(radix_heap* my_heap)
+{
+    size_t node_index;
+
+    pull_min(my_heap);
+    node_index = my_heap->buckets[0];
+    unlink_node(my_heap, node_index);
+
+    my_heap->nodes[node_index].next = my_heap->free_list;
+    my_heap->free_list = node_index;
+    my_heap->size--;
+
+    return my_heap->nodes[node_index].vertex_index;
+}
+
+vertex_id_t radix_heap_min(radix_heap* my_heap)
+{
+    pull_min(my_heap);
+    return my_heap->nodes[my_heap->buckets[0]].vertex_index;
+}
+
+size_t radix_heap_min_key(radix_heap* my_heap)
+{
+    pull_min(my_heap);
+    return my_heap->nodes[my_heap->buckets[0]].key;
+}
+
+size_t radix_heap_size(radix_heap* my_heap)
+{
+    return my_heap->size;
+}
+
+void radix_heap_clear(radix_heap* my_heap)
+{
+    size_t i;
+
+    for (i = 0; i < RADIX_HEAP_BUCKETS; ++i)
+    {
+        my_heap->buckets[i] = NIL;
+    }
+
+    my_heap->node_count = 0;
+    my_heap->free_list = NIL;
+    my_heap->size = 0;
+    my_heap->last_min = 0;
+}
+
+void radix_heap_free(radix_heap* my_heap)
+{
+    if (!my_heap)
+    {
+        return;
+    }
+
+    allocator_free(my_heap->nodes);
+    allocator_free(my_heap);
+}
@@ -0,0 +1,63 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_RADIX_HEAP_H
+#define	COM_GITHUB_CODERODDE_BIDIR_SEARCH_RADIX_HEAP_H
+
+#include "types.h"
+#include <limits.h>
+#include <stdlib.h>
+
+/* Bucket 0 holds the keys equal to the last extracted minimum; bucket 'b' > 0
+   holds the keys whose highest bit differing from it is bit 'b - 1': */
+#define RADIX_HEAP_BUCKETS (sizeof(size_t) * CHAR_BIT + 1)
+
+typedef struct radix_heap_node {
+    size_t      key;
+    vertex_id_t vertex_index;
+    size_t      prev;
+    size_t      next;
+} radix_heap_node;
+
+/*******************************************************************************
+* A monotone radix heap over dense vertex indices with integer keys. A key     *
+* being added or decreased must not be smaller than the last extracted         *
+* minimum, which holds for Dijkstra's algorithm with non-negative weights.     *
+* The nodes live in one array and are linked into per-bucket lists by index,   *
+* so only 'radix_heap_add' may allocate memory. Like 'index_heap', the heap    *
+* writes the node of vertex 'v' to the vertex_id_t at                          *
+* 'p_positions + v * position_stride'. Without a position store, the heap      *
+* tracks no positions, 'radix_heap_decrease_key' must not be called, and a     *
+* vertex may be added any number of times.                                     *
+*******************************************************************************/
+typedef struct radix_heap {
+    radix_heap_node* nodes;
+    size_t           node_count;
+    size_t           capacity;
+    size_t           free_list;
+    size_t           size;
+    size_t           last_min;
+    size_t           buckets[RADIX_HEAP_BUCKETS];
+    char*            p_positions;
+    size_t           position_stride;
+} radix_heap;
+
+radix_heap* radix_heap_alloc(size_t initial_capacity);
+
+void radix_heap_set_positions(radix_heap* heap,
+                              void* p_positions,
+                              size_t position_stride);
+
+int radix_heap_add(radix_heap* heap,
+                   vertex_id_t vertex_index,
+                   size_t key);
+
+void radix_heap_decrease_key(radix_heap* heap,
+                             vertex_id_t vertex_index,
+                             size_t key);
+
+vertex_id_t radix_heap_extract_min (radix_heap* heap);
+vertex_id_t radix_heap_min         (radix_heap* heap);
+size_t      radix_heap_min_key     (radix_heap* heap);
+size_t      radix_heap_size        (radix_heap* heap);
+void        radix_heap_clear       (radix_heap* heap);
+void        radix_heap_free        (radix_heap* heap);
+
+#endif	/* COM_GITHUB_CODERODDE_BIDIR_SEARCH_RADIX_HEAP_H */
@@ -0,0 +1,236 @@
+#include "search_context.h"
+#include "allocator.h"
+#include "index_heap.h"
+#include "util.h"
+#include <stdlib.h>
+
+static const size_t INITIAL_CAPACITY = 1024;
+static const size_t HEAP_DEGREE = 4;
+
+/* Tells the open sets where the heap positions are stored. In lazy deletion
+   mode the positions are not needed, so none are tracked: */
+static void search_space_set_positions(search_space* p_space,
+                                       int lazy_deletion)
+{
+    void* p_positions = NULL;
+
+    if (!p_space->records)
+    {
+        return;
+    }
+
+    if (!lazy_deletion)
+    {
+        p_positions = &p_space->records[0].heap_index;
+    }
+
+    index_heap_set_positions(p_space->p_open,
+                             p_positions,
+                             sizeof(search_record));
+
+    if (p_space->p_radix_open)
+    {
+        radix_heap_set_positions(p_space->p_radix_open,
+                                 p_positions,
+                                 sizeof(search_record));
+    }
+}
+
+static void search_space_init(search_space* p_space)
+{
+    p_space->p_open = index_heap_alloc(HEAP_DEGREE, INITIAL_CAPACITY);
+    p_space->p_radix_open = NULL;
+
+    p_space->records = NULL;
+    vertex_bitset_init(&p_space->reached);
+    vertex_bitset_init(&p_space->settled);
+    p_space->settled_count = 0;
+    p_space->p_potential = NULL;
+}
+
+static void search_space_free(search_space* p_space)
+{
+    index_heap_free(p_space->p_open);
+    radix_heap_free(p_space->p_radix_open);
+
+    allocator_free(p_space->records);
+    vertex_bitset_destroy(&p_space->reached);
+    vertex_bitset_destroy(&p_space->settled);
+}
+
+static int search_space_grow(search_space* p_space,
+                             size_t new_capacity,
+                             int lazy_deletion)
+{
+    search_record* new_records;
+
+    /* The records need no initialization, since a record is read only after
+       its vertex has been added to the reached set: */
+    new_records = allocator_realloc(p_space->records,
+                                    sizeof(search_record) * new_capacity);
+
+    if (!new_records)
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    p_space->records = new_records;
+
+    /* The records have moved: */
+    search_space_set_positions(p_space, lazy_deletion);
+
+    if (vertex_bitset_reserve(&p_space->reached, new_capacity)
+        != RETURN_STATUS_OK ||
+        vertex_bitset_reserve(&p_space->settled, new_capacity)
+        != RETURN_STATUS_OK) {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    return RETURN_STATUS_OK;
+}
+
+search_context* search_context_alloc()
+{
+    search_context* p_search_context =
+            allocator_malloc(sizeof(*p_search_context));
+
+    if (!p_search_context)
+    {
+        return NULL;
+    }
+
+    search_space_init(&p_search_context->forward);
+    search_space_init(&p_search_context->backward);
+    p_search_context->capacity = 0;
+    p_search_context->queue_kind = SEARCH_QUEUE_DARY_HEAP;
+    p_search_context->lazy_deletion = FALSE;
+
+    if (!p_search_context->forward.p_open ||
+        !p_search_context->backward.p_open) {
+        search_context_free(p_search_context);
+        return NULL;
+    }
+
+    return p_search_context;
+}
+
+static int search_space_alloc_radix_heap(search_space* p_space,
+                                         int lazy_deletion)
+{
+    if (p_space->p_radix_open)
+    {
+        return RETURN_STATUS_OK;
+    }
+
+    p_space->p_radix_open = radix_heap_alloc(INITIAL_CAPACITY);
+
+    if (!p_space->p_radix_open)
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    search_space_set_positions(p_space, lazy_deletion);
+    return RETURN_STATUS_OK;
+}
+
+int search_context_set_queue(search_context* p_search_context,
+                             int queue_kind)
+{
+    if (queue_kind == SEARCH_QUEUE_RADIX_HEAP &&
+        (search_space_alloc_radix_heap(&p_search_context->forward,
+                                       p_search_context->lazy_deletion)
+         != RETURN_STATUS_OK ||
+         search_space_alloc_radix_heap(&p_search_context->backward,
+                                       p_search_context->lazy_deletion)
+         != RETURN_STATUS_OK)) {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    p_search_context->queue_kind = queue_kind;
+    return RETURN_STATUS_OK;
+}
+
+void search_context_set_lazy_deletion(search_context* p_search_context,
+                                      int lazy_deletion)
+{
+    p_search_context->lazy_deletion = lazy_deletion;
+    search_space_set_positions(&p_search_context->forward, lazy_deletion);
+    search_space_set_positions(&p_search_context->backward, lazy_deletion);
+}
+
+void search_context_set_heap_degree(search_context* p_search_context,
+                                    size_t degree)
+{
+    index_heap_clear(p_search_context->forward.p_open);
+    index_heap_clear(p_search_context->backward.p_open);
+    index_heap_set_degree(p_search_context->forward.p_open, degree);
+    index_heap_set_degree(p_search_context->backward.p_open, degree);
+}
+
+static void search_space_reset(search_space* p_space)
+{
+    index_heap_clear(p_space->p_open);
+
+    if (p_space->p_radix_open)
+    {
+        radix_heap_clear(p_space->p_radix_open);
+    }
+
+    vertex_bitset_clear(&p_space->reached);
+    vertex_bitset_clear(&p_space->settled);
+    p_space->settled_count = 0;
+}
+
+void search_context_reset(search_context* p_search_context)
+{
+    search_space_reset(&p_search_context->forward);
+    search_space_reset(&p_search_context->backward);
+}
+
+int search_context_prepare(search_context* p_search_context,
+                           size_t vertex_count)
+{
+    size_t new_capacity;
+
+    search_context_reset(p_search_context);
+
+    if (vertex_count <= p_search_context->capacity)
+    {
+        return RETURN_STATUS_OK;
+    }
+
+    new_capacity = p_search_context->capacity ?
+                   p_search_context->capacity :
+                   INITIAL_CAPACITY;
+
+    while (new_capacity < vertex_count)
+    {
+        new_capacity *= 2;
+    }
+
+    if (search_space_grow(&p_search_context->forward,
+                          new_capacity,
+                          p_search_context->lazy_deletion)
+        != RETURN_STATUS_OK ||
+        search_space_grow(&p_search_context->backward,
+                          new_capacity,
+                          p_search_context->lazy_deletion)
+        != RETURN_STATUS_OK) {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    p_search_context->capacity = new_capacity;
+    return RETURN_STATUS_OK;
+}
+
+void search_context_free(search_context* p_search_context)
+{
+    if (!p_search_context)
+    {
+        return;
+    }
+
+    search_space_free(&p_search_context->forward);
+    search_space_free(&p_search_context->backward);
+    allocator_free(p_search_context);
+}
@@ -0,0 +1,118 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_SEARCH_CONTEXT_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_SEARCH_CONTEXT_H
+
+#include "index_heap.h"
+#include "radix_heap.h"
+#include "types.h"
+#include "vertex_bitset.h"
+#include <stdlib.h>
+
+/*******************************************************************************
+* The state of one vertex in one search direction. A record is valid only if   *
+* its vertex is in the 'reached' set of its search space, which means that the *
+* vertex has a tentative distance and a parent. 'heap_index' is the position   *
+* of a reached vertex in the open set. The queue maintains it, except in lazy  *
+* deletion mode, where it is unused.                                           *
+*******************************************************************************/
+typedef struct search_record {
+    distance_t  distance;
+    vertex_id_t parent;
+    vertex_id_t heap_index;
+} search_record;
+
+/*******************************************************************************
+* The priority queues a search context may use for its open sets:              *
+*   SEARCH_QUEUE_DARY_HEAP  - a d-ary heap; works with any non-negative        *
+*                             weights.                                         *
+*   SEARCH_QUEUE_RADIX_HEAP - a monotone radix heap; requires that all arc     *
+*                             weights are non-negative integers. A search that *
+*                             meets another weight fails with                  *
+*                             RETURN_STATUS_NON_INTEGER_WEIGHT.                *
+*******************************************************************************/
+#define SEARCH_QUEUE_DARY_HEAP  0
+#define SEARCH_QUEUE_RADIX_HEAP 1
+
+/*******************************************************************************
+* The state of a search in one direction. 'records' is indexed by the dense    *
+* vertex indices. 'reached' holds the vertices with a valid record and         *
+* 'settled' the closed ones, so that skipping a closed neighbor tests one bit  *
+* instead of loading its record. Only the open set of the selected queue kind  *
+* is in use; 'p_radix_open' is allocated the first time the radix heap is      *
+* selected. 'p_potential' is set by a goal-directed query while it runs, and   *
+* is NULL otherwise.                                                           *
+*******************************************************************************/
+struct search_potential;
+
+typedef struct search_space {
+    index_heap*    p_open;
+    radix_heap*    p_radix_open;
+    search_record* records;
+    vertex_bitset  reached;
+    vertex_bitset  settled;
+    size_t         settled_count;
+
+    const struct search_potential* p_potential;
+} search_space;
+
+/*******************************************************************************
+* Holds the data structures of a shortest path search. A context may be        *
+* allocated once and passed to any number of queries, which spares each query  *
+* from allocating and freeing its tables. The unidirectional searches use only *
+* the forward space. A context must not be shared by concurrent queries.       *
+*******************************************************************************/
+typedef struct search_context {
+    search_space forward;
+    search_space backward;
+    size_t       capacity;
+    int          queue_kind;
+    int          lazy_deletion;
+} search_context;
+
+/*******************************************************************************
+* Allocates a context that uses the d-ary heap.                                *
+*******************************************************************************/
+search_context* search_context_alloc();
+
+/*******************************************************************************
+* Selects the priority queue kind of the context, one of the SEARCH_QUEUE_*    *
+* constants. Takes effect from the next query on. Returns RETURN_STATUS_OK, or *
+* RETURN_STATUS_NO_MEMORY if the queues could not be allocated, in which case  *
+* the context keeps its previous queue kind.                                   *
+*******************************************************************************/
+int search_context_set_queue(search_context* p_search_context,
+                             int queue_kind);
+
+/*******************************************************************************
+* Turns lazy deletion on or off. With lazy deletion, the queues track no       *
+* positions and a relaxation that improves a queued vertex pushes a duplicate  *
+* entry instead of decreasing its key; outdated entries are skipped when they  *
+* surface. This keeps the heap operations from writing to the search records,  *
+* at the cost of larger queues. Takes effect from the next query on.           *
+*******************************************************************************/
+void search_context_set_lazy_deletion(search_context* p_search_context,
+                                      int lazy_deletion);
+
+/*******************************************************************************
+* Sets the degree of the d-ary heaps; the default is 4. Wider heaps are        *
+* shallower, and degrees that are multiples of 4 or 8 let the heaps compare    *
+* the children of a node with SIMD instructions. Takes effect from the next    *
+* query on.                                                                    *
+*******************************************************************************/
+void search_context_set_heap_degree(search_context* p_search_context,
+                                    size_t degree);
+
+/*******************************************************************************
+* Empties the context in time proportional to the number of vertices that      *
+* the last query reached, since only the bitset words it touched are cleared.  *
+*******************************************************************************/
+void search_context_reset(search_context* p_search_context);
+
+/*******************************************************************************
+* Resets the context and makes sure it can hold 'vertex_count' vertices.       *
+*******************************************************************************/
+int search_context_prepare(search_context* p_search_context,
+                           size_t vertex_count);
+
+void search_context_free(search_context* p_search_context);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_SEARCH_CONTEXT_H */
@@ -0,0 +1,45 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_TYPES_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_TYPES_H
+
+#include <limits.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+* The storage types of the library, fixed at compile time:                     *
+*   vertex_id_t - vertex IDs and dense vertex indices. 'size_t' by default, or *
+*                 'unsigned int' if BIDIR_SEARCH_VERTEX_ID_32 is defined.      *
+*   weight_t    - arc weights. 'double' by default, 'float' if                 *
+*                 BIDIR_SEARCH_WEIGHT_FLOAT is defined, or 'unsigned int' if   *
+*                 BIDIR_SEARCH_WEIGHT_UINT32 is defined.                       *
+*   distance_t  - the distances kept by the searches. 'float' for float        *
+*                 weights and 'double' otherwise, so that sums of 32-bit       *
+*                 integer weights stay exact up to 2^53.                       *
+* 32-bit IDs and float weights halve the bytes per arc and shrink the search   *
+* records. A graph built with 32-bit IDs must have fewer than 2^32 - 1         *
+* vertices, and the IDs must fit in 32 bits.                                   *
+*******************************************************************************/
+#ifdef BIDIR_SEARCH_VERTEX_ID_32
+typedef unsigned int vertex_id_t;
+#define VERTEX_ID_MAX UINT_MAX
+#else
+typedef size_t vertex_id_t;
+#define VERTEX_ID_MAX ((size_t) -1)
+#endif
+
+#if defined(BIDIR_SEARCH_WEIGHT_FLOAT) && defined(BIDIR_SEARCH_WEIGHT_UINT32)
+#error "Define at most one of BIDIR_SEARCH_WEIGHT_FLOAT and \
+BIDIR_SEARCH_WEIGHT_UINT32."
+#endif
+
+#if defined(BIDIR_SEARCH_WEIGHT_FLOAT)
+typedef float weight_t;
+typedef float distance_t;
+#elif defined(BIDIR_SEARCH_WEIGHT_UINT32)
+typedef unsigned int weight_t;
+typedef double distance_t;
+#else
+typedef double weight_t;
+typedef double distance_t;
+#endif
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_TYPES_H */
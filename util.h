@@ -10,6 +10,11 @@
 #define RETURN_STATUS_NO_MAP                  7
 #define RETURN_STATUS_NO_SOURCE_VERTEX        8
 #define RETURN_STATUS_NO_TARGET_VERTEX        16
+#define RETURN_STATUS_NON_INTEGER_WEIGHT      32
+#define RETURN_STATUS_IO_ERROR                64
+#define RETURN_STATUS_INVALID_SNAPSHOT        128
+#define RETURN_STATUS_PARSE_ERROR             256
+#define RETURN_STATUS_NO_VERTEX               512
 
 #define FALSE 0
 #define TRUE 1
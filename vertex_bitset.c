@@ -0,0 +1,88 @@
+#include "vertex_bitset.h"
+#include "allocator.h"
+#include "util.h"
+#include <stdlib.h>
+#include <string.h>
+
+void vertex_bitset_init(vertex_bitset* p_set)
+{
+    p_set->words = NULL;
+    p_set->touched_words = NULL;
+    p_set->touched_count = 0;
+    p_set->capacity = 0;
+}
+
+int vertex_bitset_reserve(vertex_bitset* p_set, size_t capacity)
+{
+    size_t old_word_count = p_set->capacity / VERTEX_BITSET_WORD_BITS;
+    size_t new_word_count;
+    unsigned long* new_words;
+    size_t* new_touched_words;
+
+    if (capacity <= p_set->capacity)
+    {
+        return RETURN_STATUS_OK;
+    }
+
+    new_word_count = (capacity + VERTEX_BITSET_WORD_BITS - 1) /
+                     VERTEX_BITSET_WORD_BITS;
+
+    new_words = allocator_realloc(p_set->words,
+                                  sizeof(unsigned long) * new_word_count);
+
+    if (!new_words)
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    p_set->words = new_words;
+
+    /* A word is listed at most once, so the list never outgrows the words: */
+    new_touched_words = allocator_realloc(p_set->touched_words,
+                                          sizeof(size_t) * new_word_count);
+
+    if (!new_touched_words)
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    p_set->touched_words = new_touched_words;
+
+    memset(p_set->words + old_word_count,
+           0,
+           sizeof(unsigned long) * (new_word_count - old_word_count));
+
+    p_set->capacity = new_word_count * VERTEX_BITSET_WORD_BITS;
+    return RETURN_STATUS_OK;
+}
+
+void vertex_bitset_add(vertex_bitset* p_set, size_t index)
+{
+    size_t word_index = index / VERTEX_BITSET_WORD_BITS;
+
+    if (!p_set->words[word_index])
+    {
+        p_set->touched_words[p_set->touched_count++] = word_index;
+    }
+
+    p_set->words[word_index] |= 1UL << (index % VERTEX_BITSET_WORD_BITS);
+}
+
+void vertex_bitset_clear(vertex_bitset* p_set)
+{
+    size_t i;
+
+    for (i = 0; i < p_set->touched_count; ++i)
+    {
+        p_set->words[p_set->touched_words[i]] = 0;
+    }
+
+    p_set->touched_count = 0;
+}
+
+void vertex_bitset_destroy(vertex_bitset* p_set)
+{
+    allocator_free(p_set->words);
+    allocator_free(p_set->touched_words);
+    vertex_bitset_init(p_set);
+}
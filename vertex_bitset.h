@@ -0,0 +1,43 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_VERTEX_BITSET_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_VERTEX_BITSET_H
+
+#include <limits.h>
+#include <stdlib.h>
+
+#define VERTEX_BITSET_WORD_BITS (sizeof(unsigned long) * CHAR_BIT)
+
+/*******************************************************************************
+* A set of dense vertex indices stored as one bit per index. Besides the bit   *
+* words, the set lists the words that have a bit set, so that clearing it      *
+* costs time proportional to the words a search touched rather than to the     *
+* capacity. The storage is allocated by the first reservation.                 *
+*******************************************************************************/
+typedef struct vertex_bitset {
+    unsigned long* words;
+    size_t*        touched_words; /* Indices of the words with a bit set. */
+    size_t         touched_count;
+    size_t         capacity;      /* Bits, a multiple of the word width. */
+} vertex_bitset;
+
+/* Tells whether 'index', which must be below the capacity, is in the set: */
+#define VERTEX_BITSET_CONTAINS(p_set, index)                           \
+    (((p_set)->words[(index) / VERTEX_BITSET_WORD_BITS] >>             \
+      ((index) % VERTEX_BITSET_WORD_BITS)) & 1UL)
+
+void vertex_bitset_init(vertex_bitset* p_set);
+
+/*******************************************************************************
+* Makes sure the set can hold the indices below 'capacity'. Keeps the indices  *
+* already in the set. Returns RETURN_STATUS_OK or RETURN_STATUS_NO_MEMORY.     *
+*******************************************************************************/
+int vertex_bitset_reserve(vertex_bitset* p_set, size_t capacity);
+
+/* Adds 'index', which must be below the capacity: */
+void vertex_bitset_add(vertex_bitset* p_set, size_t index);
+
+void vertex_bitset_clear(vertex_bitset* p_set);
+
+/* Releases the storage of the set, but not the set itself: */
+void vertex_bitset_destroy(vertex_bitset* p_set);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_VERTEX_BITSET_H */
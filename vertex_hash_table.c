@@ -0,0 +1,661 @@
+#include "vertex_hash_table.h"
+#include "util.h"
+#include <limits.h>
+#include <string.h>
+
+/* x86-64 always has SSE2, so the group tests need no CPU detection: */
+#if defined(__GNUC__) && defined(__SSE2__)
+#define VERTEX_HASH_TABLE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define GROUP_WIDTH VERTEX_HASH_TABLE_GROUP_WIDTH
+
+/* A full slot has the 7 hash bits in its control byte, so the high bit tells
+   the free slots apart: */
+#define CONTROL_EMPTY   0x80
+#define CONTROL_DELETED 0xFE
+#define CONTROL_FREE    0x80
+#define CONTROL_HASH    0x7F
+
+/* The constants of the Fibonacci hashing and of the MurmurHash3 finalizer,
+   for the width of 'unsigned long': */
+#if ULONG_MAX > 0xFFFFFFFFUL
+#define HASH_MULTIPLIER   0x9E3779B97F4A7C15UL
+#define HASH_FOLD_SHIFT   32
+#define FMIX_MULTIPLIER_1 0xFF51AFD7ED558CCDUL
+#define FMIX_MULTIPLIER_2 0xC4CEB9FE1A85EC53UL
+#define FMIX_SHIFT_1      33
+#define FMIX_SHIFT_2      33
+#define FMIX_SHIFT_3      33
+#else
+#define HASH_MULTIPLIER   0x9E3779B9UL
+#define HASH_FOLD_SHIFT   16
+#define FMIX_MULTIPLIER_1 0x85EBCA6BUL
+#define FMIX_MULTIPLIER_2 0xC2B2AE35UL
+#define FMIX_SHIFT_1      16
+#define FMIX_SHIFT_2      13
+#define FMIX_SHIFT_3      16
+#endif
+
+static const float MINIMUM_LOAD_FACTOR = 0.2f;
+static const float MAXIMUM_LOAD_FACTOR = 0.875f;
+
+static int default_hash_function = VERTEX_HASH_MULTIPLY_SHIFT;
+
+void vertex_hash_table_set_default_hash(int hash_function)
+{
+    switch (hash_function)
+    {
+        case VERTEX_HASH_MULTIPLY_SHIFT:
+        case VERTEX_HASH_FMIX64:
+            default_hash_function = hash_function;
+            break;
+
+        default:
+            abort();
+    }
+}
+
+static unsigned long hash_key(const vertex_hash_table* p_table,
+                              vertex_id_t key)
+{
+    unsigned long hash = (unsigned long) key;
+
+    if (p_table->hash_function == VERTEX_HASH_FMIX64)
+    {
+        hash ^= hash >> FMIX_SHIFT_1;
+        hash *= FMIX_MULTIPLIER_1;
+        hash ^= hash >> FMIX_SHIFT_2;
+        hash *= FMIX_MULTIPLIER_2;
+        return hash ^ (hash >> FMIX_SHIFT_3);
+    }
+
+    hash *= HASH_MULTIPLIER;
+    return hash ^ (hash >> HASH_FOLD_SHIFT);
+}
+
+static unsigned char control_byte(unsigned long hash)
+{
+    return (unsigned char)(hash & CONTROL_HASH);
+}
+
+static float fix_load_factor(float load_factor)
+{
+    if (load_factor < MINIMUM_LOAD_FACTOR)
+    {
+        return MINIMUM_LOAD_FACTOR;
+    }
+
+    return load_factor > MAXIMUM_LOAD_FACTOR ?
+           MAXIMUM_LOAD_FACTOR :
+           load_factor;
+}
+
+/* Rounds 'capacity' up to a power of two of at least one group: */
+static size_t fix_capacity(size_t capacity)
+{
+    size_t ret = GROUP_WIDTH;
+
+    while (ret < capacity)
+    {
+        ret <<= 1;
+    }
+
+    return ret;
+}
+
+/* Bit 'i' of the result is set if the control byte 'i' of 'group' is 'byte': */
+static unsigned int match_byte(const unsigned char* group, unsigned char byte)
+{
+#ifdef VERTEX_HASH_TABLE_SSE2
+    __m128i control = _mm_loadu_si128((const __m128i*) group);
+
+    return (unsigned int) _mm_movemask_epi8(
+            _mm_cmpeq_epi8(control, _mm_set1_epi8((char) byte)));
+#else
+    unsigned int mask = 0;
+    size_t i;
+
+    for (i = 0; i < GROUP_WIDTH; ++i)
+    {
+        if (group[i] == byte)
+        {
+            mask |= 1u << i;
+        }
+    }
+
+    return mask;
+#endif
+}
+
+/* Bit 'i' of the result is set if the slot 'i' of 'group' is empty or
+   deleted: */
+static unsigned int match_free(const unsigned char* group)
+{
+#ifdef VERTEX_HASH_TABLE_SSE2
+    return (unsigned int) _mm_movemask_epi8(
+            _mm_loadu_si128((const __m128i*) group));
+#else
+    unsigned int mask = 0;
+    size_t i;
+
+    for (i = 0; i < GROUP_WIDTH; ++i)
+    {
+        if (group[i] & CONTROL_FREE)
+        {
+            mask |= 1u << i;
+        }
+    }
+
+    return mask;
+#endif
+}
+
+static size_t lowest_bit(unsigned int mask)
+{
+#ifdef __GNUC__
+    return (size_t) __builtin_ctz(mask);
+#else
+    size_t i = 0;
+
+    while (!(mask & 1u))
+    {
+        mask >>= 1;
+        ++i;
+    }
+
+    return i;
+#endif
+}
+
+static size_t first_group(const vertex_hash_table* p_table, unsigned long hash)
+{
+    return (size_t)(hash >> 7) & (p_table->capacity / GROUP_WIDTH - 1);
+}
+
+/* Moves to the next group of the triangular probe sequence, which visits all
+   the groups since their number is a power of two: */
+static size_t next_group(const vertex_hash_table* p_table,
+                         size_t group_index,
+                         size_t step)
+{
+    return (group_index + step) & (p_table->capacity / GROUP_WIDTH - 1);
+}
+
+static size_t find_key_slot(const vertex_hash_table* p_table,
+                            vertex_id_t key,
+                            unsigned long hash)
+{
+    size_t group_index = first_group(p_table, hash);
+    size_t step = 0;
+    size_t slot;
+    const unsigned char* group;
+    unsigned int matches;
+
+    for (;;)
+    {
+        group = p_table->control + group_index * GROUP_WIDTH;
+        matches = match_byte(group, control_byte(hash));
+
+        while (matches)
+        {
+            slot = group_index * GROUP_WIDTH + lowest_bit(matches);
+
+            if (p_table->keys[slot] == key)
+            {
+                return slot;
+            }
+
+            matches &= matches - 1;
+        }
+
+        /* An insertion would have stopped at this group: */
+        if (match_byte(group, CONTROL_EMPTY))
+        {
+            return VERTEX_HASH_TABLE_NO_SLOT;
+        }
+
+        group_index = next_group(p_table, group_index, ++step);
+    }
+}
+
+/* Returns the first empty or deleted slot on the probe sequence of 'hash': */
+static size_t find_free_slot(const vertex_hash_table* p_table,
+                             unsigned long hash)
+{
+    size_t group_index = first_group(p_table, hash);
+    size_t step = 0;
+    unsigned int matches;
+
+    for (;;)
+    {
+        matches = match_free(p_table->control + group_index * GROUP_WIDTH);
+
+        if (matches)
+        {
+            return group_index * GROUP_WIDTH + lowest_bit(matches);
+        }
+
+        group_index = next_group(p_table, group_index, ++step);
+    }
+}
+
+static void* value_at(const vertex_hash_table* p_table, size_t slot)
+{
+    return (char*) p_table->values + slot * p_table->value_size;
+}
+
+/* The keys, the values and the control bytes share one block: */
+static size_t storage_size(size_t capacity, size_t value_size)
+{
+    return capacity * (sizeof(vertex_id_t) + value_size + 1);
+}
+
+static void set_max_allowed_size(vertex_hash_table* p_table)
+{
+    p_table->max_allowed_size =
+            (size_t)(p_table->capacity * p_table->load_factor);
+
+    p_table->growth_left = p_table->max_allowed_size - p_table->size;
+}
+
+/* Points the table at a fresh block of 'capacity' empty slots: */
+static int allocate_slots(vertex_hash_table* p_table, size_t capacity)
+{
+    char* p_block = graph_arena_malloc(p_table->p_arena,
+                                       storage_size(capacity,
+                                                    p_table->value_size));
+
+    if (!p_block)
+    {
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    p_table->keys = (vertex_id_t*) p_block;
+    p_table->values = p_block + capacity * sizeof(vertex_id_t);
+    p_table->control = (unsigned char*) p_table->values +
+                       capacity * p_table->value_size;
+
+    memset(p_table->control, CONTROL_EMPTY, capacity);
+    p_table->capacity = capacity;
+    set_max_allowed_size(p_table);
+    return RETURN_STATUS_OK;
+}
+
+static void free_slots(vertex_hash_table* p_table)
+{
+    graph_arena_free(p_table->p_arena,
+                     p_table->keys,
+                     storage_size(p_table->capacity, p_table->value_size));
+}
+
+void vertex_hash_table_init(vertex_hash_table* p_table,
+                            graph_arena* p_arena,
+                            size_t value_size,
+                            size_t initial_capacity,
+                            float load_factor)
+{
+    p_table->control = NULL;
+    p_table->keys = NULL;
+    p_table->values = NULL;
+    p_table->value_size = value_size;
+    p_table->capacity = fix_capacity(initial_capacity);
+    p_table->size = 0;
+    p_table->max_allowed_size = 0;
+    p_table->growth_left = 0;
+    p_table->load_factor = fix_load_factor(load_factor);
+    p_table->hash_function = default_hash_function;
+    p_table->p_arena = p_arena;
+}
+
+void vertex_hash_table_destroy(vertex_hash_table* p_table)
+{
+    if (p_table->control)
+    {
+        free_slots(p_table);
+    }
+
+    p_table->control = NULL;
+    p_table->keys = NULL;
+    p_table->values = NULL;
+    p_table->size = 0;
+}
+
+/* Moves all entries into a new block of 'new_capacity' slots: */
+static int resize(vertex_hash_table* p_table, size_t new_capacity)
+{
+    vertex_hash_table old_table = *p_table;
+    size_t slot;
+    size_t new_slot;
+    unsigned long hash;
+
+    if (allocate_slots(p_table, new_capacity) != RETURN_STATUS_OK)
+    {
+        *p_table = old_table;
+        return RETURN_STATUS_NO_MEMORY;
+    }
+
+    for (slot = 0; slot < old_table.capacity; ++slot)
+    {
+        if (old_table.control[slot] & CONTROL_FREE)
+        {
+            continue;
+        }
+
+        hash = hash_key(p_table, old_table.keys[slot]);
+        new_slot = find_free_slot(p_table, hash);
+        p_table->control[new_slot] = control_byte(hash);
+        p_table->keys[new_slot] = old_table.keys[slot];
+        memcpy(value_at(p_table, new_slot),
+               value_at(&old_table, slot),
+               p_table->value_size);
+    }
+
+    free_slots(&old_table);
+    return RETURN_STATUS_OK;
+}
+
+static void swap_slots(vertex_hash_table* p_table, size_t slot_1, size_t slot_2)
+{
+    vertex_id_t key = p_table->keys[slot_1];
+    unsigned char* p_value_1 = value_at(p_table, slot_1);
+    unsigned char* p_value_2 = value_at(p_table, slot_2);
+    unsigned char byte;
+    size_t i;
+
+    p_table->keys[slot_1] = p_table->keys[slot_2];
+    p_table->keys[slot_2] = key;
+
+    for (i = 0; i < p_table->value_size; ++i)
+    {
+        byte = p_value_1[i];
+        p_value_1[i] = p_value_2[i];
+        p_value_2[i] = byte;
+    }
+}
+
+/*******************************************************************************
+* Puts every entry back on the probe sequence of its current key and drops the *
+* deleted markers, without allocating. The entries still to be placed are      *
+* marked deleted; each one either stays in its group, moves to an empty slot,  *
+* or swaps with another unplaced entry, which is then placed in turn.          *
+*******************************************************************************/
+static void rehash_in_place(vertex_hash_table* p_table)
+{
+    size_t slot;
+    size_t target_slot;
+    unsigned long hash;
+
+    for (slot = 0; slot < p_table->capacity; ++slot)
+    {
+        p_table->control[slot] = (p_table->control[slot] & CONTROL_FREE) ?
+                                 CONTROL_EMPTY :
+                                 CONTROL_DELETED;
+    }
+
+    for (slot = 0; slot < p_table->capacity; ++slot)
+    {
+        while (p_table->control[slot] == CONTROL_DELETED)
+        {
+            hash = hash_key(p_table, p_table->keys[slot]);
+            target_slot = find_free_slot(p_table, hash);
+
+            if (target_slot / GROUP_WIDTH == slot / GROUP_WIDTH)
+            {
+                p_table->control[slot] = control_byte(hash);
+                break;
+            }
+
+            if (p_table->control[target_slot] == CONTROL_EMPTY)
+            {
+                p_table->keys[target_slot] = p_table->keys[slot];
+                memcpy(value_at(p_table, target_slot),
+                       value_at(p_table, slot),
+                       p_table->value_size);
+
+                p_table->control[target_slot] = control_byte(hash);
+                p_table->control[slot] = CONTROL_EMPTY;
+                break;
+            }
+
+            swap_slots(p_table, slot, target_slot);
+            p_table->control[target_slot] = control_byte(hash);
+        }
+    }
+
+    p_table->growth_left = p_table->max_allowed_size - p_table->size;
+}
+
+/* Called when no empty slot may be used anymore. Deleted markers are purged
+   in place if they take up at least half of the used slots: */
+static int make_room(vertex_hash_table* p_table)
+{
+    if (2 * p_table->size <= p_table->max_allowed_size)
+    {
+        rehash_in_place(p_table);
+        return RETURN_STATUS_OK;
+    }
+
+    return resize(p_table, 2 * p_table->capacity);
+}
+
+size_t vertex_hash_table_find(const vertex_hash_table* p_table,
+                              vertex_id_t key)
+{
+    if (!p_table->control)
+    {
+        return VERTEX_HASH_TABLE_NO_SLOT;
+    }
+
+    return find_key_slot(p_table, key, hash_key(p_table, key));
+}
+
+int vertex_hash_table_insert(vertex_hash_table* p_table,
+                             vertex_id_t key,
+                             size_t* p_slot)
+{
+    unsigned long hash = hash_key(p_table, key);
+    size_t slot;
+
+    if (!p_table->control)
+    {
+        if (allocate_slots(p_table, p_table->capacity) != RETURN_STATUS_OK)
+        {
+            return RETURN_STATUS_NO_MEMORY;
+        }
+    }
+    else
+    {
+        slot = find_key_slot(p_table, key, hash);
+
+        if (slot != VERTEX_HASH_TABLE_NO_SLOT)
+        {
+            *p_slot = slot;
+            return RETURN_STATUS_OK;
+        }
+    }
+
+    slot = find_free_slot(p_table, hash);
+
+    /* Reusing a deleted slot does not bring the table closer to full: */
+    if (p_table->control[slot] == CONTROL_EMPTY)
+    {
+        if (p_table->growth_left == 0)
+        {
+            if (make_room(p_table) != RETURN_STATUS_OK)
+            {
+                return RETURN_STATUS_NO_MEMORY;
+            }
+
+            slot = find_free_slot(p_table, hash);
+        }
+
+        if (p_table->control[slot] == CONTROL_EMPTY)
+        {
+            p_table->growth_left--;
+        }
+    }
+
+    p_table->control[slot] = control_byte(hash);
+    p_table->keys[slot] = key;
+    p_table->size++;
+    *p_slot = slot;
+    return RETURN_STATUS_OK;
+}
+
+void vertex_hash_table_remove_slot(vertex_hash_table* p_table, size_t slot)
+{
+    const unsigned char* group = p_table->control +
+                                 (slot - slot % GROUP_WIDTH);
+
+    /* No probe sequence runs past a group with an empty slot, so the slot
+       may become empty again; otherwise probes must still pass over it: */
+    if (match_byte(group, CONTROL_EMPTY))
+    {
+        p_table->control[slot] = CONTROL_EMPTY;
+        p_table->growth_left++;
+    }
+    else
+    {
+        p_table->control[slot] = CONTROL_DELETED;
+    }
+
+    p_table->size--;
+}
+
+int vertex_hash_table_remove(vertex_hash_table* p_table, vertex_id_t key)
+{
+    size_t slot = vertex_hash_table_find(p_table, key);
+
+    if (slot == VERTEX_HASH_TABLE_NO_SLOT)
+    {
+        return FALSE;
+    }
+
+    vertex_hash_table_remove_slot(p_table, slot);
+    return TRUE;
+}
+
+int vertex_hash_table_reserve(vertex_hash_table* p_table, size_t size)
+{
+    size_t new_capacity = p_table->capacity;
+
+    while ((size_t)(new_capacity * p_table->load_factor) < size)
+    {
+        new_capacity <<= 1;
+    }
+
+    if (!p_table->control)
+    {
+        return allocate_slots(p_table, new_capacity);
+    }
+
+    return new_capacity == p_table->capacity ?
+           RETURN_STATUS_OK :
+           resize(p_table, new_capacity);
+}
+
+void vertex_hash_table_clear(vertex_hash_table* p_table)
+{
+    p_table->size = 0;
+
+    if (p_table->control)
+    {
+        memset(p_table->control, CONTROL_EMPTY, p_table->capacity);
+        set_max_allowed_size(p_table);
+    }
+}
+
+void vertex_hash_table_remap_keys(vertex_hash_table* p_table,
+                                  const vertex_id_t* key_map)
+{
+    size_t slot;
+
+    if (!p_table->control)
+    {
+        return;
+    }
+
+    for (slot = 0; slot < p_table->capacity; ++slot)
+    {
+        if (!(p_table->control[slot] & CONTROL_FREE))
+        {
+            p_table->keys[slot] = key_map[p_table->keys[slot]];
+        }
+    }
+
+    rehash_in_place(p_table);
+}
+
+size_t vertex_hash_table_next_slot(const vertex_hash_table* p_table,
+                                   size_t slot)
+{
+    if (!p_table->control)
+    {
+        return p_table->capacity;
+    }
+
+    while (slot < p_table->capacity && (p_table->control[slot] & CONTROL_FREE))
+    {
+        ++slot;
+    }
+
+    return slot;
+}
+
+void vertex_hash_table_get_stats(const vertex_hash_table* p_table,
+                                 vertex_hash_table_stats* p_stats)
+{
+    size_t slot;
+    size_t group_index;
+    size_t step;
+    size_t total_probe_length = 0;
+
+    p_stats->size = p_table->size;
+    p_stats->capacity = p_table->control ? p_table->capacity : 0;
+    p_stats->deleted_count = 0;
+    p_stats->max_probe_length = 0;
+    p_stats->mean_probe_length = 0.0;
+
+    if (!p_table->control)
+    {
+        return;
+    }
+
+    for (slot = 0; slot < p_table->capacity; ++slot)
+    {
+        if (p_table->control[slot] == CONTROL_DELETED)
+        {
+            p_stats->deleted_count++;
+            continue;
+        }
+
+        if (p_table->control[slot] & CONTROL_FREE)
+        {
+            continue;
+        }
+
+        /* Walk the probe sequence of the key up to the group of its slot: */
+        group_index = first_group(p_table,
+                                  hash_key(p_table, p_table->keys[slot]));
+
+        for (step = 1; group_index != slot / GROUP_WIDTH; ++step)
+        {
+            group_index = next_group(p_table, group_index, step);
+        }
+
+        total_probe_length += step;
+
+        if (p_stats->max_probe_length < step)
+        {
+            p_stats->max_probe_length = step;
+        }
+    }
+
+    if (p_table->size > 0)
+    {
+        p_stats->mean_probe_length =
+                (double) total_probe_length / p_table->size;
+    }
+}
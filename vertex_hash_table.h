@@ -0,0 +1,132 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_VERTEX_HASH_TABLE_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_VERTEX_HASH_TABLE_H
+
+#include "graph_arena.h"
+#include "types.h"
+#include <stdlib.h>
+
+/*******************************************************************************
+* An open-addressing hash table from vertex IDs to values of 'value_size'      *
+* bytes, shared by all the maps and sets of the library. Each one keeps the    *
+* keys and the values in two flat arrays and casts 'values' to its own value   *
+* type, so that an entry costs its key, its value and one control byte,        *
+* instead of a chained node with three pointers.                               *
+*                                                                              *
+* The slots are probed in aligned groups of VERTEX_HASH_TABLE_GROUP_WIDTH. A   *
+* control byte holds 7 bits of the hash of the key in its slot, or marks the   *
+* slot as empty or deleted, so a lookup compares the keys only in the slots    *
+* whose control byte matches, and tests a whole group at once with SSE2 when   *
+* available. The iteration order is the slot order, not the insertion order.   *
+*                                                                              *
+* The slot storage is allocated on the first insertion or reservation, from    *
+* 'p_arena', or from the heap if 'p_arena' is NULL.                            *
+*******************************************************************************/
+#define VERTEX_HASH_TABLE_GROUP_WIDTH 16
+
+/*******************************************************************************
+* The hash functions a table may spread its keys with:                         *
+*   VERTEX_HASH_MULTIPLY_SHIFT - multiplies by the golden ratio and folds the  *
+*                                high half into the low one. One multiply;     *
+*                                the default.                                  *
+*   VERTEX_HASH_FMIX64         - the MurmurHash3 finalizer, which mixes every  *
+*                                bit of the key into every bit of the hash.    *
+*                                Slower, but robust against IDs that share     *
+*                                their low bits or follow a large stride.      *
+*******************************************************************************/
+#define VERTEX_HASH_MULTIPLY_SHIFT 0
+#define VERTEX_HASH_FMIX64         1
+
+/* Returned instead of a slot for absent keys: */
+#define VERTEX_HASH_TABLE_NO_SLOT ((size_t) -1)
+
+typedef struct vertex_hash_table {
+    unsigned char* control;
+    vertex_id_t*   keys;
+    void*          values;
+    size_t         value_size;
+    size_t         capacity;         /* Slots, a power of two. */
+    size_t         size;
+    size_t         max_allowed_size;
+    size_t         growth_left;      /* Empty slots that may still be used. */
+    float          load_factor;
+    int            hash_function;
+    graph_arena*   p_arena;
+} vertex_hash_table;
+
+/*******************************************************************************
+* How well a table spreads its keys. The probe length of an entry is the       *
+* number of slot groups a lookup of its key visits, 1 if the entry is in the   *
+* first group of its probe sequence. Long probes mean that many keys share     *
+* their hash bits, which usually calls for VERTEX_HASH_FMIX64.                 *
+*******************************************************************************/
+typedef struct vertex_hash_table_stats {
+    size_t size;
+    size_t capacity;
+    size_t deleted_count;
+    size_t max_probe_length;
+    double mean_probe_length;
+} vertex_hash_table_stats;
+
+/*******************************************************************************
+* Sets the hash function of the tables set up from now on, including those     *
+* inside graphs and search structures. Existing tables keep the function they  *
+* were set up with. The setting is global and not synchronized.                *
+*******************************************************************************/
+void vertex_hash_table_set_default_hash(int hash_function);
+
+/*******************************************************************************
+* Sets up an empty table. 'initial_capacity' is the number of slots allocated  *
+* on the first insertion. The load factor is clamped to [0.2, 0.875], so that  *
+* the probes always reach an empty slot.                                       *
+*******************************************************************************/
+void vertex_hash_table_init(vertex_hash_table* p_table,
+                            graph_arena* p_arena,
+                            size_t value_size,
+                            size_t initial_capacity,
+                            float load_factor);
+
+/* Releases the slot storage of the table, but not the table itself: */
+void vertex_hash_table_destroy(vertex_hash_table* p_table);
+
+size_t vertex_hash_table_find(const vertex_hash_table* p_table,
+                              vertex_id_t key);
+
+/*******************************************************************************
+* Stores the slot of 'key' in '*p_slot', adding the key first if it is absent. *
+* The value of a new slot is left for the caller to write. Returns             *
+* RETURN_STATUS_OK or RETURN_STATUS_NO_MEMORY.                                 *
+*******************************************************************************/
+int vertex_hash_table_insert(vertex_hash_table* p_table,
+                             vertex_id_t key,
+                             size_t* p_slot);
+
+/* Removes the entry in 'slot', leaving the other slots where they are: */
+void vertex_hash_table_remove_slot(vertex_hash_table* p_table, size_t slot);
+
+/* Removes 'key' and returns TRUE if it was present: */
+int vertex_hash_table_remove(vertex_hash_table* p_table, vertex_id_t key);
+
+/* Allocates or grows the slots once so that they hold 'size' entries: */
+int vertex_hash_table_reserve(vertex_hash_table* p_table, size_t size);
+
+void vertex_hash_table_clear(vertex_hash_table* p_table);
+
+/*******************************************************************************
+* Replaces each key 'k' with 'key_map[k]' and rehashes the entries in place.   *
+* 'key_map' must not map two present keys to the same new key.                 *
+*******************************************************************************/
+void vertex_hash_table_remap_keys(vertex_hash_table* p_table,
+                                  const vertex_id_t* key_map);
+
+/*******************************************************************************
+* Returns the first occupied slot at or after 'slot', or the capacity if there *
+* is none. Iterating from slot 0 visits every entry once, and removing the     *
+* entry in the current slot does not disturb the iteration.                    *
+*******************************************************************************/
+size_t vertex_hash_table_next_slot(const vertex_hash_table* p_table,
+                                   size_t slot);
+
+void vertex_hash_table_get_stats(const vertex_hash_table* p_table,
+                                 vertex_hash_table_stats* p_stats);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_VERTEX_HASH_TABLE_H */
@@ -1,318 +1,332 @@
 #include "weight_map.h"
+#include "allocator.h"
 #include "util.h"
 #include <stdlib.h>
 
-static weight_map_entry*
-weight_map_entry_alloc(size_t vertex_id,
-                       double weight)
+weight_map* weight_map_alloc(
+        size_t initial_capacity,
+        float load_factor)
+{
+    return weight_map_alloc_in_arena(NULL, initial_capacity, load_factor);
+}
+
+weight_map* weight_map_alloc_in_arena(graph_arena* p_arena,
+                                      size_t initial_capacity,
+                                      float load_factor)
 {
-    weight_map_entry* entry = malloc(sizeof(*entry));
+    weight_map* map = graph_arena_malloc(p_arena, sizeof(*map));
 
-    if (!entry)
+    if (!map)
     {
         return NULL;
     }
 
-    entry->vertex_id = vertex_id;
-    entry->weight = weight;
-    entry->chain_next = NULL;
-    entry->next = NULL;
-    entry->prev = NULL;
+    /* The hash table is allocated only when the map outgrows the array
+       mode. Until then, 'initial_capacity' is kept as the table size hint: */
+    vertex_hash_table_init(&map->table,
+                           p_arena,
+                           sizeof(weight_t),
+                           initial_capacity,
+                           load_factor);
+    map->pairs = NULL;
+    map->pair_count = 0;
+    map->pairs_capacity = 0;
 
-    return entry;
+    return map;
 }
 
-static const float  MINIMUM_LOAD_FACTOR = 0.2f;
-static const size_t MINIMUM_INITIAL_CAPACITY = 16;
-
-static float maxf(float a, float b)
+static int is_array_mode(weight_map* map)
 {
-    return a < b ? b : a;
+    return map->table.control == NULL;
 }
 
-static int maxi(int a, int b)
+static weight_t* table_weights(weight_map* map)
 {
-    return a < b ? b : a;
+    return (weight_t*) map->table.values;
 }
 
-/*******************************************************************************
-* Makes sure that the load factor is no less than a minimum threshold.         *
-*******************************************************************************/
-static float fix_load_factor(float load_factor)
+static size_t find_pair_index(weight_map* map, vertex_id_t vertex_id)
 {
-    return maxf(load_factor, MINIMUM_LOAD_FACTOR);
+    size_t i;
+
+    for (i = 0; i < map->pair_count; ++i)
+    {
+        if (map->pairs[i].vertex_id == vertex_id)
+        {
+            return i;
+        }
+    }
+
+    return (size_t) -1;
 }
 
-/*******************************************************************************
-* Makes sure that the initial capacity is no less than a minimum allowed and   *
-* is a power of two.                                                           *
-*******************************************************************************/
-static size_t fix_initial_capacity(size_t initial_capacity)
+static void remove_pair_at(weight_map* map, size_t pair_index)
 {
-    size_t ret;
+    size_t i;
 
-    initial_capacity = maxi(initial_capacity, MINIMUM_INITIAL_CAPACITY);
-    ret = 1;
-
-    while (ret < initial_capacity)
+    /* Shift the tail of the array in order to keep the insertion order: */
+    for (i = pair_index + 1; i < map->pair_count; ++i)
     {
-        ret <<= 1;
+        map->pairs[i - 1] = map->pairs[i];
     }
 
-    return ret;
+    map->pair_count--;
 }
 
-weight_map* weight_map_alloc(
-        size_t initial_capacity,
-        float load_factor)
+/*******************************************************************************
+* Moves all pairs from the array into a freshly allocated hash table with room *
+* for 'size' entries.                                                          *
+*******************************************************************************/
+static int upgrade_to_hash_table(weight_map* map, size_t size)
 {
-    weight_map* map = malloc(sizeof(*map));
+    size_t i;
+    size_t slot;
 
-    if (!map)
+    if (vertex_hash_table_reserve(&map->table, size) != RETURN_STATUS_OK)
     {
-        return NULL;
+        return RETURN_STATUS_NO_MEMORY;
     }
 
-    load_factor = fix_load_factor(load_factor);
-    initial_capacity = fix_initial_capacity(initial_capacity);
-
-    map->load_factor = load_factor;
-    map->table_capacity = initial_capacity;
-    map->size = 0;
-    map->head = NULL;
-    map->tail = NULL;
-    map->table = calloc(initial_capacity,
-                        sizeof(weight_map_entry*));
+    for (i = 0; i < map->pair_count; ++i)
+    {
+        if (vertex_hash_table_insert(&map->table,
+                                     map->pairs[i].vertex_id,
+                                     &slot) != RETURN_STATUS_OK)
+        {
+            /* Roll back to the array mode: */
+            vertex_hash_table_destroy(&map->table);
+            return RETURN_STATUS_NO_MEMORY;
+        }
 
-    map->mask = initial_capacity - 1;
-    map->max_allowed_size = (size_t)(initial_capacity * load_factor);
+        table_weights(map)[slot] = map->pairs[i].weight;
+    }
 
-    return map;
+    graph_arena_free(map->table.p_arena,
+                     map->pairs,
+                     sizeof(weight_map_pair) * map->pairs_capacity);
+    map->pairs = NULL;
+    map->pair_count = 0;
+    map->pairs_capacity = 0;
+    return RETURN_STATUS_OK;
 }
 
-static int ensure_capacity(weight_map* map)
+static int array_mode_put(weight_map* map,
+                          vertex_id_t vertex_id,
+                          weight_t weight)
 {
+    size_t pair_index = find_pair_index(map, vertex_id);
     size_t new_capacity;
-    size_t new_mask;
-    size_t index;
-    weight_map_entry* entry;
-    weight_map_entry** new_table;
+    weight_map_pair* new_pairs;
 
-    if (map->size < map->max_allowed_size)
+    if (pair_index != (size_t) -1)
     {
+        map->pairs[pair_index].weight = weight;
         return RETURN_STATUS_OK;
     }
 
-    new_capacity = 2 * map->table_capacity;
-    new_mask = new_capacity - 1;
-    new_table = calloc(new_capacity, sizeof(weight_map_entry*));
-
-    if (!new_table)
+    if (map->pair_count == WEIGHT_MAP_ARRAY_THRESHOLD)
     {
-        return RETURN_STATUS_NO_MAP;
+        return upgrade_to_hash_table(map, 2 * map->pair_count + 1) ==
+               RETURN_STATUS_OK ?
+               weight_map_put(map, vertex_id, weight) :
+               RETURN_STATUS_NO_MEMORY;
     }
 
-    /* Rehash the entries. */
-    for (entry = map->head; entry; entry = entry->next)
+    if (map->pair_count == map->pairs_capacity)
     {
-        index = entry->vertex_id & new_mask;
-        entry->chain_next = new_table[index];
-        new_table[index] = entry;
-    }
+        new_capacity = map->pairs_capacity ? 2 * map->pairs_capacity : 2;
+        new_pairs = graph_arena_realloc(
+                map->table.p_arena,
+                map->pairs,
+                sizeof(weight_map_pair) * map->pairs_capacity,
+                sizeof(weight_map_pair) * new_capacity);
+
+        if (!new_pairs)
+        {
+            return RETURN_STATUS_NO_MEMORY;
+        }
 
-    free(map->table);
+        map->pairs = new_pairs;
+        map->pairs_capacity = new_capacity;
+    }
 
-    map->table = new_table;
-    map->table_capacity = new_capacity;
-    map->mask = new_mask;
-    map->max_allowed_size = (size_t)(new_capacity * map->load_factor);
+    map->pairs[map->pair_count].vertex_id = vertex_id;
+    map->pairs[map->pair_count].weight = weight;
+    map->pair_count++;
     return RETURN_STATUS_OK;
 }
 
-int weight_map_put(weight_map* map, size_t vertex_id, double weight)
+/*******************************************************************************
+* Makes room for 'size' pairs in total, so that adding up to that many does    *
+* not reallocate. A map reserved past WEIGHT_MAP_ARRAY_THRESHOLD pairs skips   *
+* the array mode and builds its hash table at the final size right away.       *
+*******************************************************************************/
+int weight_map_reserve(weight_map* map, size_t size)
 {
-    size_t index;
-    size_t hash_value;
-    weight_map_entry* entry;
+    weight_map_pair* new_pairs;
 
     if (!map)
     {
         return RETURN_STATUS_NO_MAP;
     }
 
-    hash_value = vertex_id;
-    index = hash_value & map->mask;
-
-    for (entry = map->table[index]; entry; entry = entry->chain_next)
+    if (is_array_mode(map) && size <= WEIGHT_MAP_ARRAY_THRESHOLD)
     {
-        if (entry->vertex_id == vertex_id)
+        if (size <= map->pairs_capacity)
         {
-            entry->weight = weight;
             return RETURN_STATUS_OK;
         }
+
+        new_pairs = graph_arena_realloc(
+                map->table.p_arena,
+                map->pairs,
+                sizeof(weight_map_pair) * map->pairs_capacity,
+                sizeof(weight_map_pair) * size);
+
+        if (!new_pairs)
+        {
+            return RETURN_STATUS_NO_MEMORY;
+        }
+
+        map->pairs = new_pairs;
+        map->pairs_capacity = size;
+        return RETURN_STATUS_OK;
     }
 
-    if (ensure_capacity(map) != RETURN_STATUS_OK) {
-        return RETURN_STATUS_NO_MEMORY;
+    if (is_array_mode(map))
+    {
+        return upgrade_to_hash_table(map, size);
     }
 
-    /* Recompute the index since it is possibly changed by 'ensure_capacity' */
-    index = hash_value & map->mask;
-    entry = weight_map_entry_alloc(vertex_id, weight);
+    return vertex_hash_table_reserve(&map->table, size);
+}
 
-    if (!entry) {
-        return RETURN_STATUS_NO_MEMORY;
-    }
+int weight_map_put(weight_map* map, vertex_id_t vertex_id, weight_t weight)
+{
+    size_t slot;
 
-    entry->chain_next = map->table[index];
-    map->table[index] = entry;
+    if (!map)
+    {
+        return RETURN_STATUS_NO_MAP;
+    }
 
-    /* Link the new entry to the tail of the list. */
-    if (!map->tail)
+    if (is_array_mode(map))
     {
-        map->head = entry;
-        map->tail = entry;
+        return array_mode_put(map, vertex_id, weight);
     }
-    else
+
+    if (vertex_hash_table_insert(&map->table,
+                                 vertex_id,
+                                 &slot) != RETURN_STATUS_OK)
     {
-        map->tail->next = entry;
-        entry->prev = map->tail;
-        map->tail = entry;
+        return RETURN_STATUS_NO_MEMORY;
     }
 
-    map->size++;
+    table_weights(map)[slot] = weight;
     return RETURN_STATUS_OK;
 }
 
-int weight_map_contains_key(weight_map* map, size_t vertex_id)
+int weight_map_contains_key(weight_map* map, vertex_id_t vertex_id)
 {
-    size_t index;
-    weight_map_entry* entry;
-
     if (!map)
     {
         return 0;
     }
 
-    index = vertex_id & map->mask;
-
-    for (entry = map->table[index]; entry; entry = entry->chain_next)
+    if (is_array_mode(map))
     {
-        if (entry->vertex_id == vertex_id)
-        {
-            return 1;
-        }
+        return find_pair_index(map, vertex_id) != (size_t) -1;
     }
 
-    return 0;
+    return vertex_hash_table_find(&map->table, vertex_id) !=
+           VERTEX_HASH_TABLE_NO_SLOT;
 }
 
-double weight_map_get(weight_map* map, size_t vertex_id)
+weight_t weight_map_get(weight_map* map, vertex_id_t vertex_id)
 {
     size_t index;
-    weight_map_entry* p_entry;
 
     if (!map)
     {
         abort();
     }
 
-    index = vertex_id & map->mask;
-
-    for (p_entry = map->table[index]; p_entry; p_entry = p_entry->chain_next)
+    if (is_array_mode(map))
     {
-        if (p_entry->vertex_id == vertex_id)
+        index = find_pair_index(map, vertex_id);
+
+        if (index == (size_t) -1)
         {
-            return p_entry->weight;
+            abort();
         }
+
+        return map->pairs[index].weight;
+    }
+
+    index = vertex_hash_table_find(&map->table, vertex_id);
+
+    if (index == VERTEX_HASH_TABLE_NO_SLOT)
+    {
+        abort();
     }
 
-    abort();
-    return -1.0;
+    return table_weights(map)[index];
 }
 
-void weight_map_remove(weight_map* map, size_t vertex_id)
+void weight_map_remove(weight_map* map, vertex_id_t vertex_id)
 {
     size_t index;
-    weight_map_entry* prev_entry;
-    weight_map_entry* current_entry;
 
     if (!map)
     {
         return;
     }
 
-    index = vertex_id & map->mask;
-    prev_entry = NULL;
-
-    for (current_entry = map->table[index];
-         current_entry;
-         current_entry = current_entry->chain_next)
-    {
-        if (current_entry->vertex_id == vertex_id) {
-            if (prev_entry)
-            {
-                /* Omit the 'p_current_entry' in the collision chain. */
-                prev_entry->chain_next = current_entry->chain_next;
-            }
-            else
-            {
-                map->table[index] = current_entry->chain_next;
-            }
-
-            /* Unlink from the global iteration chain. */
-            if (current_entry->prev)
-            {
-                current_entry->prev->next = current_entry->next;
-            }
-            else
-            {
-                map->head = current_entry->next;
-            }
-
-            if (current_entry->next)
-            {
-                current_entry->next->prev = current_entry->prev;
-            }
-            else
-            {
-                map->tail = current_entry->prev;
-            }
-
-            map->size--;
-            free(current_entry);
-            return;
+    if (is_array_mode(map))
+    {
+        index = find_pair_index(map, vertex_id);
+
+        if (index != (size_t) -1)
+        {
+            remove_pair_at(map, index);
         }
 
-        prev_entry = current_entry;
+        return;
     }
+
+    vertex_hash_table_remove(&map->table, vertex_id);
 }
 
 void weight_map_clear(weight_map* map)
 {
-    weight_map_entry* entry;
-    weight_map_entry* next_entry;
-    size_t index;
+    map->pair_count = 0;
+    vertex_hash_table_clear(&map->table);
+}
 
-    entry = map->head;
+/*******************************************************************************
+* Replaces each key 'k' with 'key_map[k]'. 'key_map' must not map two present  *
+* keys to the same new key.                                                    *
+*******************************************************************************/
+void weight_map_remap_keys(weight_map* map, const vertex_id_t* key_map)
+{
+    size_t i;
 
-    while (entry)
+    if (is_array_mode(map))
     {
-        index = entry->vertex_id & map->mask;
-        next_entry = entry->next;
-        free(entry);
-        entry = next_entry;
-        map->table[index] = NULL;
+        for (i = 0; i < map->pair_count; ++i)
+        {
+            map->pairs[i].vertex_id = key_map[map->pairs[i].vertex_id];
+        }
+
+        return;
     }
 
-    map->size = 0;
-    map->head = NULL;
-    map->tail = NULL;
+    vertex_hash_table_remap_keys(&map->table, key_map);
 }
 
 size_t weight_map_size(weight_map* map)
 {
-    return map->size;
+    return is_array_mode(map) ? map->pair_count : map->table.size;
 }
 
 void weight_map_free(weight_map* map)
@@ -322,9 +336,21 @@ void weight_map_free(weight_map* map)
         return;
     }
 
-    weight_map_clear(map);
-    free(map->table);
-    free(map);
+    graph_arena_free(map->table.p_arena,
+                     map->pairs,
+                     sizeof(weight_map_pair) * map->pairs_capacity);
+
+    vertex_hash_table_destroy(&map->table);
+    graph_arena_free(map->table.p_arena, map, sizeof(*map));
+}
+
+void weight_map_iterator_init(weight_map_iterator* p_iterator,
+                              weight_map* map)
+{
+    p_iterator->map = map;
+    p_iterator->index = is_array_mode(map) ?
+                        0 :
+                        vertex_hash_table_next_slot(&map->table, 0);
 }
 
 weight_map_iterator*
@@ -337,27 +363,43 @@ weight_map_iterator_alloc(weight_map* map)
         return NULL;
     }
 
-    p_ret = malloc(sizeof(*p_ret));
+    p_ret = allocator_malloc(sizeof(*p_ret));
 
     if (!p_ret)
     {
         return NULL;
     }
 
-    p_ret->map = map;
-    p_ret->entry = map->head;
-
+    weight_map_iterator_init(p_ret, map);
     return p_ret;
 }
 
 int weight_map_iterator_has_next(weight_map_iterator* iterator)
 {
-    return iterator && iterator->entry;
+    if (!iterator)
+    {
+        return FALSE;
+    }
+
+    if (is_array_mode(iterator->map))
+    {
+        return iterator->index < iterator->map->pair_count;
+    }
+
+    return iterator->index < iterator->map->table.capacity;
 }
 
 void weight_map_iterator_next(weight_map_iterator* iterator)
 {
-    iterator->entry = iterator->entry->next;
+    if (is_array_mode(iterator->map))
+    {
+        iterator->index++;
+    }
+    else
+    {
+        iterator->index = vertex_hash_table_next_slot(&iterator->map->table,
+                                                      iterator->index + 1);
+    }
 }
 
 void weight_map_iterator_free(weight_map_iterator* iterator)
@@ -368,23 +410,35 @@ void weight_map_iterator_free(weight_map_iterator* iterator)
     }
 
     iterator->map = NULL;
-    iterator->entry = NULL;
-    free(iterator);
+    allocator_free(iterator);
 }
 
 void weight_map_iterator_visit(weight_map_iterator* p_iterator,
-                               size_t* p_vertex_id,
-                               double* p_weight) {
-    *p_vertex_id = p_iterator->entry->vertex_id;
-    *p_weight = p_iterator->entry->weight;
+                               vertex_id_t* p_vertex_id,
+                               weight_t* p_weight) {
+    weight_map* map = p_iterator->map;
+
+    if (is_array_mode(map))
+    {
+        *p_vertex_id = map->pairs[p_iterator->index].vertex_id;
+        *p_weight = map->pairs[p_iterator->index].weight;
+        return;
+    }
+
+    *p_vertex_id = map->table.keys[p_iterator->index];
+    *p_weight = table_weights(map)[p_iterator->index];
 }
 
 void weight_map_iterator_remove(
         weight_map_iterator* p_iterator) {
-    weight_map_entry* p_next_entry = p_iterator->entry->next;
-
-    weight_map_remove(p_iterator->map,
-                      p_iterator->entry->vertex_id);
+    if (is_array_mode(p_iterator->map))
+    {
+        /* The next pair is shifted into the current position: */
+        remove_pair_at(p_iterator->map, p_iterator->index);
+        return;
+    }
 
-    p_iterator->entry = p_next_entry;
+    /* The other entries stay in their slots: */
+    vertex_hash_table_remove_slot(&p_iterator->map->table, p_iterator->index);
+    weight_map_iterator_next(p_iterator);
 }
\ No newline at end of file
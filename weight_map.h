@@ -1,47 +1,74 @@
 #ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_WEIGHT_MAP_H
 #define COM_GITHUB_CODERODDE_BIDIR_SEARCH_WEIGHT_MAP_H
 
+#include "graph_arena.h"
+#include "types.h"
+#include "vertex_hash_table.h"
 #include <stdlib.h>
 
-typedef struct weight_map_entry {
-    size_t            vertex_id;
-    double            weight;
-    struct weight_map_entry* chain_next;
-    struct weight_map_entry* prev;
-    struct weight_map_entry* next;
-} weight_map_entry;
+typedef struct weight_map_pair {
+    vertex_id_t vertex_id;
+    weight_t    weight;
+} weight_map_pair;
+
+/*******************************************************************************
+* A weight map starts as a small array of pairs that is scanned linearly. Once *
+* it grows past WEIGHT_MAP_ARRAY_THRESHOLD pairs, it upgrades to a hash table, *
+* whose values are the weights. 'table.control' is NULL for as long as the map *
+* is in array mode.                                                            *
+*******************************************************************************/
+#define WEIGHT_MAP_ARRAY_THRESHOLD 16
 
 typedef struct weight_map {
-    weight_map_entry** table;
-    weight_map_entry* head;
-    weight_map_entry* tail;
-    size_t            table_capacity;
-    size_t            size;
-    size_t            max_allowed_size;
-    size_t            mask;
-    float             load_factor;
+    weight_map_pair*  pairs;
+    size_t            pair_count;
+    size_t            pairs_capacity;
+    vertex_hash_table table; /* Its arena is the arena of the map. */
 } weight_map;
 
+/* 'index' is a pair index in array mode and a table slot otherwise: */
 typedef struct weight_map_iterator {
-    weight_map*       map;
-    weight_map_entry* entry;
+    weight_map* map;
+    size_t      index;
 } weight_map_iterator;
 
 weight_map* weight_map_alloc(size_t initial_capacity,
                              float load_factor);
 
-int weight_map_put(weight_map* map, size_t vertex_id, double weight);
+/*******************************************************************************
+* Allocates a map whose storage, including the map itself, comes from          *
+* 'p_arena'. Destroying the arena frees the map without 'weight_map_free'.     *
+*******************************************************************************/
+weight_map* weight_map_alloc_in_arena(graph_arena* p_arena,
+                                      size_t initial_capacity,
+                                      float load_factor);
+
+int weight_map_put(weight_map* map, vertex_id_t vertex_id, weight_t weight);
+
+int weight_map_reserve(weight_map* map, size_t size);
+
+int weight_map_contains_key(weight_map* map, vertex_id_t vertex_id);
 
-int weight_map_contains_key(weight_map* map, size_t vertex_id);
+weight_t weight_map_get(weight_map* map, vertex_id_t vertex_id);
 
-double weight_map_get(weight_map* map, size_t vertex_id);
+void weight_map_remove(weight_map* map, vertex_id_t vertex_id);
 
-void weight_map_remove(weight_map* map, size_t vertex_id);
+size_t weight_map_size(weight_map* map);
 
 void weight_map_clear(weight_map* map);
 
+void weight_map_remap_keys(weight_map* map, const vertex_id_t* key_map);
+
 void weight_map_free(weight_map* map);
 
+/*******************************************************************************
+* Sets up a caller-owned iterator, typically one on the stack, over 'map'.     *
+* Unlike 'weight_map_iterator_alloc', this does not touch the heap, so it is   *
+* the one to use in hot loops. Such an iterator needs no freeing.              *
+*******************************************************************************/
+void weight_map_iterator_init(weight_map_iterator* p_iterator,
+                              weight_map* map);
+
 weight_map_iterator* weight_map_iterator_alloc
         (weight_map* map);
 
@@ -51,9 +78,11 @@ int weight_map_iterator_has_next
 void weight_map_iterator_next(weight_map_iterator* iterator);
 
 void weight_map_iterator_visit(weight_map_iterator* p_iterator,
-                               size_t* p_vertex_id,
-                               double* p_weight);
+                               vertex_id_t* p_vertex_id,
+                               weight_t* p_weight);
 
 void weight_map_iterator_remove(weight_map_iterator* p_iterator);
 
+void weight_map_iterator_free(weight_map_iterator* p_iterator);
+
 #endif	/* COM_GITHUB_CODERODDE_BIDIR_SEARCH_WEIGHT_MAP_H */
\ No newline at end of file
@@ -0,0 +1,237 @@
+/* POSIX threads are not ANSI C; request them before any system header: */
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200112L
+#define WORKER_POOL_PTHREADS
+#endif
+
+#include "worker_pool.h"
+#include "allocator.h"
+#include <stdlib.h>
+
+#ifdef WORKER_POOL_PTHREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#ifdef WORKER_POOL_PTHREADS
+typedef struct worker_thread {
+    struct worker_pool* p_pool;
+    size_t              worker_index;
+    pthread_t           thread;
+} worker_thread;
+#endif
+
+struct worker_pool {
+    size_t worker_count;
+#ifdef WORKER_POOL_PTHREADS
+    worker_thread*   threads;       /* Workers 1..worker_count - 1. */
+    pthread_mutex_t  mutex;
+    pthread_cond_t   task_posted;
+    pthread_cond_t   task_finished;
+    size_t           task_number;   /* Counts the posted tasks. */
+    size_t           busy_count;    /* Threads still running the task. */
+    int              shutting_down;
+    worker_pool_task task;
+    void*            p_argument;
+#endif
+};
+
+#ifdef WORKER_POOL_PTHREADS
+static size_t get_processor_count()
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    long processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (processor_count > 0)
+    {
+        return (size_t) processor_count;
+    }
+#endif
+    return 1;
+}
+
+/*******************************************************************************
+* The loop of a worker thread. A thread runs each posted task once: a new task *
+* is posted only after every thread has finished the previous one, so          *
+* 'task_number' never moves by more than one while a thread is busy.           *
+*******************************************************************************/
+static void* run_worker(void* p_argument)
+{
+    worker_thread* p_thread = p_argument;
+    worker_pool* p_pool = p_thread->p_pool;
+    size_t task_number = 0;
+    worker_pool_task task;
+    void* p_task_argument;
+
+    pthread_mutex_lock(&p_pool->mutex);
+
+    for (;;)
+    {
+        while (p_pool->task_number == task_number && !p_pool->shutting_down)
+        {
+            pthread_cond_wait(&p_pool->task_posted, &p_pool->mutex);
+        }
+
+        if (p_pool->shutting_down)
+        {
+            break;
+        }
+
+        task_number = p_pool->task_number;
+        task = p_pool->task;
+        p_task_argument = p_pool->p_argument;
+        pthread_mutex_unlock(&p_pool->mutex);
+
+        task(p_task_argument, p_thread->worker_index, p_pool->worker_count);
+
+        pthread_mutex_lock(&p_pool->mutex);
+
+        if (--p_pool->busy_count == 0)
+        {
+            pthread_cond_signal(&p_pool->task_finished);
+        }
+    }
+
+    pthread_mutex_unlock(&p_pool->mutex);
+    return NULL;
+}
+
+static void stop_threads(worker_pool* p_pool, size_t thread_count)
+{
+    size_t i;
+
+    pthread_mutex_lock(&p_pool->mutex);
+    p_pool->shutting_down = 1;
+    pthread_cond_broadcast(&p_pool->task_posted);
+    pthread_mutex_unlock(&p_pool->mutex);
+
+    for (i = 0; i < thread_count; ++i)
+    {
+        pthread_join(p_pool->threads[i].thread, NULL);
+    }
+}
+#endif
+
+worker_pool* worker_pool_alloc(size_t worker_count)
+{
+    worker_pool* p_pool = allocator_malloc(sizeof(*p_pool));
+#ifdef WORKER_POOL_PTHREADS
+    size_t i;
+#endif
+
+    if (!p_pool)
+    {
+        return NULL;
+    }
+
+    p_pool->worker_count = 1;
+
+#ifdef WORKER_POOL_PTHREADS
+    if (worker_count == 0)
+    {
+        worker_count = get_processor_count();
+    }
+
+    p_pool->threads = NULL;
+    p_pool->task_number = 0;
+    p_pool->busy_count = 0;
+    p_pool->shutting_down = 0;
+    p_pool->task = NULL;
+    p_pool->p_argument = NULL;
+
+    if (worker_count == 1)
+    {
+        return p_pool;
+    }
+
+    p_pool->threads =
+            allocator_malloc(sizeof(worker_thread) * (worker_count - 1));
+
+    if (!p_pool->threads)
+    {
+        allocator_free(p_pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&p_pool->mutex, NULL);
+    pthread_cond_init(&p_pool->task_posted, NULL);
+    pthread_cond_init(&p_pool->task_finished, NULL);
+
+    for (i = 0; i < worker_count - 1; ++i)
+    {
+        p_pool->threads[i].p_pool = p_pool;
+        p_pool->threads[i].worker_index = i + 1;
+
+        if (pthread_create(&p_pool->threads[i].thread,
+                           NULL,
+                           run_worker,
+                           &p_pool->threads[i]) != 0)
+        {
+            break;
+        }
+    }
+
+    /* No task has been posted yet, so the threads do not read the count: */
+    p_pool->worker_count = i + 1;
+#else
+    (void) worker_count;
+#endif
+    return p_pool;
+}
+
+size_t worker_pool_size(worker_pool* p_pool)
+{
+    return p_pool->worker_count;
+}
+
+void worker_pool_run(worker_pool* p_pool,
+                     worker_pool_task task,
+                     void* p_argument)
+{
+    if (p_pool->worker_count == 1)
+    {
+        task(p_argument, 0, 1);
+        return;
+    }
+
+#ifdef WORKER_POOL_PTHREADS
+    pthread_mutex_lock(&p_pool->mutex);
+    p_pool->task = task;
+    p_pool->p_argument = p_argument;
+    p_pool->busy_count = p_pool->worker_count - 1;
+    p_pool->task_number++;
+    pthread_cond_broadcast(&p_pool->task_posted);
+    pthread_mutex_unlock(&p_pool->mutex);
+
+    task(p_argument, 0, p_pool->worker_count);
+
+    pthread_mutex_lock(&p_pool->mutex);
+
+    while (p_pool->busy_count > 0)
+    {
+        pthread_cond_wait(&p_pool->task_finished, &p_pool->mutex);
+    }
+
+    pthread_mutex_unlock(&p_pool->mutex);
+#endif
+}
+
+void worker_pool_free(worker_pool* p_pool)
+{
+    if (!p_pool)
+    {
+        return;
+    }
+
+#ifdef WORKER_POOL_PTHREADS
+    if (p_pool->threads)
+    {
+        stop_threads(p_pool, p_pool->worker_count - 1);
+        pthread_mutex_destroy(&p_pool->mutex);
+        pthread_cond_destroy(&p_pool->task_posted);
+        pthread_cond_destroy(&p_pool->task_finished);
+        allocator_free(p_pool->threads);
+    }
+#endif
+    allocator_free(p_pool);
+}
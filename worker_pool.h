@@ -0,0 +1,41 @@
+#ifndef COM_GITHUB_CODERODDE_BIDIR_SEARCH_WORKER_POOL_H
+#define COM_GITHUB_CODERODDE_BIDIR_SEARCH_WORKER_POOL_H
+
+#include <stdlib.h>
+
+/*******************************************************************************
+* A fixed set of worker threads that run one task at a time, fork-join style:  *
+* 'worker_pool_run' hands the task to every worker, runs it on the calling     *
+* thread as worker 0 as well, and returns once all the workers are done. The   *
+* threads sleep between tasks, so a pool may be kept around and reused. On     *
+* systems without POSIX threads, a pool has the calling thread as its only     *
+* worker. The structure is private to worker_pool.c.                           *
+*******************************************************************************/
+typedef struct worker_pool worker_pool;
+
+/*******************************************************************************
+* A task receives the argument passed to 'worker_pool_run', the index of the   *
+* worker running it and the number of workers, and typically processes the     *
+* 'worker_index'-th share of some work.                                        *
+*******************************************************************************/
+typedef void (*worker_pool_task)(void* p_argument,
+                                 size_t worker_index,
+                                 size_t worker_count);
+
+/*******************************************************************************
+* Allocates a pool of 'worker_count' workers, the calling thread included. A   *
+* count of zero asks for one worker per online processor. If the system runs   *
+* out of threads, the pool makes do with the ones it got. Returns NULL if out  *
+* of memory.                                                                   *
+*******************************************************************************/
+worker_pool* worker_pool_alloc(size_t worker_count);
+
+size_t worker_pool_size(worker_pool* p_pool);
+
+void worker_pool_run(worker_pool* p_pool,
+                     worker_pool_task task,
+                     void* p_argument);
+
+void worker_pool_free(worker_pool* p_pool);
+
+#endif /* COM_GITHUB_CODERODDE_BIDIR_SEARCH_WORKER_POOL_H */